@@ -38,20 +38,22 @@ static void usage_message( char * prog_name )
 
 static void print_stats( void )
 {
-  Statistics degree_info = init_statistics( number_of_nodes );
-  Statistics layer_info = init_statistics( number_of_layers );
-  for( int layer = 0; layer < number_of_layers; layer++ )
+  Statistics degree_info = init_statistics( CTX(number_of_nodes) );
+  Statistics layer_info = init_statistics( CTX(number_of_layers) );
+  for( int layer = 0; layer < CTX(number_of_layers); layer++ )
     {
-      add_data( layer_info, layers[ layer ]->number_of_nodes );
-      for( int position = 0; position < layers[ layer ]->number_of_nodes; position++ )
+      add_data( layer_info, CTX(layers)[ layer ]->node_count );
+      for( int position = 0;
+           position < CTX(layers)[ layer ]->node_count; position++ )
         {
-          Nodeptr node = layers[ layer ]->nodes[ position ];
+          Nodeptr node = CTX(layers)[ layer ]->nodes[ position ];
           add_data( degree_info, DEGREE( node ) );
         }
     }
-  printf( "NumberOfNodes,%d\n", number_of_nodes );
-  printf( "NumberOfEdges,%d\n", number_of_edges );
-  printf( "EdgeDensity,%2.2f\n", ((double) number_of_edges) / number_of_nodes );
+  printf( "NumberOfNodes,%d\n", CTX(number_of_nodes) );
+  printf( "NumberOfEdges,%d\n", CTX(number_of_edges) );
+  printf( "EdgeDensity,%2.2f\n",
+          ((double) CTX(number_of_edges)) / CTX(number_of_nodes) );
   printf( "DegreeStats\t" );
   print_statistics( degree_info, stdout, "%2.1f" );
   printf( "\n" );
@@ -62,6 +64,36 @@ static void print_stats( void )
   free_statistics( degree_info );
 }
 
+/**
+ * @return a copy of the list in malloc'ed memory, with room for at least
+ * length items and a multiple of CAPACITY_INCREMENT, as add_edge() expects
+ */
+static Edgeptr * growable_copy( Edgeptr * list, int length )
+{
+  int capacity
+    = ( length / CAPACITY_INCREMENT + 1 ) * CAPACITY_INCREMENT;
+  Edgeptr * copy = (Edgeptr *) malloc( capacity * sizeof(Edgeptr) );
+  memcpy( copy, list, length * sizeof(Edgeptr) );
+  return copy;
+}
+
+/**
+ * The master edge list and the adjacency lists of a graph read by
+ * readGraph() are in its arena - see freeGraph(); add_edge() reallocates
+ * them, so they are replaced with copies that can grow
+ */
+static void make_edge_lists_growable( void )
+{
+  CTX(master_edge_list)
+    = growable_copy( CTX(master_edge_list), CTX(number_of_edges) );
+  for ( int i = 0; i < CTX(number_of_nodes); i++ )
+    {
+      Nodeptr node = CTX(master_node_list)[i];
+      node->up_edges = growable_copy( node->up_edges, node->up_degree );
+      node->down_edges = growable_copy( node->down_edges, node->down_degree );
+    }
+}
+
 /**
  * Adds an edge between two nodes whose layers are determined and adjacent to
  * one another
@@ -70,23 +102,24 @@ static void add_edge( Nodeptr upper_node, Nodeptr lower_node )
 {
 #ifdef DEBUG
   printf( "-> add_edge: upper_node = (%s,%d,%d), lower_node = (%s,%d,%d)\n",
-          upper_node->name, upper_node->layer, upper_node->position,
-          lower_node->name, lower_node->layer, lower_node->position );
+          NODE_NAME( upper_node ), upper_node->layer, upper_node->position,
+          NODE_NAME( lower_node ), lower_node->layer, lower_node->position );
 #endif
   assert( upper_node->layer == lower_node->layer + 1 );
   Edgeptr new_edge = (Edgeptr) calloc( 1, sizeof(struct edge_struct) );
   new_edge->up_node = upper_node;
   new_edge->down_node = lower_node;
-  new_edge->fixed = false;
+  new_edge->id = CTX(number_of_edges);
 
   // add new edge to master edge list, making room if necessary
-  if ( number_of_edges % CAPACITY_INCREMENT == 0 )
+  if ( CTX(number_of_edges) % CAPACITY_INCREMENT == 0 )
     {
-      master_edge_list
-        = (Edgeptr *) realloc( master_edge_list,
-                               (number_of_edges + CAPACITY_INCREMENT) * sizeof(Edgeptr) );
+      CTX(master_edge_list)
+        = (Edgeptr *) realloc( CTX(master_edge_list),
+                               (CTX(number_of_edges) + CAPACITY_INCREMENT)
+                               * sizeof(Edgeptr) );
     }
-  master_edge_list[ number_of_edges++ ] = new_edge;
+  CTX(master_edge_list)[ CTX(number_of_edges)++ ] = new_edge;
 
   // add new edge to lower edge list of upper node, making room if necessary
   if ( upper_node->down_degree % CAPACITY_INCREMENT == 0 )
@@ -107,7 +140,7 @@ static void add_edge( Nodeptr upper_node, Nodeptr lower_node )
 
 #ifdef DEBUG
   printf( "<- add_edge: edge = %s -> %s\n",
-          new_edge->up_node->name, new_edge->down_node->name );
+          NODE_NAME( new_edge->up_node ), NODE_NAME( new_edge->down_node ) );
 #endif
 }
 
@@ -117,9 +150,9 @@ static void add_edge( Nodeptr upper_node, Nodeptr lower_node )
  */
 static void make_all_current_edges_exist( void )
 {
-  for ( int i = 0; i < number_of_edges; i++ )
+  for ( int i = 0; i < CTX(number_of_edges); i++ )
     {
-      Edgeptr edge = master_edge_list[i];
+      Edgeptr edge = CTX(master_edge_list)[i];
       int up_node_id = edge->up_node->id;
       int down_node_id = edge->down_node->id;
       pair_already_exists( up_node_id, down_node_id );
@@ -131,39 +164,39 @@ static void add_edges( int desired_num_edges )
 #ifdef DEBUG
   printf( "-> add_edges: number_of_nodes = %d, current_number_of_edges = %d,"
           " desired_number_of_edges = %d\n",
-          number_of_nodes, number_of_edges, desired_num_edges );
+          CTX(number_of_nodes), CTX(number_of_edges), desired_num_edges );
 #endif
 
   assert(
-         number_of_nodes > 1
-         && number_of_layers > 1
+         CTX(number_of_nodes) > 1
+         && CTX(number_of_layers) > 1
          );
 
   create_hash_table_for_pairs( desired_num_edges );
 
   make_all_current_edges_exist();
 
-  while ( desired_num_edges > number_of_edges )
+  while ( desired_num_edges > CTX(number_of_edges) )
     {
       // pick two random nodes that are on adjacent layers
       // if there's not already an edge between them, add one
 
       // pick a node that's not on layer 0
-      int first_node_index = random() % number_of_nodes;
-      Nodeptr first_node = master_node_list[ first_node_index ];
+      int first_node_index = random() % CTX(number_of_nodes);
+      Nodeptr first_node = CTX(master_node_list)[ first_node_index ];
       int first_node_layer_number = first_node->layer;
 #ifdef DEBUG
       printf( " Loop iteration: number_of_edges = %d, desired = %d\n"
               "   first_node = %d [%d]\n",
-              number_of_edges, desired_num_edges,
+              CTX(number_of_edges), desired_num_edges,
               first_node_index, first_node_layer_number );
 #endif
       if ( first_node_layer_number == 0 ) continue;
 
       // pick another node on the layer below that of the first node
       int second_node_layer_number = first_node_layer_number - 1;
-      Layerptr second_node_layer = layers[ second_node_layer_number ];
-      int second_node_layer_position = random() % second_node_layer->number_of_nodes;
+      Layerptr second_node_layer = CTX(layers)[ second_node_layer_number ];
+      int second_node_layer_position = random() % second_node_layer->node_count;
       Nodeptr second_node = second_node_layer->nodes[ second_node_layer_position ];
       int second_node_index = second_node->id;
 
@@ -191,7 +224,7 @@ int main( int argc, char * argv[] )
     }
 
   const char * input_base_name = argv[1];
-  const char * output_base_name = argv[2];
+  const char * output_base = argv[2];
   int edges = atoi( argv[3] );
   long seed = atoi( argv[4] );
 
@@ -205,13 +238,14 @@ int main( int argc, char * argv[] )
   strcpy( ord_name_buffer, input_base_name );
   strcat( ord_name_buffer, ".ord" );
   readGraph( dot_name_buffer, ord_name_buffer );
-  int original_num_edges = number_of_edges;
+  make_edge_lists_growable();
+  int original_num_edges = CTX(number_of_edges);
 
   // check whether the desired number of edges is reasonable
   // choice of maximum density is arbitrary, based on the number obtained if
   // all edges between two adjacent layers were present; the division by 4
   // prevents the program from spending too long to avoid duplicate edges
-  double max_edges = (double) number_of_nodes * number_of_nodes / 4;
+  double max_edges = (double) CTX(number_of_nodes) * CTX(number_of_nodes) / 4;
   if ( edges > max_edges )
     {
       printf( "Desired graph is too dense to be constructed, desired edges = %d, max edges = %2.0f\n",
@@ -224,25 +258,25 @@ int main( int argc, char * argv[] )
 
   print_stats();
 
-  strcpy( graph_name, output_base_name );
+  strcpy( CTX(graph_name), output_base );
 
-  strcpy( dot_name_buffer, output_base_name );
-  strcpy( ord_name_buffer, output_base_name );
+  strcpy( dot_name_buffer, output_base );
+  strcpy( ord_name_buffer, output_base );
   strcat( dot_name_buffer, ".dot" );
   strcat( ord_name_buffer, ".ord" );
   char header_info_buffer[MAX_NAME_LENGTH];
   sprintf( header_info_buffer,
            " random dag, created by: add_edges %s %s %d %d %d %ld\n",
-           input_base_name, output_base_name,
-           number_of_nodes, original_num_edges, number_of_edges, seed
+           input_base_name, output_base,
+           CTX(number_of_nodes), original_num_edges, CTX(number_of_edges), seed
            );
 
   writeDot(
            dot_name_buffer,
-           graph_name,
+           CTX(graph_name),
            header_info_buffer,
-           master_edge_list,
-           number_of_edges
+           CTX(master_edge_list),
+           CTX(number_of_edges)
            );
   
   writeOrd( ord_name_buffer );
@@ -250,4 +284,4 @@ int main( int argc, char * argv[] )
   return EXIT_SUCCESS;
 }
 
-/*  [Last modified: 2011 07 07 at 16:57:39 GMT] */
+/*  [Last modified: 2026 10 16 at 16:03:56 GMT] */
@@ -0,0 +1,140 @@
+/**
+ * @file arena.c
+ * @brief Implementation of a bump allocator with bulk release.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+#include"arena.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<stdint.h>
+
+/**
+ * Every allocation is aligned to a multiple of the size of this union
+ */
+typedef union {
+  long double long_double_member;
+  long long long_long_member;
+  void * pointer_member;
+  void (* function_member)( void );
+} max_align_union;
+
+#define ALIGNMENT sizeof( max_align_union )
+
+/**
+ * Blocks never grow beyond this size, except to accommodate a single large
+ * allocation
+ */
+#define MAX_BLOCK_SIZE ( (size_t) 1 << 24 )
+
+typedef struct arena_block_struct {
+  struct arena_block_struct * next;
+  size_t size;
+  size_t used;
+  /**
+   * the memory of the block; as an array of max_align_union it is aligned
+   * for any type
+   */
+  max_align_union memory[];
+} * ArenaBlockptr;
+
+struct arena_struct {
+  /**
+   * the block currently being allocated from; it is the first in the list
+   * of all blocks
+   */
+  ArenaBlockptr current;
+  size_t next_block_size;
+};
+
+static ArenaBlockptr new_block( size_t size, ArenaBlockptr next )
+{
+  ArenaBlockptr block
+    = (ArenaBlockptr) malloc( sizeof(struct arena_block_struct) + size );
+  if ( block == NULL )
+    {
+      fprintf( stderr, "FATAL: arena, unable to allocate %zu bytes\n", size );
+      abort();
+    }
+  block->next = next;
+  block->size = size;
+  block->used = 0;
+  return block;
+}
+
+Arenaptr arena_create( size_t initial_block_size )
+{
+  Arenaptr arena = (Arenaptr) malloc( sizeof(struct arena_struct) );
+  if ( initial_block_size < ALIGNMENT ) initial_block_size = ALIGNMENT;
+  arena->current = NULL;
+  arena->next_block_size = initial_block_size;
+  return arena;
+}
+
+void * arena_alloc( Arenaptr arena, size_t size )
+{
+  // round up so that the next allocation is also aligned
+  size = ( size + ALIGNMENT - 1 ) / ALIGNMENT * ALIGNMENT;
+  ArenaBlockptr block = arena->current;
+  if ( block == NULL || block->size - block->used < size )
+    {
+      if ( block != NULL && size > arena->next_block_size / 4 )
+        {
+          // a large allocation gets a block of its own, behind the current
+          // one, so that the space left in the current block is not wasted
+          block->next = new_block( size, block->next );
+          block->next->used = size;
+          return block->next->memory;
+        }
+      size_t block_size = arena->next_block_size;
+      if ( block_size < size ) block_size = size;
+      if ( arena->next_block_size < MAX_BLOCK_SIZE )
+        arena->next_block_size *= 2;
+      block = arena->current = new_block( block_size, block );
+    }
+  void * result = (char *) block->memory + block->used;
+  block->used += size;
+  return result;
+}
+
+void * arena_calloc( Arenaptr arena, size_t count, size_t size )
+{
+  void * result = arena_alloc( arena, count * size );
+  memset( result, 0, count * size );
+  return result;
+}
+
+char * arena_strdup( Arenaptr arena, const char * string )
+{
+  size_t length = strlen( string ) + 1;
+  char * copy = (char *) arena_alloc( arena, length );
+  memcpy( copy, string, length );
+  return copy;
+}
+
+char * arena_strndup( Arenaptr arena, const char * string, size_t length )
+{
+  char * copy = (char *) arena_alloc( arena, length + 1 );
+  memcpy( copy, string, length );
+  copy[ length ] = '\0';
+  return copy;
+}
+
+void arena_free( Arenaptr arena )
+{
+  if ( arena == NULL ) return;
+  ArenaBlockptr block = arena->current;
+  while ( block != NULL )
+    {
+      ArenaBlockptr next = block->next;
+      free( block );
+      block = next;
+    }
+  free( arena );
+}
+
+/*  [Last modified: 2026 10 16 at 16:18:05 GMT] */
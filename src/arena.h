@@ -0,0 +1,54 @@
+/**
+ * @file arena.h
+ * @brief A bump allocator: memory is handed out sequentially from large
+ * blocks and can only be released all at once. Used for the graph read by
+ * readGraph(), which consists of many small records that live as long as
+ * the graph does.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+#include<stddef.h>
+
+#ifndef ARENA_H
+#define ARENA_H
+
+typedef struct arena_struct * Arenaptr;
+
+/**
+ * @return a new, empty arena; the first block has (at least) the given
+ * size in bytes and later blocks are successively larger
+ */
+Arenaptr arena_create( size_t initial_block_size );
+
+/**
+ * @return a pointer to size bytes of uninitialized memory, aligned for
+ * any type; the memory remains valid until arena_free() is called
+ */
+void * arena_alloc( Arenaptr arena, size_t size );
+
+/**
+ * @return a pointer to count * size bytes set to 0
+ */
+void * arena_calloc( Arenaptr arena, size_t count, size_t size );
+
+/**
+ * @return a copy of the string, allocated in the arena
+ */
+char * arena_strdup( Arenaptr arena, const char * string );
+
+/**
+ * @return a copy of string[0], ..., string[length - 1], terminated by '\0'
+ * and allocated in the arena
+ */
+char * arena_strndup( Arenaptr arena, const char * string, size_t length );
+
+/**
+ * Releases all memory allocated in the arena, and the arena itself
+ */
+void arena_free( Arenaptr arena );
+
+#endif
+
+/*  [Last modified: 2026 10 16 at 16:18:05 GMT] */
@@ -14,6 +14,7 @@
 #include"min_crossings.h"
 #include"barycenter.h"
 #include"graph.h"
+#include"graph_core.h"
 #include"sorting.h"
 #include"crossings.h"
 #include"graph_io.h"
@@ -28,30 +29,34 @@
  */
 static void node_weight( Nodeptr node, Orientation orientation )
 {
+  const int32_t * position = CTX(graph_core)->position;
+  int32_t v = node->id;
   int total_degree = 0;
   int total_of_positions = 0;
-  int adj_index;
+  int32_t adj_index;
   if( orientation != UPWARD )
     {
       total_degree += node->down_degree;
-      for( adj_index = 0; adj_index < node->down_degree; adj_index++ )
+      for( adj_index = CTX(graph_core)->down_start[v];
+           adj_index < CTX(graph_core)->down_start[v + 1]; adj_index++ )
         {
           total_of_positions
-            += node->down_edges[adj_index]->down_node->position;
+            += position[ CTX(graph_core)->down_neighbor[adj_index] ];
         }
     }
   if( orientation != DOWNWARD )
     {
       total_degree += node->up_degree;
-      for( adj_index = 0; adj_index < node->up_degree; adj_index++ )
+      for( adj_index = CTX(graph_core)->up_start[v];
+           adj_index < CTX(graph_core)->up_start[v + 1]; adj_index++ )
         {
           total_of_positions
-            += node->up_edges[adj_index]->up_node->position;
+            += position[ CTX(graph_core)->up_neighbor[adj_index] ];
         }
     }
   if( total_degree > 0 )
     node->weight = (double) total_of_positions / total_degree;
-  else if( adjust_weights == NONE
+  else if( OPTION(adjust_weights) == NONE
            // put isolated nodes to the far left
            || node->up_degree + node->down_degree == 0 ) node->weight = 0;
   else
@@ -73,16 +78,19 @@ static void balanced_node_weight( Nodeptr node ) {
 #ifdef DEBUG
   printf( "-> balanced_node_weight, node = %d\n", node->id );
 #endif
-  int adj_index;
+  const int32_t * position = CTX(graph_core)->position;
+  int32_t v = node->id;
+  int32_t adj_index;
   int degree;
   int total_of_positions;
 
   // compute average position in the downward direction
   total_of_positions = 0;
   degree = node->down_degree;
-  for( adj_index = 0; adj_index < degree; adj_index++ ) {
+  for( adj_index = CTX(graph_core)->down_start[v];
+       adj_index < CTX(graph_core)->down_start[v + 1]; adj_index++ ) {
       total_of_positions
-        += node->down_edges[adj_index]->down_node->position;
+        += position[ CTX(graph_core)->down_neighbor[adj_index] ];
   }
   double downward_average;
   if ( degree > 0 ) downward_average = (double) total_of_positions / degree;
@@ -91,9 +99,10 @@ static void balanced_node_weight( Nodeptr node ) {
   // compute average position in the upward direction
   total_of_positions = 0;
   degree = node->up_degree;
-  for( adj_index = 0; adj_index < degree; adj_index++ ) {
+  for( adj_index = CTX(graph_core)->up_start[v];
+       adj_index < CTX(graph_core)->up_start[v + 1]; adj_index++ ) {
       total_of_positions
-        += node->up_edges[adj_index]->up_node->position;
+        += position[ CTX(graph_core)->up_neighbor[adj_index] ];
   }
   double upward_average;
   if ( degree > 0 ) upward_average = (double) total_of_positions / degree;
@@ -120,9 +129,9 @@ static void balanced_node_weight( Nodeptr node ) {
  */
 static void adjust_weights_left( int layer )
 {
-  Layerptr layerptr = layers[ layer ];
+  Layerptr layerptr = CTX(layers)[ layer ];
   int i = 0;
-  for( ; i < layerptr->number_of_nodes; i++ )
+  for( ; i < layerptr->node_count; i++ )
     {
       Nodeptr node = layerptr->nodes[i];
       if( node->weight == -1 )
@@ -131,7 +140,7 @@ static void adjust_weights_left( int layer )
           else node->weight = layerptr->nodes[i-1]->weight;
 #ifdef DEBUG
           printf("  adjust_weight (left), node = %s, weight = %f\n",
-                 node->name, node->weight );
+                 NODE_NAME( node ), node->weight );
 #endif  
         }
     }
@@ -144,14 +153,14 @@ static void adjust_weights_left( int layer )
  * the neighbors if the other is absent or also has weight -1.
  */
 static void adjust_weights_avg( int layer ) {
-  Layerptr layerptr = layers[ layer ];
-  int num_nodes = layerptr->number_of_nodes;
+  Layerptr layerptr = CTX(layers)[ layer ];
+  int num_nodes = layerptr->node_count;
   // this method of adjusting weights is used in parallel barycenter
   // versions, so it is important that the adjusted weight of a node is not
   // influenced by the already adjusted weight of its left neighbor;
   // temp_weights holds the unadjusted weights
-  double * temp_weights;
-  bool parallel = (number_of_processors != 1);
+  double * temp_weights = NULL;
+  bool parallel = (OPTION(number_of_processors) != 1);
   if ( parallel ) {
     temp_weights = (double *) calloc( num_nodes, sizeof(double) );
     for ( int i = 0; i < num_nodes; i++ ) {
@@ -192,7 +201,7 @@ static void adjust_weights_avg( int layer ) {
     }
 #ifdef DEBUG
     printf("  adjust_weight (avg), node = %s, weight = %f\n",
-           node->name, node->weight );
+           NODE_NAME( node ), node->weight );
 #endif  
   } // for nodes on this layer
   if ( parallel )
@@ -208,28 +217,31 @@ void barycenterWeights( int layer, Orientation orientation )
 #ifdef DEBUG
   printf("-> barycenterWeights, layer = %d, orientation = %d"
          ", balanced_weight = %d\n",
-         layer, orientation, balanced_weight );
+         layer, orientation, OPTION(balanced_weight) );
 #endif  
-  Layerptr layerptr = layers[ layer ];
+  // the weights depend on the positions of the neighboring layers in
+  // graph_core
+  if ( layer > 0 ) refreshLayerPositions( layer - 1 );
+  if ( layer < CTX(number_of_layers) - 1 ) refreshLayerPositions( layer + 1 );
+  Layerptr layerptr = CTX(layers)[ layer ];
   int i = 0;
-  int num_nodes = layerptr->number_of_nodes;
+  int num_nodes = layerptr->node_count;
 /*
 #ifdef _OPENMP
 #pragma omp parallel for default(none) private(i) \
-  shared(num_nodes, orientation, balanced_weight, \
-  layerptr, trace_freq, number_of_processors)
+  shared(num_nodes, orientation, layerptr) copyin(current_context)
 #endif
 */
   for(i = 0 ; i < num_nodes; i++ )
     {
-      if ( orientation == BOTH && balanced_weight )
+      if ( orientation == BOTH && OPTION(balanced_weight) )
         balanced_node_weight( layerptr->nodes[i] );
       else
         node_weight( layerptr->nodes[i], orientation );
     }
-  if( adjust_weights == LEFT )
+  if( OPTION(adjust_weights) == LEFT )
     adjust_weights_left( layer );
-  else if( adjust_weights == AVG )
+  else if( OPTION(adjust_weights) == AVG )
     adjust_weights_avg( layer );
 #ifdef DEBUG
   printf( "<- barycenterWeights\n" );
@@ -239,7 +251,7 @@ void barycenterWeights( int layer, Orientation orientation )
 bool barycenterUpSweep( int starting_layer )
 {
   int layer = starting_layer;
-  for( ; layer < number_of_layers; layer++ )
+  for( ; layer < CTX(number_of_layers); layer++ )
     {
       barycenterWeights( layer, DOWNWARD );
       layerSort( layer );
@@ -274,4 +286,4 @@ bool barycenterDownSweep( int starting_layer )
   return false;
 }
 
-/*  [Last modified: 2014 09 09 at 15:52:37 GMT] */
+/*  [Last modified: 2026 10 16 at 16:03:56 GMT] */
@@ -0,0 +1,710 @@
+/**
+ * @file batch.c
+ * @brief Batch mode: runs of many configurations on many instances on a
+ * pool of worker threads - see batch.h
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+// pthreads, getline() and strdup() are POSIX, not C99
+#define _POSIX_C_SOURCE 200809L
+
+#include"batch.h"
+#include"defs.h"
+#include"graph.h"
+#include"graph_io.h"
+#include"min_crossings.h"
+#include"heuristics.h"
+#include"crossings.h"
+#include"crossing_utilities.h"
+#include"sorting.h"
+#include"channel.h"
+#include"order.h"
+#include"priority_edges.h"
+#include"stats.h"
+#include"timing.h"
+#include"random.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<ctype.h>
+#include<unistd.h>
+#include<pthread.h>
+
+#ifdef _OPENMP
+#include<omp.h>
+#endif
+
+typedef struct batch_instance {
+  /** the words of the manifest line */
+  char ** words;
+  int word_count;
+  /** dot, sgf or snapshot file, as given in the manifest */
+  char * file_name;
+  /** NULL unless the instance is given by a dot and an ord file */
+  char * ord_file_name;
+  enum graph_format_enum format;
+  /**
+   * context that holds the graph as read; created by the first run that
+   * needs it and deallocated by the last one, i.e., when runs_left drops to
+   * 0; protected by lock
+   */
+  RunContextptr context;
+  int runs_left;
+  double load_seconds;
+  pthread_mutex_t lock;
+} * BatchInstanceptr;
+
+typedef struct batch_configuration {
+  /** the words of the manifest line */
+  char ** words;
+  int word_count;
+  /** name followed by the options, as in the manifest */
+  char ** arguments;
+  /** context whose options are those of the configuration; no graph */
+  RunContextptr context;
+} * BatchConfigurationptr;
+
+/**
+ * A run of one configuration on one instance and its results
+ */
+typedef struct batch_run {
+  BatchInstanceptr instance;
+  BatchConfigurationptr configuration;
+  bool done;
+  /** "ok", "bad_preprocessor" or "bad_heuristic" */
+  const char * status;
+  char name_of_graph[MAX_NAME_LENGTH];
+  int node_count;
+  int edge_count;
+  int layer_count;
+  const char * preprocessor_name;
+  const char * heuristic_name;
+  int iterations;
+  int post_iterations;
+  CROSSING_STATS_INT crossing_stats;
+  CROSSING_STATS_INT bottleneck_stats;
+  CROSSING_STATS_DOUBLE stretch_stats;
+  CROSSING_STATS_DOUBLE bottleneck_stretch_stats;
+  double run_seconds;
+} * BatchRunptr;
+
+/**
+ * The batch being carried out; runs are handed out to the workers in
+ * order, instance after instance. Everything below is set up before the
+ * workers start; the fields after batch_lock are protected by it.
+ */
+static const char * manifest_name;
+static char * results_file_name = NULL;
+static bool json_results = false;
+static FILE * results_stream = NULL;
+static int worker_count = 0;
+static BatchInstanceptr * instances = NULL;
+static int instance_count = 0;
+static int instance_capacity = 0;
+static BatchConfigurationptr * configurations = NULL;
+static int configuration_count = 0;
+static int configuration_capacity = 0;
+static struct batch_run * runs = NULL;
+static int run_count = 0;
+
+static pthread_mutex_t batch_lock = PTHREAD_MUTEX_INITIALIZER;
+static int next_run = 0;
+static int next_row = 0;
+
+// --------------- The manifest
+
+/**
+ * Reports an error in the given line of the manifest and exits
+ */
+static void manifestError( int line_number, const char * message,
+                           const char * detail )
+{
+  fprintf( stderr, "Fatal error: %s, line %d: %s%s\n",
+           manifest_name, line_number, message, detail );
+  exit( EXIT_FAILURE );
+}
+
+/**
+ * @return the array, reallocated with twice the capacity (or
+ * CAPACITY_INCREMENT elements if it is empty); capacity is updated
+ */
+static void * grow_array( void * array, int * capacity, size_t element_size )
+{
+  int new_capacity
+    = ( * capacity == 0 ) ? CAPACITY_INCREMENT : 2 * ( * capacity );
+  array = realloc( array, (size_t) new_capacity * element_size );
+  if ( array == NULL )
+    {
+      fprintf( stderr, "FATAL: unable to allocate %d elements of size %zu\n",
+               new_capacity, element_size );
+      abort();
+    }
+  * capacity = new_capacity;
+  return array;
+}
+
+/**
+ * Splits the line into words separated by white space; the words are
+ * copies
+ * @return the number of words; *words is an array that the caller frees
+ */
+static int splitLine( const char * line, char *** words )
+{
+  int count = 0;
+  int capacity = 0;
+  * words = NULL;
+  for ( ; ; )
+    {
+      while ( isspace( (unsigned char) * line ) ) line++;
+      if ( * line == '\0' ) break;
+      const char * start = line;
+      while ( * line != '\0' && ! isspace( (unsigned char) * line ) ) line++;
+      if ( count == capacity )
+        * words = (char **) grow_array( * words, & capacity, sizeof(char *) );
+      ( * words )[ count++ ] = strndup( start, line - start );
+    }
+  return count;
+}
+
+static bool hasExtension( const char * file_name, const char * extension )
+{
+  const char * period = strrchr( file_name, '.' );
+  return period != NULL && strcmp( period, extension ) == 0;
+}
+
+static void checkInputFile( int line_number, const char * file_name )
+{
+  if ( access( file_name, R_OK ) != 0 )
+    manifestError( line_number, "unable to read ", file_name );
+}
+
+static void addInstance( int line_number, int word_count, char ** words )
+{
+  if ( word_count != 2 && word_count != 3 )
+    manifestError( line_number, "instance needs one or two file names", "" );
+  BatchInstanceptr instance
+    = (BatchInstanceptr) calloc( 1, sizeof(struct batch_instance) );
+  instance->words = words;
+  instance->word_count = word_count;
+  instance->file_name = words[1];
+  checkInputFile( line_number, words[1] );
+  if ( word_count == 3 )
+    {
+      instance->ord_file_name = words[2];
+      checkInputFile( line_number, words[2] );
+      instance->format = DOT_AND_ORD;
+    }
+  else
+    instance->format = hasExtension( words[1], ".snap" ) ? SNAPSHOT : SGF;
+  pthread_mutex_init( & instance->lock, NULL );
+  if ( instance_count == instance_capacity )
+    instances = (BatchInstanceptr *)
+      grow_array( instances, & instance_capacity, sizeof(BatchInstanceptr) );
+  instances[ instance_count++ ] = instance;
+}
+
+/**
+ * The options of the configuration are parsed right away, in a context of
+ * its own, so that errors show up before any run starts
+ */
+static void addConfiguration( int line_number, int word_count, char ** words,
+                              ConfigurationParser parse_configuration )
+{
+  if ( word_count < 2 )
+    manifestError( line_number, "config needs a name", "" );
+  BatchConfigurationptr configuration = (BatchConfigurationptr)
+    calloc( 1, sizeof(struct batch_configuration) );
+  // the options refer to the words, so they are kept
+  configuration->words = words;
+  configuration->word_count = word_count;
+  configuration->arguments = words + 1;
+  configuration->context = newRunContext();
+  setRunContext( configuration->context );
+  // getopt() may permute the arguments; the configuration keeps its own
+  // array of them
+  char ** arguments = (char **) malloc( word_count * sizeof(char *) );
+  memcpy( arguments, words + 1, ( word_count - 1 ) * sizeof(char *) );
+  arguments[ word_count - 1 ] = NULL;
+  parse_configuration( word_count - 1, arguments );
+  free( arguments );
+  OPTION(thread_clock) = true;
+  setRunContext( NULL );
+  if ( configuration_count == configuration_capacity )
+    configurations = (BatchConfigurationptr *)
+      grow_array( configurations, & configuration_capacity,
+                  sizeof(BatchConfigurationptr) );
+  configurations[ configuration_count++ ] = configuration;
+}
+
+static void freeWords( char ** words, int word_count )
+{
+  for ( int i = 0; i < word_count; i++ ) free( words[i] );
+  free( words );
+}
+
+static void readManifest( ConfigurationParser parse_configuration )
+{
+  FILE * manifest = fopen( manifest_name, "r" );
+  if ( manifest == NULL )
+    {
+      fprintf( stderr, "Unable to open file %s for input\n", manifest_name );
+      exit( EXIT_FAILURE );
+    }
+  char * line = NULL;
+  size_t line_capacity = 0;
+  int line_number = 0;
+  while ( getline( & line, & line_capacity, manifest ) != -1 )
+    {
+      line_number++;
+      char ** words;
+      int word_count = splitLine( line, & words );
+      if ( word_count == 0 || words[0][0] == '#' )
+        {
+          freeWords( words, word_count );
+          continue;
+        }
+      // the words of instances and configurations are kept
+      if ( strcmp( words[0], "instance" ) == 0 )
+        addInstance( line_number, word_count, words );
+      else if ( strcmp( words[0], "config" ) == 0 )
+        addConfiguration( line_number, word_count, words,
+                          parse_configuration );
+      else if ( strcmp( words[0], "results" ) == 0 && word_count == 2 )
+        {
+          free( results_file_name );
+          results_file_name = strdup( words[1] );
+          freeWords( words, word_count );
+        }
+      else if ( strcmp( words[0], "workers" ) == 0 && word_count == 2 )
+        {
+          worker_count = atoi( words[1] );
+          if ( worker_count < 1 )
+            manifestError( line_number, "bad number of workers ", words[1] );
+          freeWords( words, word_count );
+        }
+      else
+        manifestError( line_number, "bad directive ", words[0] );
+    }
+  free( line );
+  fclose( manifest );
+  if ( results_file_name == NULL )
+    manifestError( line_number, "no results file", "" );
+  if ( instance_count == 0 || configuration_count == 0 )
+    manifestError( line_number, "no instances or no configurations", "" );
+}
+
+// --------------- The table of results
+
+enum column_type { TEXT, NUMBER };
+
+static const struct column {
+  const char * name;
+  enum column_type type;
+} columns[] = {
+  { "instance", TEXT }, { "config", TEXT }, { "status", TEXT },
+  { "graph", TEXT }, { "nodes", NUMBER }, { "edges", NUMBER },
+  { "layers", NUMBER }, { "preprocessor", TEXT }, { "heuristic", TEXT },
+  { "iterations", NUMBER }, { "post_iterations", NUMBER },
+  { "start_crossings", NUMBER }, { "crossings", NUMBER },
+  { "crossings_iteration", NUMBER },
+  { "start_bottleneck", NUMBER }, { "bottleneck", NUMBER },
+  { "bottleneck_iteration", NUMBER },
+  { "stretch", NUMBER }, { "stretch_iteration", NUMBER },
+  { "bottleneck_stretch", NUMBER },
+  { "bottleneck_stretch_iteration", NUMBER },
+  { "load_seconds", NUMBER }, { "runtime", NUMBER },
+};
+
+#define NUMBER_OF_COLUMNS ( (int) ( sizeof(columns) / sizeof(columns[0]) ) )
+
+/**
+ * Longest value of a column that is not a file or graph name
+ */
+#define MAX_VALUE_LENGTH 32
+
+/**
+ * Fills values[i] with the value of column i for the run, "" if there is
+ * none, i.e., if the run could not be done
+ */
+static void formatRow( BatchRunptr run, const char * values[],
+                       char numbers[][MAX_VALUE_LENGTH] )
+{
+  for ( int i = 0; i < NUMBER_OF_COLUMNS; i++ ) numbers[i][0] = '\0';
+  values[0] = run->instance->file_name;
+  values[1] = run->configuration->arguments[0];
+  values[2] = run->status;
+  values[3] = run->name_of_graph;
+  values[7] = run->preprocessor_name;
+  values[8] = run->heuristic_name;
+  snprintf( numbers[4], MAX_VALUE_LENGTH, "%d", run->node_count );
+  snprintf( numbers[5], MAX_VALUE_LENGTH, "%d", run->edge_count );
+  snprintf( numbers[6], MAX_VALUE_LENGTH, "%d", run->layer_count );
+  snprintf( numbers[21], MAX_VALUE_LENGTH, "%2.3f",
+            run->instance->load_seconds );
+  if ( strcmp( run->status, "ok" ) == 0 )
+    {
+      snprintf( numbers[9], MAX_VALUE_LENGTH, "%d", run->iterations );
+      snprintf( numbers[10], MAX_VALUE_LENGTH, "%d", run->post_iterations );
+      snprintf( numbers[11], MAX_VALUE_LENGTH, "%d",
+                run->crossing_stats.at_beginning );
+      snprintf( numbers[12], MAX_VALUE_LENGTH, "%d",
+                run->crossing_stats.after_post_processing );
+      snprintf( numbers[13], MAX_VALUE_LENGTH, "%d",
+                run->crossing_stats.best_heuristic_iteration );
+      snprintf( numbers[14], MAX_VALUE_LENGTH, "%d",
+                run->bottleneck_stats.at_beginning );
+      snprintf( numbers[15], MAX_VALUE_LENGTH, "%d",
+                run->bottleneck_stats.after_post_processing );
+      snprintf( numbers[16], MAX_VALUE_LENGTH, "%d",
+                run->bottleneck_stats.best_heuristic_iteration );
+      snprintf( numbers[17], MAX_VALUE_LENGTH, "%f",
+                run->stretch_stats.after_post_processing );
+      snprintf( numbers[18], MAX_VALUE_LENGTH, "%d",
+                run->stretch_stats.best_heuristic_iteration );
+      snprintf( numbers[19], MAX_VALUE_LENGTH, "%f",
+                run->bottleneck_stretch_stats.after_post_processing );
+      snprintf( numbers[20], MAX_VALUE_LENGTH, "%d",
+                run->bottleneck_stretch_stats.best_heuristic_iteration );
+      snprintf( numbers[22], MAX_VALUE_LENGTH, "%2.3f", run->run_seconds );
+    }
+  for ( int i = 0; i < NUMBER_OF_COLUMNS; i++ )
+    if ( columns[i].type == NUMBER ) values[i] = numbers[i];
+}
+
+/**
+ * Writes a value as a CSV field, in quotes if it contains a comma, a quote
+ * or a line break
+ */
+static void writeCsvField( const char * value )
+{
+  if ( strpbrk( value, ",\"\r\n" ) == NULL )
+    {
+      fputs( value, results_stream );
+      return;
+    }
+  putc( '"', results_stream );
+  for ( ; * value != '\0'; value++ )
+    {
+      if ( * value == '"' ) putc( '"', results_stream );
+      putc( * value, results_stream );
+    }
+  putc( '"', results_stream );
+}
+
+static void writeJsonString( const char * value )
+{
+  putc( '"', results_stream );
+  for ( ; * value != '\0'; value++ )
+    {
+      unsigned char ch = * value;
+      if ( ch == '"' || ch == '\\' )
+        fprintf( results_stream, "\\%c", ch );
+      else if ( ch < ' ' )
+        fprintf( results_stream, "\\u%04x", ch );
+      else
+        putc( ch, results_stream );
+    }
+  putc( '"', results_stream );
+}
+
+static void writeHeader( void )
+{
+  if ( json_results ) return;
+  for ( int i = 0; i < NUMBER_OF_COLUMNS; i++ )
+    {
+      if ( i > 0 ) putc( ',', results_stream );
+      fputs( columns[i].name, results_stream );
+    }
+  putc( '\n', results_stream );
+}
+
+static void writeRow( BatchRunptr run )
+{
+  const char * values[ NUMBER_OF_COLUMNS ];
+  char numbers[ NUMBER_OF_COLUMNS ][ MAX_VALUE_LENGTH ];
+  formatRow( run, values, numbers );
+  if ( json_results ) putc( '{', results_stream );
+  for ( int i = 0; i < NUMBER_OF_COLUMNS; i++ )
+    {
+      if ( i > 0 ) putc( ',', results_stream );
+      if ( ! json_results )
+        writeCsvField( values[i] );
+      else
+        {
+          fprintf( results_stream, "\"%s\":", columns[i].name );
+          if ( columns[i].type == TEXT )
+            writeJsonString( values[i] );
+          else
+            fputs( * values[i] == '\0' ? "null" : values[i], results_stream );
+        }
+    }
+  fputs( json_results ? "}\n" : "\n", results_stream );
+}
+
+/**
+ * Marks the run as done and writes the rows that are now ready
+ */
+static void finishRun( BatchRunptr run )
+{
+  pthread_mutex_lock( & batch_lock );
+  run->done = true;
+  bool written = false;
+  for ( ; next_row < run_count && runs[ next_row ].done; next_row++ )
+    {
+      writeRow( & runs[ next_row ] );
+      written = true;
+    }
+  if ( written ) fflush( results_stream );
+  pthread_mutex_unlock( & batch_lock );
+}
+
+// --------------- The runs
+
+/**
+ * Makes sure that the graph of the instance has been read
+ */
+static void acquireInstance( BatchInstanceptr instance )
+{
+  pthread_mutex_lock( & instance->lock );
+  if ( instance->context == NULL )
+    {
+      instance->context = newRunContext();
+      setRunContext( instance->context );
+      double load_start = getThreadUserSeconds();
+      if ( instance->format == SNAPSHOT )
+        readSnapshot( instance->file_name, NULL );
+      else if ( instance->format == SGF )
+        readSgf( instance->file_name );
+      else
+        readGraph( instance->file_name, instance->ord_file_name );
+      instance->load_seconds = getThreadUserSeconds() - load_start;
+      setRunContext( NULL );
+    }
+  pthread_mutex_unlock( & instance->lock );
+}
+
+/**
+ * Deallocates the graph of the instance after its last run
+ */
+static void releaseInstance( BatchInstanceptr instance )
+{
+  pthread_mutex_lock( & instance->lock );
+  bool last_run = --instance->runs_left == 0;
+  pthread_mutex_unlock( & instance->lock );
+  if ( ! last_run ) return;
+  setRunContext( instance->context );
+  freeGraph();
+  setRunContext( NULL );
+  freeRunContext( instance->context );
+  instance->context = NULL;
+}
+
+static Orderptr newOrder( void )
+{
+  Orderptr order = (Orderptr) calloc( 1, sizeof(struct order_struct) );
+  init_order( order );
+  return order;
+}
+
+static void freeOrder( Orderptr order )
+{
+  cleanup_order( order );
+  free( order );
+}
+
+/**
+ * Does what the main program does for a single run, except for the output
+ * files, in a context of its own; the current context is the default one
+ * before and after
+ */
+static void doRun( BatchRunptr run )
+{
+  BatchInstanceptr instance = run->instance;
+  acquireInstance( instance );
+  setRunContext( run->configuration->context );
+  RunContextptr context = newRunContext();
+  setRunContext( context );
+  copyGraph( instance->context );
+  // each run starts the random number generator of its thread afresh, as
+  // a separate process would
+  init_genrand( OPTION(random_seed) );
+
+  initPriorityEdges();
+  initCrossings();
+  initChannels();
+  init_crossing_stats();
+  updateAllCrossings();
+  capture_beginning_stats();
+  CTX(best_crossings_order) = newOrder();
+  CTX(best_edge_crossings_order) = newOrder();
+  CTX(best_total_stretch_order) = newOrder();
+  CTX(best_bottleneck_stretch_order) = newOrder();
+  CTX(best_favored_crossings_order) = newOrder();
+
+  CTX(start_time) = USER_SECONDS;
+  run->status = "ok";
+  if ( ! runPreprocessor() )
+    run->status = "bad_preprocessor";
+  else
+    {
+      updateAllCrossings();
+      capture_preprocessing_stats();
+      end_of_iteration();
+      if ( ! runHeuristic() )
+        run->status = "bad_heuristic";
+      else
+        {
+          capture_heuristic_stats();
+          if ( OPTION(do_post_processing) )
+            {
+              restore_order( CTX(best_crossings_order) );
+              updateAllCrossings();
+              swapping();
+            }
+          capture_post_processing_stats();
+        }
+    }
+  CTX(runtime) = RUNTIME;
+
+  strcpy( run->name_of_graph, CTX(graph_name) );
+  run->node_count = CTX(number_of_nodes);
+  run->edge_count = CTX(number_of_edges);
+  run->layer_count = CTX(number_of_layers);
+  run->preprocessor_name = OPTION(preprocessor);
+  run->heuristic_name = OPTION(heuristic);
+  run->iterations = CTX(iteration);
+  run->post_iterations = CTX(post_processing_iteration);
+  run->crossing_stats = CTX(total_crossings);
+  run->bottleneck_stats = CTX(max_edge_crossings);
+  run->stretch_stats = CTX(total_stretch);
+  run->bottleneck_stretch_stats = CTX(bottleneck_stretch);
+  run->run_seconds = CTX(runtime);
+
+  freeOrder( CTX(best_crossings_order) );
+  freeOrder( CTX(best_edge_crossings_order) );
+  freeOrder( CTX(best_total_stretch_order) );
+  freeOrder( CTX(best_bottleneck_stretch_order) );
+  freeOrder( CTX(best_favored_crossings_order) );
+  cleanup_versions();
+  freeHeuristics();
+  cleanup_crossing_stats();
+  freePriorityEdges();
+  freeChannels();
+  freeCrossings();
+  freeGraph();
+  setRunContext( NULL );
+  freeRunContext( context );
+  releaseInstance( instance );
+  finishRun( run );
+}
+
+static void * workerLoop( void * unused )
+{
+#ifdef _OPENMP
+  // the workers already keep the processors busy
+  omp_set_num_threads( 1 );
+#endif
+  for ( ; ; )
+    {
+      pthread_mutex_lock( & batch_lock );
+      int index = next_run < run_count ? next_run++ : -1;
+      pthread_mutex_unlock( & batch_lock );
+      if ( index < 0 ) break;
+      doRun( & runs[ index ] );
+    }
+  free_pair_scratch();
+  free_sort_scratch();
+  return NULL;
+}
+
+static void freeBatch( void )
+{
+  for ( int i = 0; i < instance_count; i++ )
+    {
+      pthread_mutex_destroy( & instances[i]->lock );
+      freeWords( instances[i]->words, instances[i]->word_count );
+      free( instances[i] );
+    }
+  for ( int i = 0; i < configuration_count; i++ )
+    {
+      freeRunContext( configurations[i]->context );
+      freeWords( configurations[i]->words, configurations[i]->word_count );
+      free( configurations[i] );
+    }
+  free( instances );
+  free( configurations );
+  free( runs );
+  free( results_file_name );
+  instances = NULL;
+  configurations = NULL;
+  runs = NULL;
+  results_file_name = NULL;
+  instance_count = instance_capacity = 0;
+  configuration_count = configuration_capacity = 0;
+  run_count = next_run = next_row = 0;
+}
+
+void runBatch( const char * manifest_file_name,
+               ConfigurationParser parse_configuration )
+{
+  manifest_name = manifest_file_name;
+  readManifest( parse_configuration );
+  json_results = hasExtension( results_file_name, ".jsonl" );
+  results_stream = fopen( results_file_name, "w" );
+  if ( results_stream == NULL )
+    {
+      fprintf( stderr, "Unable to open file %s for output\n",
+               results_file_name );
+      exit( EXIT_FAILURE );
+    }
+
+  run_count = instance_count * configuration_count;
+  runs = (struct batch_run *) calloc( run_count, sizeof(struct batch_run) );
+  for ( int i = 0; i < instance_count; i++ )
+    {
+      instances[i]->runs_left = configuration_count;
+      for ( int j = 0; j < configuration_count; j++ )
+        {
+          runs[ i * configuration_count + j ].instance = instances[i];
+          runs[ i * configuration_count + j ].configuration
+            = configurations[j];
+        }
+    }
+  if ( worker_count == 0 )
+    worker_count = (int) sysconf( _SC_NPROCESSORS_ONLN );
+  if ( worker_count < 1 ) worker_count = 1;
+  if ( worker_count > run_count ) worker_count = run_count;
+  printf( "Batch %s: %d runs (%d instances, %d configurations),"
+          " %d workers, results in %s\n",
+          manifest_name, run_count, instance_count, configuration_count,
+          worker_count, results_file_name );
+
+  writeHeader();
+  pthread_t * workers = (pthread_t *) malloc( worker_count * sizeof(pthread_t) );
+  int started = 0;
+  for ( ; started < worker_count; started++ )
+    if ( pthread_create( & workers[ started ], NULL, workerLoop, NULL ) != 0 )
+      break;
+  if ( started == 0 )
+    {
+      // not fatal: the runs are simply done by the main thread
+      fprintf( stderr, "Warning: unable to start worker threads\n" );
+      workerLoop( NULL );
+    }
+  for ( int i = 0; i < started; i++ )
+    pthread_join( workers[i], NULL );
+  free( workers );
+  if ( fclose( results_stream ) != 0 )
+    {
+      fprintf( stderr, "FATAL: unable to write %s\n", results_file_name );
+      exit( EXIT_FAILURE );
+    }
+
+  printf( "Batch %s: done, %d runs\n", manifest_name, run_count );
+  freeBatch();
+}
+
+/*  [Last modified: 2026 10 16 at 18:53:46 GMT] */
@@ -0,0 +1,75 @@
+/**
+ * @file batch.h
+ * @brief Batch mode of min_crossings (option -X): many runs, each applying
+ * a configuration (a set of options) to an instance (a graph), in a single
+ * process. Each instance is read only once; the runs are carried out by a
+ * pool of worker threads, each run in its own run context (see context.h)
+ * with its own copy of the graph, and their results go into one table.
+ *
+ * The manifest is a text file with one directive per line; blank lines and
+ * lines that start with # are ignored.
+ *
+ *   results FILE          where the table goes (required); JSON lines if
+ *                         FILE ends in .jsonl, CSV otherwise
+ *   workers N             number of worker threads
+ *                         [default: number of processors online]
+ *   instance DOT ORD      an instance given by a dot and an ord file
+ *   instance FILE         an instance given by an sgf file or, if FILE ends
+ *                         in .snap, a snapshot
+ *   config NAME OPTIONS   a configuration: NAME followed by options as on
+ *                         the command line, e.g.,
+ *                           config sift-post -h sifting -z -i 1000
+ *
+ * Every configuration is run on every instance. The options given on the
+ * command line along with -X are defaults for all configurations. Options
+ * that write files or concern the program as a whole (-c -f -o -O -S -W -B
+ * -m -X) are not allowed in a configuration. Runtimes are user times of the
+ * worker thread doing the run, so they do not depend on what the other
+ * workers do.
+ *
+ * The table has one row per run, in the order of the instances and, for
+ * each instance, of the configurations; a row is written as soon as it and
+ * all rows before it are done. The columns are
+ *   instance, config   as in the manifest (the first file of the instance)
+ *   status             ok, or bad_preprocessor or bad_heuristic if the run
+ *                      could not be done; in that case the columns from
+ *                      iterations on, except load_seconds, are empty (null)
+ *   graph, nodes, edges, layers
+ *   preprocessor, heuristic
+ *   iterations, post_iterations
+ *   start_crossings, crossings, crossings_iteration
+ *   start_bottleneck, bottleneck, bottleneck_iteration
+ *   stretch, stretch_iteration, bottleneck_stretch,
+ *   bottleneck_stretch_iteration
+ *   load_seconds       time to read the instance (once for all its runs)
+ *   runtime            time of the run, as in the Runtime line of a single
+ *                      run, but without the output files
+ * where each best value is the final one, i.e., after post-processing if
+ * any, and the iteration is the one at which it was found (see
+ * print_run_statistics() in stats.h).
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+/**
+ * Sets the options of the current context from a configuration of the
+ * manifest, given as argv[0] = NAME and argv[1], ..., argv[argc - 1] =
+ * OPTIONS; errors are fatal
+ */
+typedef void (* ConfigurationParser)( int argc, char * argv[] );
+
+/**
+ * Carries out all runs given by the manifest and writes the table of
+ * results; errors in the manifest are fatal and are reported before any
+ * run starts
+ */
+void runBatch( const char * manifest_file_name,
+               ConfigurationParser parse_configuration );
+
+#endif
+
+/*  [Last modified: 2026 10 16 at 16:51:03 GMT] */
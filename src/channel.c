@@ -7,23 +7,30 @@
 
 #include<stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
 #include "graph.h"
 #include "min_crossings.h"
 #include "heuristics.h"
 #include "channel.h"
+#include "crossing_utilities.h"
 #include "stretch.h"
 #include "random.h"
 
-Channelptr * channels;
+/**
+ * CTX(index_on_layer)[ node->id ] is the index of the node in the pair
+ * crossings tables of its layer; this is its position in the initial order
+ * and never changes
+ */
 
 /**
  * @return the number of edges between layers i-1 and i
  */
 static int count_down_edges(int i)
 {
-  Layerptr layer = layers[i];
+  Layerptr layer = CTX(layers)[i];
   int count = 0;
-  for( int j = 0; j < layer->number_of_nodes; j++ ) {
+  for( int j = 0; j < layer->node_count; j++ ) {
     count += layer->nodes[j]->down_degree; 
   }
   return count;
@@ -37,13 +44,13 @@ static int count_down_edges(int i)
 static Channelptr initChannel(int i) {
   Channelptr new_channel
     = (Channelptr) calloc(1, sizeof(struct channel_struct));
-  new_channel->number_of_edges = count_down_edges(i);
+  new_channel->edge_count = count_down_edges(i);
   new_channel->edges
-    = (Edgeptr *) calloc(new_channel->number_of_edges,
+    = (Edgeptr *) calloc(new_channel->edge_count,
                          sizeof(Edgeptr));
   int edge_position = 0;
-  for (int j = 0; j < layers[i]->number_of_nodes; j++) {
-    Nodeptr current_node = layers[i]->nodes[j];
+  for (int j = 0; j < CTX(layers)[i]->node_count; j++) {
+    Nodeptr current_node = CTX(layers)[i]->nodes[j];
     for (int k = 0; k < current_node->down_degree; k++) {
       new_channel->edges[edge_position++] = current_node->down_edges[k];
     }
@@ -51,41 +58,105 @@ static Channelptr initChannel(int i) {
   return new_channel;
 }
 
+/**
+ * sets up the node indices used for pair crossings
+ */
+static void init_pair_crossings(void) {
+  CTX(index_on_layer) = (int *) calloc(CTX(number_of_nodes), sizeof(int));
+  for ( int layer = 0; layer < CTX(number_of_layers); layer++ ) {
+    for ( int j = 0; j < CTX(layers)[layer]->node_count; j++ ) {
+      CTX(index_on_layer)[CTX(layers)[layer]->nodes[j]->id] = j;
+    }
+  }
+}
+
 /**
  * initializes data structures relevant to channels
  */
 void initChannels(void) {
-  channels
-    = (Channelptr *) calloc( number_of_layers, sizeof(Channelptr) );
-  for( int i = 1; i < number_of_layers; i++ ) {
-    channels[i] = initChannel(i);
+  CTX(channels)
+    = (Channelptr *) calloc( CTX(number_of_layers), sizeof(Channelptr) );
+  for( int i = 1; i < CTX(number_of_layers); i++ ) {
+    CTX(channels)[i] = initChannel(i);
+  }
+  if ( OPTION(cache_pair_crossings) ) {
+    init_pair_crossings();
+  }
+}
+
+/**
+ * @return true if the stretch of the edges of channel i, times the product
+ * of the scales of its two layers, can be summed as integers without any
+ * risk of overflow
+ */
+static bool exact_stretch(int i) {
+  double scale_product = (double) layerScale(i - 1) * layerScale(i);
+  return scale_product
+    <= (double) LLONG_MAX / 2 / (CTX(channels)[i]->edge_count + 1);
+}
+
+/**
+ * @return the stretch of an edge whose endpoints are at the given positions
+ * times the product of the two scales, an integer
+ */
+static long long scaled_stretch(int down_position, int up_position,
+                                long down_scale, long up_scale) {
+  return llabs( (long long) down_position * up_scale
+                - (long long) up_position * down_scale );
+}
+
+/**
+ * @return the sum of the scaled stretch of the edges of channel i
+ */
+static long long scaled_channel_stretch(int i) {
+  Channelptr channel = CTX(channels)[i];
+  long down_scale = layerScale(i - 1);
+  long up_scale = layerScale(i);
+  long long scaled_total = 0;
+  for ( int j = 0; j < channel->edge_count; j++ ) {
+    Edgeptr edge = channel->edges[j];
+    scaled_total += scaled_stretch(edge->down_node->position,
+                                   edge->up_node->position,
+                                   down_scale, up_scale);
   }
+  return scaled_total;
 }
 
 /**
  * @return the total stretch of edges in channel i; assumes the positions of
  * nodes on the two layers have been updated correctly
+ *
+ * All edges of the channel have the same two scales, so the stretch of an
+ * edge times their product is an integer. Summing those integers makes the
+ * total independent of the order of the edges, which depends on how the
+ * graph was read (dot and ord, sgf or snapshot). Only if the sum could
+ * overflow is the stretch of each edge added in floating point.
  */
 double totalChannelStretch(int i) {
-  double total_stretch = 0.0;
-  for ( int j = 0; j < channels[i]->number_of_edges; j++ ) {
-    total_stretch += stretch(channels[i]->edges[j]);
+  Channelptr channel = CTX(channels)[i];
+  if ( ! exact_stretch(i) ) {
+    double total = 0.0;
+    for ( int j = 0; j < channel->edge_count; j++ ) {
+      total += stretch(channel->edges[j]);
+    }
+    return total;
   }
-  return total_stretch;
+  return scaled_channel_stretch(i)
+    / ( (double) layerScale(i - 1) * layerScale(i) );
 }
 
 /**
  * @return the total stretch of edges incident on layer i
  */
 double totalLayerStretch(int i) {
-  double total_stretch = 0.0;
+  double total = 0.0;
   if ( i > 0 ) {
-    total_stretch += totalChannelStretch(i);
+    total += totalChannelStretch(i);
   }
-  if ( i < number_of_layers - 1 ) {
-    total_stretch += totalChannelStretch(i + 1);
+  if ( i < CTX(number_of_layers) - 1 ) {
+    total += totalChannelStretch(i + 1);
   }
-  return total_stretch;
+  return total;
 }
 
 /**
@@ -94,8 +165,8 @@ double totalLayerStretch(int i) {
  */
 double maxEdgeStretchInChannel(int i) {
   double max_stretch = 0.0;
-  for ( int j = 0; j < channels[i]->number_of_edges; j++ ) {
-    double current_stretch = stretch(channels[i]->edges[j]);
+  for ( int j = 0; j < CTX(channels)[i]->edge_count; j++ ) {
+    double current_stretch = stretch(CTX(channels)[i]->edges[j]);
     if ( current_stretch > max_stretch ) {
       max_stretch = current_stretch;
     }
@@ -103,21 +174,113 @@ double maxEdgeStretchInChannel(int i) {
   return max_stretch;
 }
 
+/**
+ * Finds the maximum stretch of an edge in channel i and an edge that has
+ * it, as maxEdgeStretchInChannel() does
+ */
+static void find_max_stretch(int i) {
+  Channelptr channel = CTX(channels)[i];
+  channel->max_stretch = 0.0;
+  channel->max_stretch_edge = NULL;
+  for ( int j = 0; j < channel->edge_count; j++ ) {
+    double current_stretch = stretch(channel->edges[j]);
+    if ( current_stretch > channel->max_stretch ) {
+      channel->max_stretch = current_stretch;
+      channel->max_stretch_edge = channel->edges[j];
+    }
+  }
+}
+
+void updateChannelStretch(int i) {
+  Channelptr channel = CTX(channels)[i];
+  if ( exact_stretch(i) ) {
+    channel->scaled_stretch = scaled_channel_stretch(i);
+    channel->stretch = channel->scaled_stretch
+      / ( (double) layerScale(i - 1) * layerScale(i) );
+  }
+  else {
+    channel->stretch = totalChannelStretch(i);
+  }
+  find_max_stretch(i);
+}
+
+void adjustChannelStretch(int i, int layer, int old_position,
+                          int new_position) {
+  if ( ! exact_stretch(i) ) {
+    updateChannelStretch(i);
+    return;
+  }
+  Channelptr channel = CTX(channels)[i];
+  long down_scale = layerScale(i - 1);
+  long up_scale = layerScale(i);
+  // the moved node and the nodes it passed over are the ones between the
+  // two positions; the latter moved one position toward old_position
+  bool moved_left = new_position < old_position;
+  int first = moved_left ? new_position : old_position;
+  int last = moved_left ? old_position : new_position;
+  bool down = layer == i;
+  Nodeptr * nodes = CTX(layers)[layer]->nodes;
+  double max_stretch = -1.0;
+  Edgeptr max_stretch_edge = NULL;
+  bool max_edge_moved = false;
+  for ( int position = first; position <= last; position++ ) {
+    Nodeptr node = nodes[position];
+    int previous_position = old_position;
+    if ( position != new_position ) {
+      previous_position = moved_left ? position - 1 : position + 1;
+    }
+    int degree = down ? node->down_degree : node->up_degree;
+    Edgeptr * edges = down ? node->down_edges : node->up_edges;
+    for ( int j = 0; j < degree; j++ ) {
+      Edgeptr edge = edges[j];
+      if ( down ) {
+        int other_position = edge->down_node->position;
+        channel->scaled_stretch
+          += scaled_stretch(other_position, position, down_scale, up_scale)
+          - scaled_stretch(other_position, previous_position,
+                           down_scale, up_scale);
+      }
+      else {
+        int other_position = edge->up_node->position;
+        channel->scaled_stretch
+          += scaled_stretch(position, other_position, down_scale, up_scale)
+          - scaled_stretch(previous_position, other_position,
+                           down_scale, up_scale);
+      }
+      if ( edge == channel->max_stretch_edge ) max_edge_moved = true;
+      double current_stretch = stretch(edge);
+      if ( current_stretch > max_stretch ) {
+        max_stretch = current_stretch;
+        max_stretch_edge = edge;
+      }
+    }
+  }
+  channel->stretch
+    = channel->scaled_stretch / ( (double) down_scale * up_scale );
+  if ( max_stretch >= channel->max_stretch ) {
+    channel->max_stretch = max_stretch;
+    channel->max_stretch_edge = max_stretch_edge;
+  }
+  else if ( max_edge_moved ) {
+    find_max_stretch(i);
+  }
+}
+
 /**
  * @return the total stretch of all edges
  */
 double totalStretch() {
 #ifdef DEBUG
-  printf("-> totalStretch, iteration = %d\n", iteration);
+  printf("-> totalStretch, iteration = %d\n", CTX(iteration));
 #endif
-  double total_stretch = 0.0;
-  for ( int i = 1; i < number_of_layers; i++ ) {
-    total_stretch += totalChannelStretch(i);
+  double total = 0.0;
+  for ( int i = 1; i < CTX(number_of_layers); i++ ) {
+    total += CTX(channels)[i]->stretch;
   }
 #ifdef DEBUG
-  printf("<- totalStretch, total_stretch = %7.2f\n", total_stretch);
+  printf("<- totalStretch, total = %7.2f\n", total);
 #endif
-  return total_stretch;
+  return total;
 }
 
 /**
@@ -125,13 +288,12 @@ double totalStretch() {
  */
 double maxEdgeStretch() {
 #ifdef DEBUG
-  printf("-> maxEdgeStretch, iteration = %d\n", iteration);
+  printf("-> maxEdgeStretch, iteration = %d\n", CTX(iteration));
 #endif
   double max_stretch = 0.0;
-  for ( int i = 1; i < number_of_layers; i++ ) {
-    double channel_stretch = maxEdgeStretchInChannel(i);
-    if ( channel_stretch > max_stretch ) {
-      max_stretch = channel_stretch;
+  for ( int i = 1; i < CTX(number_of_layers); i++ ) {
+    if ( CTX(channels)[i]->max_stretch > max_stretch ) {
+      max_stretch = CTX(channels)[i]->max_stretch;
     }
   }
 #ifdef DEBUG
@@ -146,11 +308,12 @@ double maxEdgeStretch() {
 Edgeptr maxStretchEdge() {
   Edgeptr max_stretch_edge = NULL;
   double max_stretch = -1.0;
-  if ( randomize_order ) {
-    genrand_permute(master_edge_list, number_of_edges, sizeof(Edgeptr));
+  if ( OPTION(randomize_order) ) {
+    genrand_permute(CTX(master_edge_list), CTX(number_of_edges),
+                    sizeof(Edgeptr));
   }
-  for ( int i = 0; i < number_of_edges; i++ ) {
-    Edgeptr edge = master_edge_list[i];
+  for ( int i = 0; i < CTX(number_of_edges); i++ ) {
+    Edgeptr edge = CTX(master_edge_list)[i];
     double current_stretch = stretch(edge);
     if( current_stretch > max_stretch && ! isFixedEdge( edge ) ) {
       max_stretch = current_stretch;
@@ -160,4 +323,143 @@ Edgeptr maxStretchEdge() {
   return max_stretch_edge;
 }
 
-/*  [Last modified: 2016 05 20 at 18:48:51 GMT] */
+/**
+ * Largest number of entries in a table of pair crossings, 2^22 (32MB),
+ * i.e., layers of up to 2048 nodes; pairs on larger layers are not cached
+ */
+#define MAX_PAIR_ENTRIES ((size_t) 1 << 22)
+
+/**
+ * @return a new (empty) table of pair crossings for the given layer; it
+ * has no entries if the layer is too large or they cannot be allocated
+ */
+static PairCrossingsptr make_pair_crossings(int layer) {
+  PairCrossingsptr pairs
+    = (PairCrossingsptr) calloc(1, sizeof(struct pair_crossings_struct));
+  if ( pairs == NULL ) {
+    fprintf(stderr, "FATAL: unable to allocate pair crossings of layer %d\n",
+            layer);
+    abort();
+  }
+  size_t layer_size = CTX(layers)[layer]->node_count;
+  pairs->layer = layer;
+  pairs->layer_size = layer_size;
+  pairs->generation = 1;
+  if ( layer_size * layer_size <= MAX_PAIR_ENTRIES ) {
+    // calloc() sets every generation to 0, which is never valid
+    pairs->entries = (struct pair_entry *)
+      calloc(layer_size * layer_size, sizeof(struct pair_entry));
+  }
+  return pairs;
+}
+
+/**
+ * Computes c(a,b) and c(b,a) for the nodes with the given indices and stores
+ * both in the table.
+ */
+static void compute_pair(PairCrossingsptr pairs, bool down,
+                         Nodeptr node_a, Nodeptr node_b, int i, int j) {
+  int b_first = 0;
+  int a_first = pair_crossings(node_a, node_b, down, &b_first);
+  size_t n = pairs->layer_size;
+  pairs->entries[i * n + j].crossings = a_first;
+  pairs->entries[i * n + j].generation = pairs->generation;
+  pairs->entries[j * n + i].crossings = b_first;
+  pairs->entries[j * n + i].generation = pairs->generation;
+}
+
+/**
+ * @return c(left_node, right_node) with respect to the channel whose table
+ * is pairs; down is true if the table is for the upper layer of the
+ * channel, i.e., based on down edges
+ */
+static int channel_pair_crossings(PairCrossingsptr pairs, bool down,
+                                  Nodeptr left_node, Nodeptr right_node) {
+  if ( pairs->entries == NULL ) {
+    return pair_crossings(left_node, right_node, down, NULL);
+  }
+  size_t n = pairs->layer_size;
+  size_t i = CTX(index_on_layer)[left_node->id];
+  size_t j = CTX(index_on_layer)[right_node->id];
+  size_t entry = i * n + j;
+  if ( pairs->entries[entry].generation != pairs->generation ) {
+    compute_pair(pairs, down, left_node, right_node, i, j);
+  }
+  return pairs->entries[entry].crossings;
+}
+
+int pairCrossings(Nodeptr left_node, Nodeptr right_node) {
+  int layer = left_node->layer;
+  int crossings = 0;
+  if ( layer > 0 ) {
+    // crossings among down edges, pairs on the upper layer of channel layer
+    Channelptr channel = CTX(channels)[layer];
+    if ( channel->upper_pairs == NULL )
+      channel->upper_pairs = make_pair_crossings(layer);
+    crossings += channel_pair_crossings(channel->upper_pairs, true,
+                                        left_node, right_node);
+  }
+  if ( layer < CTX(number_of_layers) - 1 ) {
+    // crossings among up edges, pairs on the lower layer of channel layer + 1
+    Channelptr channel = CTX(channels)[layer + 1];
+    if ( channel->lower_pairs == NULL )
+      channel->lower_pairs = make_pair_crossings(layer);
+    crossings += channel_pair_crossings(channel->lower_pairs, false,
+                                        left_node, right_node);
+  }
+  return crossings;
+}
+
+static void free_pair_crossings(PairCrossingsptr pairs) {
+  if ( pairs == NULL ) return;
+  free(pairs->entries);
+  free(pairs);
+}
+
+void freeChannels(void) {
+  if ( CTX(channels) != NULL ) {
+    for ( int i = 1; i < CTX(number_of_layers); i++ ) {
+      free(CTX(channels)[i]->edges);
+      free_pair_crossings(CTX(channels)[i]->upper_pairs);
+      free_pair_crossings(CTX(channels)[i]->lower_pairs);
+      free(CTX(channels)[i]);
+    }
+    free(CTX(channels));
+    CTX(channels) = NULL;
+  }
+  free(CTX(index_on_layer));
+  CTX(index_on_layer) = NULL;
+}
+
+/**
+ * Invalidates all entries of the table in O(1) time by starting a new
+ * generation; only when the generation wraps around are the entries reset
+ */
+static void invalidate_pairs(PairCrossingsptr pairs) {
+  if ( pairs == NULL ) return;
+  pairs->generation++;
+  if ( pairs->generation == 0 ) {
+    size_t n = pairs->layer_size;
+    if ( pairs->entries != NULL )
+      memset(pairs->entries, 0, n * n * sizeof(struct pair_entry));
+    pairs->generation = 1;
+  }
+}
+
+void invalidatePairCrossings(int layer) {
+  if ( ! OPTION(cache_pair_crossings) ) return;
+  if ( layer > 0 ) {
+    invalidate_pairs(CTX(channels)[layer]->lower_pairs);
+  }
+  if ( layer < CTX(number_of_layers) - 1 ) {
+    invalidate_pairs(CTX(channels)[layer + 1]->upper_pairs);
+  }
+}
+
+void invalidateAllPairCrossings(void) {
+  for ( int layer = 0; layer < CTX(number_of_layers); layer++ ) {
+    invalidatePairCrossings(layer);
+  }
+}
+
+/*  [Last modified: 2026 10 16 at 18:59:06 GMT] */
@@ -10,20 +10,66 @@
  * crossings updates alone for now.
  */
 
+#include<stdbool.h>
 #include "graph.h"
 
+/**
+ * Crossing numbers c(a,b) for all pairs of nodes a, b on one layer, counting
+ * only the edges in one channel: c(a,b) is the number of crossings among
+ * those edges of a and b when a is to the left of b. The numbers depend on
+ * the order of the layer on the other side of the channel but not on that
+ * of the layer of a and b, so they remain valid while a and b are moved
+ * around. Entries are computed on demand.
+ */
+typedef struct pair_crossings_struct {
+  int layer;
+  int layer_size;
+  /**
+   * entries[ i * layer_size + j ] holds c(a,b), where i and j are the
+   * indices of a and b on the layer (see pairCrossings()); NULL if the
+   * layer is too large for a table, in which case nothing is cached
+   */
+  struct pair_entry {
+    int crossings;
+    /** the entry is valid if this equals the generation of the table */
+    unsigned generation;
+  } * entries;
+  /**
+   * incremented whenever the order of the layer on the other side of the
+   * channel changes, which invalidates all entries at once
+   */
+  unsigned generation;
+} * PairCrossingsptr;
+
 /**
  * Information about edges in the channel between two layers. Channels are
  * numbered starting at 1 (for the channel between layers 0 and 1).
  */
 typedef struct channel_struct {
-  int number_of_edges;
+  int edge_count;
   /**
    * Positions on the lower layer of endpoints of the edges; these are sorted
    * lexicographically by the positions of the upper endpoints. Crossings can
    * be determined by counting inversions in a sort by positions of lower endpoints.
    */
   Edgeptr * edges;
+  /**
+   * cached crossing numbers for pairs of nodes on the upper layer (based on
+   * their down edges) and on the lower layer (based on their up edges);
+   * NULL until first used, and only used if cache_pair_crossings is true
+   */
+  PairCrossingsptr upper_pairs;
+  PairCrossingsptr lower_pairs;
+  /**
+   * total and maximum stretch of the edges as of the most recent call to
+   * updateChannelStretch() or adjustChannelStretch(), an edge that has the
+   * maximum stretch, and the total times the product of the scales of the
+   * two layers (see totalChannelStretch()) if that is summed exactly
+   */
+  double stretch;
+  double max_stretch;
+  Edgeptr max_stretch_edge;
+  long long scaled_stretch;
 } * Channelptr;
 
 /**
@@ -31,11 +77,19 @@ typedef struct channel_struct {
  */
 void initChannels(void);
 
+/**
+ * deallocates the data structures created by initChannels() and the pair
+ * crossings tables
+ */
+void freeChannels(void);
+
 /**
  * channels[i] is information about edges between
- * layers i - 1 and i; the entry for i = 0 is not used
+ * layers i - 1 and i; the entry for i = 0 is not used; part of the run
+ * context - see context.h
+ *
+ *   Channelptr * channels;
  */
-extern Channelptr * channels;
 
 /**
  * @return the total strech of edges in channel i; assumes the positions of
@@ -55,12 +109,32 @@ double totalLayerStretch(int i);
 double maxEdgeStretchInChannel(int i);
 
 /**
- * @return the total stretch of all edges
+ * Recomputes the total and maximum stretch of edges in channel i; called by
+ * the crossings module whenever the channel is recounted, i.e., whenever
+ * the positions on either of its layers may have changed
+ */
+void updateChannelStretch(int i);
+
+/**
+ * Same as updateChannelStretch() after the node now at new_position on the
+ * given layer, one of the two layers of channel i, moved there from
+ * old_position and the nodes in between moved one position toward
+ * old_position; only the edges of those nodes are looked at, unless the
+ * edge with the maximum stretch is among them and its stretch decreased,
+ * or the total cannot be summed exactly
+ */
+void adjustChannelStretch(int i, int layer, int old_position,
+                          int new_position);
+
+/**
+ * @return the total stretch of all edges, as of the most recent update of
+ * each channel
  */
 double totalStretch();
 
 /**
- * @return the maximu stretch of any edge overall
+ * @return the maximu stretch of any edge overall, as of the most recent
+ * update of each channel
  */
 double maxEdgeStretch();
 
@@ -69,4 +143,27 @@ double maxEdgeStretch();
  */
 Edgeptr maxStretchEdge();
 
-/*  [Last modified: 2016 05 20 at 18:39:03 GMT] */
+/**
+ * @return the number of crossings among the edges of left_node and
+ * right_node if left_node is to the left of right_node (both channels, if
+ * present); same as node_crossings() in swap.c, but the value is looked up
+ * in the cache for the two channels incident on the layer and computed only
+ * if not already there; on a layer too large to be cached it is always
+ * computed. There are no side effects on crossing counts of nodes and edges.
+ */
+int pairCrossings( Nodeptr left_node, Nodeptr right_node );
+
+/**
+ * Must be called whenever the order of nodes on the given layer has
+ * changed; invalidates the cached pair crossings of the layers above and
+ * below it (but not those of the layer itself).
+ */
+void invalidatePairCrossings( int layer );
+
+/**
+ * Invalidates all cached pair crossings, e.g., when all layers may have
+ * changed
+ */
+void invalidateAllPairCrossings( void );
+
+/*  [Last modified: 2026 10 16 at 18:59:06 GMT] */
@@ -0,0 +1,76 @@
+/**
+ * @file context.c
+ * @brief Creation and switching of run contexts - see context.h
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+#include"context.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<limits.h>
+#include<float.h>
+
+/**
+ * Initial values of everything that is not 0, false or NULL; the options
+ * have their default values
+ */
+#define INITIAL_CONTEXT {                       \
+    .options = {                                \
+      .heuristic = "",                          \
+      .preprocessor = "",                       \
+      .max_iterations = INT_MAX,                \
+      .max_runtime = DBL_MAX,                   \
+      .number_of_processors = 1,                \
+      .standard_termination = true,             \
+      .adjust_weights = LEFT,                   \
+      .sift_option = DEGREE,                    \
+      .mce_option = NODES,                      \
+      .sifting_style = DEFAULT,                 \
+      .pareto_objective = NO_PARETO,            \
+      .crossing_counter = ACCUMULATOR_TREE,     \
+      /* because -1 is a possible iteration */  \
+      .capture_iteration = INT_MIN,             \
+      .random_seed = 5489,                      \
+      .sift_update = RECOUNT,                   \
+      .sift_batch_size = 1,                     \
+      .trace_freq = -1,                         \
+    },                                          \
+    .min_crossings = INT_MAX,                   \
+    .post_processing_crossings = INT_MAX,       \
+    .min_edge_crossings = INT_MAX,              \
+    .min_crossings_iteration = -1,              \
+    .min_edge_crossings_iteration = -1,         \
+  }
+
+static struct run_context default_context = INITIAL_CONTEXT;
+
+__thread RunContextptr current_context = &default_context;
+
+RunContextptr newRunContext( void )
+{
+  RunContextptr context = (RunContextptr) malloc( sizeof(struct run_context) );
+  if ( context == NULL )
+    {
+      fprintf( stderr, "FATAL: unable to allocate a run context\n" );
+      abort();
+    }
+  *context = (struct run_context) INITIAL_CONTEXT;
+  context->options = current_context->options;
+  return context;
+}
+
+void setRunContext( RunContextptr context )
+{
+  current_context = context != NULL ? context : &default_context;
+}
+
+void freeRunContext( RunContextptr context )
+{
+  if ( context == NULL || context == &default_context ) return;
+  free( context );
+}
+
+/*  [Last modified: 2026 10 16 at 19:01:58 GMT] */
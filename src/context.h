@@ -0,0 +1,406 @@
+/**
+ * @file context.h
+ * @brief The state of a run: the graph, the data structures that the
+ * heuristics maintain for it, the results so far and the command-line
+ * options. All of it used to be process-wide globals; collecting it in a
+ * run_context makes it possible to run several instances (or several
+ * heuristics on copies of one instance) concurrently on threads of one
+ * process.
+ *
+ * Each thread has a current context; a thread starts with a default
+ * context and can switch with setRunContext(). What used to be globals,
+ * e.g., layers, number_of_layers and iteration, are fields of the current
+ * context, accessed as CTX(layers), CTX(number_of_layers), and so on; the
+ * command-line options are accessed as OPTION(verbose), etc. State that is
+ * private to a module is kept in the context in the same way.
+ *
+ * The parallel (OpenMP) regions pass the current context on to their
+ * threads with copyin(current_context); so all threads of a team work on
+ * the same run.
+ *
+ * Typical use by a thread that carries out its own run:
+ *
+ *   RunContextptr context = newRunContext();  // copies the current options
+ *   setRunContext( context );
+ *   readGraph( dot_file, ord_file );
+ *   ... run a heuristic ...
+ *   freeGraph();
+ *   setRunContext( NULL );                    // back to the default
+ *   freeRunContext( context );
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include<stdbool.h>
+#include"defs.h"
+#include"graph.h"
+
+typedef struct crossing_stats_int {
+  int at_beginning;
+  int after_preprocessing;
+  int after_heuristic;
+  int after_post_processing;
+  int best;
+  int previous_best;
+  int best_heuristic_iteration;
+  int best_post_processing_iteration;
+  const char * name;
+} CROSSING_STATS_INT;
+
+typedef struct crossing_stats_double {
+  double at_beginning;
+  double after_preprocessing;
+  double after_heuristic;
+  double after_post_processing;
+  double best;
+  double previous_best;
+  int best_heuristic_iteration;
+  int best_post_processing_iteration;
+  const char * name;
+} CROSSING_STATS_DOUBLE;
+
+/**
+ * For barycenter heuristic: how to deal with nodes that have no
+ *  edges in the direction on which weights are based: see
+ *  adjust_weights_left() and adjust_weights_avg() in barycenter.c. LEFT is
+ *  the default (the nodes follow their left neighbor; this keeps the nodes
+ *  together and makes the heuristic more stable).
+ */
+enum adjust_weights_enum { NONE, LEFT, AVG };
+
+/**
+ * Based on Matuszewski et al. "Extending sifting for k-layer straightline
+ * crossing minimaization": The order in which nodes are sifted can be (1)
+ * based on a layer-by-layer sweep; (2) based on their degree (largest degree
+ * first); or (3) random.  Number (2), DEGREE, is the default and the only
+ * option currently implemented.
+ */
+enum sift_option_enum { LAYER, DEGREE, RANDOM };
+
+/**
+ * When a node is sifted during sifting, mcn, or mce, one can either base its
+ * position on the minimum number of total crossings or, as in the original
+ * mce design, on (local) maximum number of crossings for an edge. These two
+ * options are denoted by TOTAL and MAX, respectively. DEFAULT means use
+ * TOTAL for sifting and mcn, MAX for mce.
+ *
+ * @todo The introduction of mce_s as a separate heuristic makes this enum
+ * superfluous for now, but maybe it should be revived for the sake of
+ * symmetry and completeness -- so that the sifting heuristic can be used
+ * with bottleneck minimization
+ */
+enum sifting_style_enum { DEFAULT, TOTAL, MAX };
+
+/**
+ * During a pass of maximum crossings edge, each iteration fixes both an edge
+ * and the two endpoints of the edge. A pass can end in one of three ways:
+ * - all nodes are fixed (NODES); each node is sifted only once
+ * - all edges are fixed (EDGES); both endpoints of an edge are sifted at
+ * each iteration (fixing of nodes is irrelevant)
+ * - as soon as both endpoints of the current edge are fixed (EARLY)
+ * NODES appears to work best.
+ * The new option, ONE_NODE, sifts only one endpoint of the max crossings
+ * edge, the one with the most node crossings; does not appear to work very
+ * well.
+ */
+enum mce_option_enum { NODES, EDGES, EARLY, ONE_NODE };
+
+/**
+ * For Pareto optimization we can choose a variety of different objectives;
+ * for now we consider two at a time. This option currently affects only what
+ * gets updated and reported, not the behavior of any heuristic.
+ *  NO_PARETO = no Pareto optimization, i.e., don't report Pareto points
+ *  BOTTLENECK_TOTAL = maxEdgeCrossings(),numberOfCrossings()
+ *  STRETCH_TOTAL = totalStretch(),numberOfCrossings()
+ *  BOTTLENECK_STRETCH = maxEdgeCrossings(),totalStretch()
+ */
+enum pareto_objective_enum
+ { NO_PARETO, BOTTLENECK_TOTAL, STRETCH_TOTAL, BOTTLENECK_STRETCH };
+
+/**
+ * How crossings between two adjacent layers are counted when a channel is
+ * updated; both methods give the same counts for edges, nodes, and channels.
+ *  INSERTION_SORT = count inversions during an insertion sort, O(|E|+|C|)
+ *  ACCUMULATOR_TREE = accumulator tree of Barth et al., O(|E| log |V|);
+ *    better when channels are dense (the default)
+ */
+enum crossing_counter_enum { INSERTION_SORT, ACCUMULATOR_TREE };
+
+/**
+ * How crossings are brought up to date after a node is moved by sift()
+ *  RECOUNT = recount both channels incident on the layer (the default)
+ *  DELTA = adjust the crossings of edges, nodes and channels using only the
+ *    nodes that the sifted node passed over
+ *  CHECKED_DELTA = same as DELTA, followed by a recount into scratch space
+ *    that verifies the result without changing it
+ */
+enum sift_update_enum { RECOUNT, DELTA, CHECKED_DELTA };
+
+/**
+ * Format of the input, which is also used for the orderings that are
+ * written
+ *  DOT_AND_ORD = a dot file with the edges and an ord file with the layers
+ *  SGF = a single sgf file (see sgf.h)
+ *  SNAPSHOT = a snapshot file (see snapshot.h); orderings are written as
+ *    ord files
+ */
+enum graph_format_enum { DOT_AND_ORD, SGF, SNAPSHOT };
+
+/**
+ * Parameters based on command-line options, set by min_crossings.c in the
+ * default context of the main thread
+ */
+struct run_options {
+  char * heuristic;
+  char * preprocessor;
+  /**
+   * Maximum number of iterations for the main heuristic; this is the
+   * number of times a layer is sorted. If neither max_iterations nor
+   * max_runtime is specified, standard_termination is used.
+   */
+  int max_iterations;
+  /**
+   * Runtime (in seconds) at which the main heuristic will be terminated;
+   * the termination takes place at this runtime or at max_iterations,
+   * whichever comes first.
+   */
+  double max_runtime;
+  /**
+   * When simulating a heuristic that can be parallelized, there may be a
+   * tradeoff between number of processors and solution quality. Fewer
+   * processors may lead to fewer crossings because the number of crossings
+   * can be checked more often.
+   */
+  int number_of_processors;
+  /**
+   * True if using the standard, "natural" stopping criterion for the
+   * iterative heuristic, e.g., no improvement after a sweep for barycenter.
+   */
+  bool standard_termination;
+  enum adjust_weights_enum adjust_weights;
+  enum sift_option_enum sift_option;
+  enum mce_option_enum mce_option;
+  enum sifting_style_enum sifting_style;
+  enum pareto_objective_enum pareto_objective;
+  enum crossing_counter_enum crossing_counter;
+  /**
+   * Save the order at the end of the given iteration in a file called
+   * capture-x.ord, where x is the iteration number. If the value is
+   * negative, no capture takes place.
+   */
+  int capture_iteration;
+  /**
+   * True if there is a list of favored edges based on predecessors and
+   * successors of a central node
+   */
+  bool favored_edges;
+  /**
+   * True if the edge list (node list) is to be randomized after each pass
+   * of mce (sifting)
+   */
+  bool randomize_order;
+  /**
+   * Seed of the random number generator at the start of the run, set by
+   * -R; the default is the seed that the generator uses if it is not
+   * seeded explicitly
+   */
+  unsigned long random_seed;
+  /**
+   * True if crossing numbers for pairs of nodes on the same layer are to be
+   * cached (see pairCrossings() in channel.h); this speeds up sifting and
+   * swapping on large layers at the expense of memory quadratic in the
+   * layer sizes.
+   */
+  bool cache_pair_crossings;
+  enum sift_update_enum sift_update;
+  /**
+   * Maximum number of nodes, on layers at least two apart, that sifting,
+   * mcn and mce_s sift concurrently (-K); 1 means one node at a time
+   */
+  int sift_batch_size;
+  enum graph_format_enum graph_format;
+  /**
+   * True if taking average of averages when calculating barycenter or
+   * median weights wrt both neighboring layers.  False if dividing total
+   * position by total degree.
+   *
+   * @todo not clear which value of this option works best; stay tuned ...
+   */
+  bool balanced_weight;
+  /**
+   * True if ord files representing the minimum number of crossings should
+   * be written
+   */
+  bool produce_output;
+  /**
+   * output file names are of the form output_base_name-x.ord, where x is
+   * information about the heuristic used
+   */
+  char * output_base_name;
+  /**
+   * True if post processing (swapping neighbors) follows the heuristic
+   */
+  bool do_post_processing;
+  /**
+   * True if verbose information about the graph should be printed
+   */
+  bool verbose;
+  /**
+   * -1 means no tracing, 0 means end of iteration only, trace_freq > 0
+   *  means print a trace message every trace_freq iterations.
+   */
+  int trace_freq;
+  /**
+   * True if RUNTIME is the user time of the calling thread rather than that
+   * of the whole process; set for the runs of a batch (see batch.h), which
+   * share the process, and with -B, whose output thread is not to be counted
+   */
+  bool thread_clock;
+};
+
+typedef struct run_context {
+  struct run_options options;
+
+  // the graph - see graph.h and graph_io.c
+
+  Nodeptr * master_node_list;
+  Edgeptr * master_edge_list;
+  char ** node_names;
+  int number_of_layers;
+  int number_of_nodes;
+  int number_of_edges;
+  int number_of_isolated_nodes;
+  Layerptr * layers;
+  char graph_name[MAX_NAME_LENGTH];
+  int layer_capacity;
+  struct arena_struct * graph_arena;
+  struct node_struct * node_records;
+  struct edge_struct * edge_records;
+  int node_records_left;
+  int node_capacity;
+  int next_node_id;
+  int next_edge_id;
+  struct graph_core_struct * graph_core;
+  struct mapped_input_struct * snapshot_input;
+
+  // name lookup while the graph is read - see hash.c
+
+  unsigned int hash_mask;
+  struct hash_entry * hash_table;
+  struct arena_struct * hash_name_arena;
+  int number_of_entries;
+  long number_of_probes;
+  long number_of_accesses;
+  long number_of_false_matches;
+
+  // crossings - see crossings.c, crossing_utilities.c and channel.c
+
+  struct inter_layer_struct ** between_layers;
+  struct priority_queue_struct * node_queue;
+  struct priority_queue_struct * edge_queue;
+  Nodeptr * node_with_id;
+  Edgeptr * edge_with_id;
+  bool queue_updates_suspended;
+  bool * stale_queue_keys;
+  int pair_scratch_capacity;
+  struct channel_struct ** channels;
+  int * index_on_layer;
+
+  // saved orders - see order.c
+
+  unsigned long * layer_version;
+  unsigned long version_counter;
+  struct layer_image_struct ** latest_image;
+
+  // priority edges - see priority_edges.c
+
+  Edgeptr * priority_edge_list;
+  int number_of_priority_edges;
+  int priority_edge_list_capacity;
+  Edgeptr * edges_by_channel;
+  int * channel_start;
+  int * channel_crossings;
+  bool grouping_is_current;
+
+  // progress of the heuristics - see heuristics.c and dfs.c
+
+  int iteration;
+  int post_processing_iteration;
+  int min_crossings;
+  int post_processing_crossings;
+  int min_edge_crossings;
+  int min_crossings_iteration;
+  int min_edge_crossings_iteration;
+  int previous_print_iteration;
+  bool standard_termination_message_printed;
+  int * phase_layers;
+  Nodeptr * node_batch;
+  Edgeptr * edge_batch;
+  int preorder_number;
+
+  // results - see stats.c and min_crossings.c
+
+  CROSSING_STATS_INT total_crossings;
+  CROSSING_STATS_INT max_edge_crossings;
+  CROSSING_STATS_INT favored_edge_crossings;
+  CROSSING_STATS_DOUBLE total_stretch;
+  CROSSING_STATS_DOUBLE bottleneck_stretch;
+  struct statistics_struct * overall_degree;
+  struct pareto_item * pareto_list;
+  /**
+   * Time that the preprocessor (or heuristic if none) started running
+   */
+  double start_time;
+  double runtime;
+  /**
+   * structures to save layer orderings for the minimum of each objective so
+   * far
+   */
+  struct order_struct * best_crossings_order;
+  struct order_struct * best_edge_crossings_order;
+  struct order_struct * best_total_stretch_order;
+  struct order_struct * best_bottleneck_stretch_order;
+  struct order_struct * best_favored_crossings_order;
+} * RunContextptr;
+
+/**
+ * The context of the calling thread; never NULL
+ */
+extern __thread RunContextptr current_context;
+#ifdef _OPENMP
+#pragma omp threadprivate(current_context)
+#endif
+
+/**
+ * @return a new context with no graph; the options are copied from the
+ * current context, everything else has its initial value
+ */
+RunContextptr newRunContext( void );
+
+/**
+ * Makes the given context current for the calling thread; NULL restores
+ * the default context
+ */
+void setRunContext( RunContextptr context );
+
+/**
+ * Deallocates the context itself; the graph should be deallocated first,
+ * with freeGraph(), while the context is current. The context must not be
+ * current for any thread.
+ */
+void freeRunContext( RunContextptr context );
+
+/**
+ * A field of the current context, e.g., CTX(layers)[i], and an option of
+ * the current context, e.g., OPTION(verbose)
+ */
+#define CTX(field) (current_context->field)
+#define OPTION(name) (current_context->options.name)
+
+#endif
+
+/*  [Last modified: 2026 10 16 at 19:01:58 GMT] */
@@ -36,20 +36,22 @@ void usage_message( char * prog_name )
 
 static void print_stats( void )
 {
-  Statistics degree_info = init_statistics( number_of_nodes );
-  Statistics layer_info = init_statistics( number_of_layers );
-  for( int layer = 0; layer < number_of_layers; layer++ )
+  Statistics degree_info = init_statistics( CTX(number_of_nodes) );
+  Statistics layer_info = init_statistics( CTX(number_of_layers) );
+  for( int layer = 0; layer < CTX(number_of_layers); layer++ )
     {
-      add_data( layer_info, layers[ layer ]->number_of_nodes );
-      for( int position = 0; position < layers[ layer ]->number_of_nodes; position++ )
+      add_data( layer_info, CTX(layers)[ layer ]->node_count );
+      for( int position = 0;
+           position < CTX(layers)[ layer ]->node_count; position++ )
         {
-          Nodeptr node = layers[ layer ]->nodes[ position ];
+          Nodeptr node = CTX(layers)[ layer ]->nodes[ position ];
           add_data( degree_info, DEGREE( node ) );
         }
     }
-  printf( "NumberOfNodes,%d\n", number_of_nodes );
-  printf( "NumberOfEdges,%d\n", number_of_edges );
-  printf( "EdgeDensity,%2.2f\n", ((double) number_of_edges) / number_of_nodes );
+  printf( "NumberOfNodes,%d\n", CTX(number_of_nodes) );
+  printf( "NumberOfEdges,%d\n", CTX(number_of_edges) );
+  printf( "EdgeDensity,%2.2f\n",
+          ((double) CTX(number_of_edges)) / CTX(number_of_nodes) );
   printf( "DegreeStats\t" );
   print_statistics( degree_info, stdout, "%2.1f" );
   printf( "\n" );
@@ -71,7 +73,7 @@ int main( int argc, char * argv[] )
   const char * base_name = argv[1];
   int nodes = atoi( argv[2] );
   int edges = atoi( argv[3] );
-  int layers = atoi( argv[4] );
+  int layer_count = atoi( argv[4] );
   int branching = atoi( argv[5] );
   long seed = atoi( argv[6] );
 
@@ -95,12 +97,12 @@ int main( int argc, char * argv[] )
 
   srandom( seed );
 
-  create_random_dag( nodes, edges, layers, branching ); 
+  create_random_dag( nodes, edges, layer_count, branching ); 
   //  create_random_tree( nodes, layers, branching ); 
 
   print_stats();
 
-  strcpy( graph_name, base_name );
+  strcpy( CTX(graph_name), base_name );
 
   char dot_file_buffer[MAX_NAME_LENGTH];
   char ord_file_buffer[MAX_NAME_LENGTH];
@@ -112,15 +114,15 @@ int main( int argc, char * argv[] )
   strcat( ord_file_buffer, ".ord" );
   sprintf( header_info_buffer,
            " random dag, created by: create_random_dag %s %d %d %d %d %ld\n",
-           graph_name, nodes, edges, layers, branching, seed
+           CTX(graph_name), nodes, edges, layer_count, branching, seed
            );
 
   writeDot(
            dot_file_buffer,
-           graph_name,
+           CTX(graph_name),
            header_info_buffer,
-           master_edge_list,
-           number_of_edges
+           CTX(master_edge_list),
+           CTX(number_of_edges)
            );
   
   writeOrd( ord_file_buffer );
@@ -128,4 +130,4 @@ int main( int argc, char * argv[] )
   return EXIT_SUCCESS;
 }
 
-/*  [Last modified: 2011 06 03 at 17:57:06 GMT] */
+/*  [Last modified: 2026 10 16 at 16:03:56 GMT] */
@@ -11,10 +11,12 @@
 #include"graph.h"
 #include"defs.h"
 #include"crossing_utilities.h"
+#include"graph_core.h"
 #include"sorting.h"
 
 #include<stdio.h>
 #include<stdlib.h>
+#include<string.h>
 #include<assert.h>
 
 #ifdef DEBUG
@@ -30,10 +32,10 @@ static void print_edge( Edgeptr edge )
  * Prints the current sequence of edges between the layers - used for
  * debugging
  */
-static void print_edge_array( Edgeptr * edge_array, int number_of_edges )
+static void print_edge_array( Edgeptr * edge_array, int edge_count )
 {
   int i = 0;
-  for( ; i < number_of_edges; i++ )
+  for( ; i < edge_count; i++ )
     {
       print_edge( edge_array[i] );
       printf("\n");
@@ -82,17 +84,17 @@ int insert_and_count_inversions_down( Edgeptr * edge_array,
   return number_of_crossings;
 }
 
-int count_inversions_down( Edgeptr * edge_array, int number_of_edges, int diff )
+int count_inversions_down( Edgeptr * edge_array, int edge_count, int diff )
 {
 #ifdef DEBUG
   printf("-> count_inversions_down\n");
   printf( " edge array for upper layer %d:\n",
           edge_array[0]->up_node->layer );
-  print_edge_array( edge_array, number_of_edges );
+  print_edge_array( edge_array, edge_count );
 #endif
   int number_of_inversions = 0;
   int i = 1;
-  for( ; i < number_of_edges; i++ )
+  for( ; i < edge_count; i++ )
     {
       number_of_inversions
         += insert_and_count_inversions_down( edge_array, i, diff );
@@ -101,7 +103,7 @@ int count_inversions_down( Edgeptr * edge_array, int number_of_edges, int diff )
   printf("<- count_inversions_down, number = %d\n", number_of_inversions);
   printf( " edge array for upper layer %d:\n", 
           edge_array[0]->up_node->layer );
-  print_edge_array( edge_array, number_of_edges );
+  print_edge_array( edge_array, edge_count );
 #endif
   return number_of_inversions;
 }
@@ -125,26 +127,325 @@ int insert_and_count_inversions_up( Edgeptr * edge_array,
   return number_of_crossings;
 }
 
-int count_inversions_up( Edgeptr * edge_array, int number_of_edges, int diff  )
+int count_inversions_up( Edgeptr * edge_array, int edge_count, int diff  )
 {
 #ifdef DEBUG
   printf("-> count_inversions_up\n");
-  print_edge_array( edge_array, number_of_edges );
+  print_edge_array( edge_array, edge_count );
 #endif
   int number_of_inversions = 0;
   int i = 1;
-  for( ; i < number_of_edges; i++ )
+  for( ; i < edge_count; i++ )
     {
       number_of_inversions
         += insert_and_count_inversions_up( edge_array, i, diff );
     }
 #ifdef DEBUG
   printf("<- count_inversions_up, number = %d\n", number_of_inversions);
-  print_edge_array( edge_array, number_of_edges );
+  print_edge_array( edge_array, edge_count );
 #endif
   return number_of_inversions;
 }
 
+/**
+ * @return the smallest power of 2 that is >= the size of the lower layer;
+ * this is the number of leaves in the accumulator tree
+ */
+static int first_leaf_index( int lower_layer_size )
+{
+  int first_index = 1;
+  while( first_index < lower_layer_size ) first_index *= 2;
+  return first_index;
+}
+
+int accumulator_tree_size( int lower_layer_size )
+{
+  return 2 * first_leaf_index( lower_layer_size ) - 1;
+}
+
+/**
+ * The edges are visited in the order of the array. When an edge e is
+ * visited, its leaf and all ancestors of the leaf are incremented; on the
+ * way up, the right siblings along the path give the number of earlier edges
+ * whose down nodes are to the right of e's and the left siblings give the
+ * number of earlier edges whose down nodes are to the left. The former
+ * cross e. Among the edges whose down nodes are to the left of e's, the ones
+ * that come later in the array also cross e; these are counted using
+ * edges_before (all edges to the left) minus the earlier ones.
+ */
+int count_crossings_accumulator( const int32_t * edge_ids,
+                                 const int32_t * lower_ids,
+                                 int edge_count, int lower_layer_size,
+                                 int * tree, int * edges_before )
+{
+  const int32_t * position = CTX(graph_core)->position;
+  int32_t * edge_crossings = CTX(graph_core)->edge_crossings;
+  int32_t * up_crossings = CTX(graph_core)->up_crossings;
+  int first_index = first_leaf_index( lower_layer_size );
+  int tree_size = 2 * first_index - 1;
+  for( int i = 0; i < tree_size; i++ ) tree[i] = 0;
+
+  // edges_before[p] = number of edges whose down node has position < p
+  for( int p = 0; p <= lower_layer_size; p++ ) edges_before[p] = 0;
+  for( int i = 0; i < edge_count; i++ )
+    {
+      edges_before[ position[ lower_ids[i] ] + 1 ]++;
+    }
+  for( int p = 1; p <= lower_layer_size; p++ )
+    edges_before[p] += edges_before[p - 1];
+
+  int number_of_crossings = 0;
+  for( int i = 0; i < edge_count; i++ )
+    {
+      int32_t lower_id = lower_ids[i];
+      int lower_position = position[ lower_id ];
+      int index = lower_position + first_index - 1;
+      int earlier_right = 0;   /* earlier edges with down node to the right */
+      int earlier_left = 0;    /* earlier edges with down node to the left */
+      tree[index]++;
+      while( index > 0 )
+        {
+          if( index % 2 == 1 ) earlier_right += tree[index + 1];
+          else earlier_left += tree[index - 1];
+          index = (index - 1) / 2;
+          tree[index]++;
+        }
+      int later_left = edges_before[ lower_position ] - earlier_left;
+      int crossings = earlier_right + later_left;
+      edge_crossings[ edge_ids[i] ] = crossings;
+      up_crossings[ lower_id ] += crossings;
+      number_of_crossings += earlier_right;
+    }
+#ifdef DEBUG
+  printf( "<- count_crossings_accumulator, number = %d\n",
+          number_of_crossings );
+#endif
+  return number_of_crossings;
+}
+
+/**
+ * The position of a neighbor of a node and the edge that leads to it
+ */
+typedef struct neighbor_record {
+  int position;
+  Edgeptr edge;
+} NeighborRecord;
+
+/**
+ * Scratch space for the pairwise counts: the sorted neighbors of the left
+ * and right node and room for merging either; each has room for the
+ * maximum degree of any node. Nodes on layers at least two apart may be
+ * sifted concurrently, so each thread has its own scratch space, allocated
+ * on first use.
+ */
+static __thread NeighborRecord * left_neighbors = NULL;
+static __thread NeighborRecord * right_neighbors = NULL;
+static __thread NeighborRecord * merge_scratch = NULL;
+static __thread int scratch_capacity = 0;
+#ifdef _OPENMP
+#pragma omp threadprivate(left_neighbors, right_neighbors, \
+                          merge_scratch, scratch_capacity)
+#endif
+
+/**
+ * CTX(pair_scratch_capacity) is the capacity needed for the scratch space
+ * of the current graph
+ */
+
+void init_pair_scratch( void )
+{
+  int max_degree = 0;
+  for( int i = 0; i < CTX(number_of_nodes); i++ )
+    {
+      Nodeptr node = CTX(master_node_list)[i];
+      if ( node->up_degree > max_degree ) max_degree = node->up_degree;
+      if ( node->down_degree > max_degree ) max_degree = node->down_degree;
+    }
+  CTX(pair_scratch_capacity) = max_degree + 1;
+}
+
+void free_pair_scratch( void )
+{
+  free( left_neighbors );
+  free( right_neighbors );
+  free( merge_scratch );
+  left_neighbors = right_neighbors = merge_scratch = NULL;
+  scratch_capacity = 0;
+}
+
+/**
+ * Makes sure that the calling thread's scratch space is large enough
+ */
+static void ensure_pair_scratch( void )
+{
+  if ( scratch_capacity >= CTX(pair_scratch_capacity) ) return;
+  free_pair_scratch();
+  scratch_capacity = CTX(pair_scratch_capacity);
+  size_t size = scratch_capacity * sizeof(NeighborRecord);
+  left_neighbors = (NeighborRecord *) malloc( size );
+  right_neighbors = (NeighborRecord *) malloc( size );
+  merge_scratch = (NeighborRecord *) malloc( size );
+}
+
+/**
+ * Lists with at most this many neighbors are sorted by insertion
+ */
+#define INSERTION_SORT_LIMIT 16
+
+static void insertion_sort_neighbors( NeighborRecord * neighbors, int count )
+{
+  for( int i = 1; i < count; i++ )
+    {
+      NeighborRecord to_insert = neighbors[i];
+      int j = i - 1;
+      while( j >= 0 && neighbors[j].position > to_insert.position )
+        {
+          neighbors[j + 1] = neighbors[j];
+          j--;
+        }
+      neighbors[j + 1] = to_insert;
+    }
+}
+
+/**
+ * Sorts the neighbors by position with a bottom-up merge sort, using
+ * merge_scratch; runs of INSERTION_SORT_LIMIT are sorted by insertion first
+ */
+static void merge_sort_neighbors( NeighborRecord * neighbors, int count )
+{
+  for( int first = 0; first < count; first += INSERTION_SORT_LIMIT )
+    {
+      int run = count - first;
+      if ( run > INSERTION_SORT_LIMIT ) run = INSERTION_SORT_LIMIT;
+      insertion_sort_neighbors( neighbors + first, run );
+    }
+  NeighborRecord * source = neighbors;
+  NeighborRecord * target = merge_scratch;
+  for( int width = INSERTION_SORT_LIMIT; width < count; width *= 2 )
+    {
+      for( int first = 0; first < count; first += 2 * width )
+        {
+          int middle = first + width < count ? first + width : count;
+          int last = middle + width < count ? middle + width : count;
+          int i = first, j = middle, k = first;
+          while( i < middle && j < last )
+            target[k++] = source[j].position < source[i].position
+              ? source[j++] : source[i++];
+          while( i < middle ) target[k++] = source[i++];
+          while( j < last ) target[k++] = source[j++];
+        }
+      NeighborRecord * tmp = source;
+      source = target;
+      target = tmp;
+    }
+  if ( source != neighbors )
+    memcpy( neighbors, source, count * sizeof(NeighborRecord) );
+}
+
+/**
+ * Fills neighbors with the positions of the neighbors of the node, via its
+ * down edges if down is true, up edges otherwise, and the corresponding
+ * edges, in increasing order of position; the adjacency lists themselves
+ * are left as they are. The lists are often already sorted, e.g., the down
+ * edges after the crossings have been counted, in which case this takes a
+ * single pass; otherwise it takes O(d log d) time for degree d.
+ * @return the number of neighbors
+ */
+static int sorted_neighbors( Nodeptr node, bool down,
+                             NeighborRecord * neighbors )
+{
+  int degree = down ? node->down_degree : node->up_degree;
+  Edgeptr * edges = down ? node->down_edges : node->up_edges;
+  bool sorted = true;
+  for( int i = 0; i < degree; i++ )
+    {
+      Edgeptr edge = edges[i];
+      int position
+        = down ? edge->down_node->position : edge->up_node->position;
+      if ( i > 0 && neighbors[i - 1].position > position ) sorted = false;
+      neighbors[i].position = position;
+      neighbors[i].edge = edge;
+    }
+  if ( sorted ) return degree;
+  if ( degree <= INSERTION_SORT_LIMIT )
+    insertion_sort_neighbors( neighbors, degree );
+  else
+    merge_sort_neighbors( neighbors, degree );
+  return degree;
+}
+
+int pair_crossings( Nodeptr left_node, Nodeptr right_node, bool down,
+                    int * reverse )
+{
+  ensure_pair_scratch();
+  int left_size = sorted_neighbors( left_node, down, left_neighbors );
+  int right_size = sorted_neighbors( right_node, down, right_neighbors );
+  // merge the two sorted position lists; an edge of the left node and one
+  // of the right node cross if the left node's endpoint is to the right
+  int left_first = 0;           /* crossings as given */
+  int right_first = 0;          /* crossings with the nodes swapped */
+  int less = 0;                 /* number of left positions < current right */
+  int less_or_equal = 0;        /* number of left positions <= current right */
+  for( int k = 0; k < right_size; k++ )
+    {
+      int position = right_neighbors[k].position;
+      while( less < left_size && left_neighbors[less].position < position )
+        less++;
+      if ( less_or_equal < less ) less_or_equal = less;
+      while( less_or_equal < left_size
+             && left_neighbors[less_or_equal].position <= position )
+        less_or_equal++;
+      left_first += left_size - less_or_equal;
+      right_first += less;
+    }
+  if ( reverse != NULL ) *reverse = right_first;
+  return left_first;
+}
+
+/**
+ * Adds amount to the crossings of the edge and to the corresponding
+ * crossings of its endpoints
+ */
+static void add_edge_crossings( Edgeptr edge, int amount )
+{
+  edge->crossings += amount;
+  edge->up_node->down_crossings += amount;
+  edge->down_node->up_crossings += amount;
+}
+
+int change_pair_crossings( Nodeptr left_node, Nodeptr right_node,
+                           bool down, int diff )
+{
+  ensure_pair_scratch();
+  int left_size = sorted_neighbors( left_node, down, left_neighbors );
+  int right_size = sorted_neighbors( right_node, down, right_neighbors );
+  int number_of_crossings = 0;
+  // an edge of the left node crosses the edges of the right node whose
+  // endpoints are strictly to the left of its own
+  int less = 0;
+  for( int k = 0; k < left_size; k++ )
+    {
+      int position = left_neighbors[k].position;
+      while( less < right_size && right_neighbors[less].position < position )
+        less++;
+      if ( less > 0 ) add_edge_crossings( left_neighbors[k].edge, diff * less );
+      number_of_crossings += less;
+    }
+  // and vice versa
+  int less_or_equal = 0;
+  for( int k = 0; k < right_size; k++ )
+    {
+      int position = right_neighbors[k].position;
+      while( less_or_equal < left_size
+             && left_neighbors[less_or_equal].position <= position )
+        less_or_equal++;
+      int crossings = left_size - less_or_equal;
+      if ( crossings > 0 )
+        add_edge_crossings( right_neighbors[k].edge, diff * crossings );
+    }
+  return number_of_crossings;
+}
+
 void add_edges_to_array( Edgeptr * edge_array, Edgeptr * edges_to_add,
                          int num_edges, int start_pos )
 {
@@ -155,4 +456,4 @@ void add_edges_to_array( Edgeptr * edge_array, Edgeptr * edges_to_add,
     }
 }
 
-/*  [Last modified: 2014 03 10 at 16:39:24 GMT] */
+/*  [Last modified: 2026 10 16 at 18:53:46 GMT] */
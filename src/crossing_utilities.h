@@ -9,6 +9,7 @@
  */
 
 #include<stdbool.h>
+#include<stdint.h>
 
 #ifndef CROSSING_UTILITIES_H
 #define CROSSING_UTILITIES_H
@@ -21,13 +22,13 @@
  * edges and their nodes accordingly [*** this is a side effect ***].
  *
  * @param edge_array an array of edges sorted by their down nodes
- * @param number_of_edges number of edges in the array
+ * @param edge_count number of edges in the array
  * @param diff indicates whether to increment the crossing counts (+1) or
  * decrement them (-1); the latter is used for updates during sifting.
  *
  * @return the total number of crossings (inversions)
  */
-int count_inversions_up( Edgeptr * edge_array, int number_of_edges,
+int count_inversions_up( Edgeptr * edge_array, int edge_count,
                          int diff );
 
 /**
@@ -47,13 +48,13 @@ int insert_and_count_inversions_up( Edgeptr * edge_array,
  * edges and their nodes accordingly [*** this is a side effect ***].
  *
  * @param edge_array an array of edges sorted by their up nodes
- * @param number_of_edges number of edges in the array
+ * @param edge_count number of edges in the array
  * @param diff indicates whether to increment the crossing counts (+1) or
  * decrement them (-1); the latter is used for updates during sifting.
  *
  * @return the total number of crossings (inversions)
  */
-int count_inversions_down( Edgeptr * edge_array, int number_of_edges,
+int count_inversions_down( Edgeptr * edge_array, int edge_count,
                            int diff );
 
 /**
@@ -68,6 +69,79 @@ int insert_and_count_inversions_down( Edgeptr * edge_array,
                                       int starting_index,
                                       int diff );
 
+/**
+ * Counts the crossings among the edges of a channel using the accumulator
+ * tree of Barth, Juenger, and Mutzel, in O(|E| log |V|) time instead of the
+ * O(|E| + |C|) of count_inversions_down(). Works on graph_core: for each
+ * edge e the crossings are stored in graph_core->edge_crossings[e] and
+ * added to graph_core->up_crossings of its down node [*** this is a side
+ * effect ***]; the caller is responsible for initializing the latter.
+ *
+ * @param edge_ids id's of the edges of the channel, sorted lexicographically
+ * by the positions of their up nodes, then by those of their down nodes
+ * @param lower_ids lower_ids[i] is the id of the down node of edge
+ * edge_ids[i]
+ * @param edge_count number of edges in the arrays
+ * @param lower_layer_size number of nodes on the layer of the down nodes
+ * @param tree scratch space for the accumulator tree, at least 2 * k - 1
+ * entries, where k is the smallest power of 2 >= lower_layer_size
+ * @param edges_before scratch space, at least lower_layer_size + 1 entries;
+ * used to record the number of edges whose down nodes precede each position
+ *
+ * @return the total number of crossings (inversions)
+ */
+int count_crossings_accumulator( const int32_t * edge_ids,
+                                 const int32_t * lower_ids,
+                                 int edge_count, int lower_layer_size,
+                                 int * tree, int * edges_before );
+
+/**
+ * @return the number of entries needed for an accumulator tree used to
+ * count crossings whose lower layer has the given number of nodes
+ */
+int accumulator_tree_size( int lower_layer_size );
+
+/**
+ * Determines the size of the scratch space used by pair_crossings() and
+ * change_pair_crossings(), which each thread allocates on first use; must
+ * be called once the graph has been read and before either is used.
+ */
+void init_pair_scratch( void );
+
+/**
+ * Deallocates the scratch space of the calling thread, e.g., before the
+ * thread exits
+ */
+void free_pair_scratch( void );
+
+/**
+ * Counts crossings among the edges of two nodes on the same layer by
+ * merging the sorted positions of their neighbors; there is no allocation
+ * and no side effect, the adjacency lists of the nodes are not reordered.
+ *
+ * @param down true if the down edges are to be considered, false for up edges
+ * @param reverse if not NULL, gets the number of crossings when right_node
+ * is to the left of left_node
+ *
+ * @return the number of crossings when left_node is to the left of right_node
+ */
+int pair_crossings( Nodeptr left_node, Nodeptr right_node, bool down,
+                    int * reverse );
+
+/**
+ * Same as pair_crossings(), except that the crossings of the edges involved
+ * and their endpoints are changed by diff for every crossing [*** this is a
+ * side effect ***]; equivalent to counting inversions with
+ * count_inversions_down() or count_inversions_up() on the combined edges of
+ * the two nodes.
+ *
+ * @param diff +1 to increase crossing counts, -1 to decrease them
+ *
+ * @return the number of crossings when left_node is to the left of right_node
+ */
+int change_pair_crossings( Nodeptr left_node, Nodeptr right_node,
+                           bool down, int diff );
+
 /**
  * Adds edges to an array of edges. Assumes that there is enough space in the
  * array. Similar to strcat()
@@ -82,4 +156,4 @@ void add_edges_to_array( Edgeptr * edge_array, Edgeptr * edges_to_add,
 
 #endif
 
-/*  [Last modified: 2014 03 10 at 16:37:54 GMT] */
+/*  [Last modified: 2026 10 16 at 18:53:46 GMT] */
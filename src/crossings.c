@@ -3,9 +3,10 @@
  * @brief Implementation of functions that keep track of and update the
  * number of crossings for each node, each layer, and for the whole graph.
  *
- * The algorithm used to count crossings between adjacent layers is the
- * O(|E|+|C|) algorithm from "Simple and efficient bilayer cross counting",
- * W. Barth, M. Juenger, P. Mutzel, in JGAA, 2004.
+ * The algorithms used to count crossings between adjacent layers are from
+ * "Simple and efficient bilayer cross counting", W. Barth, M. Juenger,
+ * P. Mutzel, in JGAA, 2004: either the O(|E|+|C|) insertion sort or the
+ * O(|E| log |V|) accumulator tree, as determined by crossing_counter.
  *
  * @author Matt Stallmann
  * @date 2008/12/23
@@ -17,20 +18,30 @@
 #include"min_crossings.h"
 #include"crossings.h"
 #include"crossing_utilities.h"
+#include"channel.h"
+#include"priority_edges.h"
 #include"heuristics.h"
 #include"sorting.h"
 #include"random.h"
+#include"priority_queue.h"
+#include"order.h"
+#include"graph_core.h"
 
 #include<stdio.h>
 #include<stdlib.h>
 #include<assert.h>
+#include<stdint.h>
+
+#ifdef _OPENMP
+#include<omp.h>
+#endif
 
 /**
  * Information about edges between layers i - 1 and i; the entry for 0 is not
  * used.
  */
 typedef struct inter_layer_struct {
-  int number_of_edges;
+  int edge_count;
   /**
    * Positions on the lower layer of endpoints of the edges; these are
    * initially sorted lexicographically by the positions of the upper
@@ -39,22 +50,58 @@ typedef struct inter_layer_struct {
    */
   Edgeptr * edges;
   int number_of_crossings;
+  /**
+   * scratch space for counting crossings with an accumulator tree; the size
+   * of each depends only on the number of nodes on the lower layer
+   */
+  int * accumulator_tree;
+  int * edges_before;
+  /**
+   * the edges of the channel in the same order as in edges, as id's in
+   * graph_core, and the id's of their down nodes; used by the accumulator
+   * tree
+   */
+  int32_t * edge_ids;
+  int32_t * lower_ids;
+  /**
+   * maximum number of crossings of any edge in the channel, updated along
+   * with number_of_crossings, and an edge that has them (NULL if there are
+   * no crossings)
+   */
+  int max_crossings;
+  Edgeptr max_crossings_edge;
 } * InterLayerptr;
 
 /**
- * between_layers[i] is information about edges between
+ * CTX(between_layers)[i] is information about edges between
  * layers i - 1 and i; the entry for i = 0 is not used
  */
-static InterLayerptr * between_layers;
+
+/**
+ * CTX(node_queue) and CTX(edge_queue) hold the unfixed nodes and edges
+ * keyed on their crossings, used by maxCrossingsNode() and
+ * maxCrossingsEdge(); CTX(node_with_id) and CTX(edge_with_id) map the keys
+ * back to the records. Each queue is created by the first call of the
+ * corresponding function and from then on is kept current by the functions
+ * that update crossings. Fixed nodes and edges are removed lazily, when
+ * they reach the top; resetMaxCrossingsNode() and resetMaxCrossingsEdge()
+ * put them back.
+ */
+
+/**
+ * While queue updates are suspended (CTX(queue_updates_suspended)),
+ * CTX(stale_queue_keys)[i] is true if the crossings of channel i have
+ * changed without the queues being updated
+ */
 
 // ******** Allocation functions for initCrossings() ************
 
 static int count_down_edges( int layer_number )
 {
-  Layerptr layer = layers[ layer_number ];
+  Layerptr layer = CTX(layers)[ layer_number ];
   int count = 0;
   int j = 0;
-  for( ; j < layer->number_of_nodes; j++ )
+  for( ; j < layer->node_count; j++ )
     {
       count += layer->nodes[j]->down_degree; 
     }
@@ -65,10 +112,22 @@ static InterLayerptr makeInterLayer( int upper_layer )
 {
   InterLayerptr new_interlayer
     = (InterLayerptr) malloc( sizeof(struct inter_layer_struct ) );
-  new_interlayer->number_of_edges = count_down_edges( upper_layer );
+  new_interlayer->edge_count = count_down_edges( upper_layer );
   new_interlayer->edges
-    = (Edgeptr *) calloc( new_interlayer->number_of_edges,
+    = (Edgeptr *) calloc( new_interlayer->edge_count,
                        sizeof(Edgeptr) );
+  int lower_layer_size = CTX(layers)[ upper_layer - 1 ]->node_count;
+  new_interlayer->accumulator_tree
+    = (int *) calloc( accumulator_tree_size( lower_layer_size ),
+                      sizeof(int) );
+  new_interlayer->edges_before
+    = (int *) calloc( lower_layer_size + 1, sizeof(int) );
+  new_interlayer->edge_ids
+    = (int32_t *) calloc( new_interlayer->edge_count + 1,
+                          sizeof(int32_t) );
+  new_interlayer->lower_ids
+    = (int32_t *) calloc( new_interlayer->edge_count + 1,
+                          sizeof(int32_t) );
   return new_interlayer;
 }
 
@@ -79,13 +138,46 @@ static InterLayerptr makeInterLayer( int upper_layer )
  */
 void initCrossings( void )
 {
-  between_layers
-    = (InterLayerptr *) calloc( number_of_layers, sizeof(InterLayerptr) );
+  buildGraphCore();
+  CTX(between_layers)
+    = (InterLayerptr *) calloc( CTX(number_of_layers), sizeof(InterLayerptr) );
   int i = 1;
-  for( ; i < number_of_layers; i++ )
+  for( ; i < CTX(number_of_layers); i++ )
     {
-      between_layers[i] = makeInterLayer( i );
+      CTX(between_layers)[i] = makeInterLayer( i );
     }
+  CTX(stale_queue_keys)
+    = (bool *) calloc( CTX(number_of_layers), sizeof(bool) );
+  init_pair_scratch();
+}
+
+void freeCrossings( void )
+{
+  if ( CTX(between_layers) != NULL )
+    {
+      for ( int i = 1; i < CTX(number_of_layers); i++ )
+        {
+          InterLayerptr interlayer = CTX(between_layers)[i];
+          free( interlayer->edges );
+          free( interlayer->accumulator_tree );
+          free( interlayer->edges_before );
+          free( interlayer->edge_ids );
+          free( interlayer->lower_ids );
+          free( interlayer );
+        }
+      free( CTX(between_layers) );
+      CTX(between_layers) = NULL;
+    }
+  free( CTX(stale_queue_keys) );
+  CTX(stale_queue_keys) = NULL;
+  if ( CTX(node_queue) != NULL ) pq_free( CTX(node_queue) );
+  if ( CTX(edge_queue) != NULL ) pq_free( CTX(edge_queue) );
+  CTX(node_queue) = CTX(edge_queue) = NULL;
+  free( CTX(node_with_id) );
+  free( CTX(edge_with_id) );
+  CTX(node_with_id) = NULL;
+  CTX(edge_with_id) = NULL;
+  freeGraphCore();
 }
 
 /**** Other functions ********/
@@ -94,16 +186,22 @@ int numberOfCrossings( void )
 {
   int i = 1;
   int crossings = 0;
-  for( ; i < number_of_layers; i++ )
+  for( ; i < CTX(number_of_layers); i++ )
     {
-      crossings += between_layers[i]->number_of_crossings;
+      crossings += CTX(between_layers)[i]->number_of_crossings;
     }
   return crossings;
 }
 
 int maxEdgeCrossings( void )
 {
-  return maxCrossingsEdgeStatic()->crossings;
+  int max_crossings = 0;
+  for( int i = 1; i < CTX(number_of_layers); i++ )
+    {
+      if ( CTX(between_layers)[i]->max_crossings > max_crossings )
+        max_crossings = CTX(between_layers)[i]->max_crossings;
+    }
+  return max_crossings;
 }
 
 /**
@@ -113,9 +211,9 @@ int numberOfCrossingsLayer( int layer )
 {
   int crossings = 0;
   if( layer > 0 )
-    crossings += between_layers[ layer ]->number_of_crossings;
-  if( layer < number_of_layers - 1 )
-    crossings += between_layers[ layer + 1 ]->number_of_crossings;
+    crossings += CTX(between_layers)[ layer ]->number_of_crossings;
+  if( layer < CTX(number_of_layers) - 1 )
+    crossings += CTX(between_layers)[ layer + 1 ]->number_of_crossings;
   return crossings;
 }
 
@@ -135,45 +233,18 @@ int numberOfCrossingsEdge( Edgeptr edge )
   return edge->crossings;
 }
 
-void updateAllCrossings( void )
-{
-  updateAllPositions();
-  for( int i = 1; i < number_of_layers; i++ )
-    {
-      updateCrossingsBetweenLayers( i );
-    }
-}
-
-void updateCrossingsForLayer( int layer )
-{
-  updateNodePositions( layer );
-  if( layer > 0 ) updateCrossingsBetweenLayers( layer );
-  if( layer < number_of_layers - 1 )
-    updateCrossingsBetweenLayers( layer + 1 );
-}
-
-void updatePositionsForLayer( int layer )
-{
-  Layerptr layer_ptr = layers[ layer ];
-  for ( int i = 0; i < layer_ptr->number_of_nodes; i++ )
-    {
-      Nodeptr node = layer_ptr->nodes[i];
-      node->position = i;
-    }
-}
-
 /**
  * Sets all node crossings relevant to the edges between layers upper_layer
  * and upper_layer - 1 to 0
  */
 static void initialize_crossings( int upper_layer )
 {
-  Layerptr up_layer = layers[ upper_layer ];
-  Layerptr down_layer = layers[ upper_layer - 1 ];
+  Layerptr up_layer = CTX(layers)[ upper_layer ];
+  Layerptr down_layer = CTX(layers)[ upper_layer - 1 ];
   Nodeptr * upper_nodes = up_layer->nodes;
   Nodeptr * lower_nodes = down_layer->nodes;
-  int upper_node_count = up_layer->number_of_nodes;
-  int lower_node_count = down_layer->number_of_nodes;
+  int upper_node_count = up_layer->node_count;
+  int lower_node_count = down_layer->node_count;
   int i = 0;
   for( ; i < upper_node_count; i++ )
     {
@@ -184,50 +255,591 @@ static void initialize_crossings( int upper_layer )
           upper_nodes[i]->down_edges[j]->crossings = 0;
         }
     }
-  for( ; i < lower_node_count; i++ )
+  for( i = 0; i < lower_node_count; i++ )
     {
       lower_nodes[i]->up_crossings = 0;
     } 
 }
 
 /**
- * Updates crossings between two adjacent layers. Also updates the relevant
- * crossing fields of the two layers.
+ * Finds the maximum number of crossings of any edge in the channel and an
+ * edge that has them
+ */
+static void find_max_crossings( InterLayerptr channel )
+{
+  channel->max_crossings = 0;
+  channel->max_crossings_edge = NULL;
+  for( int i = 0; i < channel->edge_count; i++ )
+    {
+      if ( channel->edges[i]->crossings > channel->max_crossings )
+        {
+          channel->max_crossings = channel->edges[i]->crossings;
+          channel->max_crossings_edge = channel->edges[i];
+        }
+    }
+}
+
+/**
+ * Updates the quantities, other than total crossings, that are kept per
+ * channel so that the objectives reported by maxEdgeCrossings(),
+ * totalStretch(), maxEdgeStretch() and priorityEdgeCrossings() need not
+ * look at every edge; assumes that crossings and positions are current for
+ * the channel
+ */
+static void update_channel_objectives( int upper_layer )
+{
+  find_max_crossings( CTX(between_layers)[ upper_layer ] );
+  if ( CTX(channels) != NULL ) updateChannelStretch( upper_layer );
+  updatePriorityEdgeCrossings( upper_layer );
+}
+
+/**
+ * Same as update_channel_objectives() after the node now at new_position on
+ * the given layer, one of the two layers of the channel, moved there from
+ * old_position, passing over the nodes in between; only the edges of those
+ * nodes have changed, so only they are looked at, unless the edge with the
+ * maximum number of crossings is among them and now has fewer, in which
+ * case the whole channel is scanned for the new maximum
+ */
+static void adjust_channel_objectives( int upper_layer, int layer,
+                                       int old_position, int new_position )
+{
+  InterLayerptr channel = CTX(between_layers)[ upper_layer ];
+  Nodeptr * nodes = CTX(layers)[ layer ]->nodes;
+  bool down = layer == upper_layer;
+  int first = old_position < new_position ? old_position : new_position;
+  int last = old_position < new_position ? new_position : old_position;
+  int max_crossings = -1;
+  Edgeptr max_crossings_edge = NULL;
+  bool max_edge_moved = false;
+  for ( int position = first; position <= last; position++ )
+    {
+      Nodeptr node = nodes[ position ];
+      int degree = down ? node->down_degree : node->up_degree;
+      Edgeptr * edges = down ? node->down_edges : node->up_edges;
+      for ( int j = 0; j < degree; j++ )
+        {
+          if ( edges[j] == channel->max_crossings_edge )
+            max_edge_moved = true;
+          if ( edges[j]->crossings > max_crossings )
+            {
+              max_crossings = edges[j]->crossings;
+              max_crossings_edge = edges[j];
+            }
+        }
+    }
+  if ( max_crossings >= channel->max_crossings )
+    {
+      channel->max_crossings = max_crossings;
+      channel->max_crossings_edge
+        = max_crossings > 0 ? max_crossings_edge : NULL;
+    }
+  else if ( max_edge_moved ) find_max_crossings( channel );
+  if ( CTX(channels) != NULL )
+    adjustChannelStretch( upper_layer, layer, old_position, new_position );
+  updatePriorityEdgeCrossings( upper_layer );
+}
+
+/**
+ * Sorts the down neighbors of node v in graph_core by position; stable, so
+ * that the result is the same as that of sortByDownNodePosition() on the
+ * node's down edges, which are rearranged to match if the order changed.
+ */
+static void sort_down_neighbors( int32_t v )
+{
+  const int32_t * position = CTX(graph_core)->position;
+  int32_t * neighbor = CTX(graph_core)->down_neighbor;
+  int32_t * edge = CTX(graph_core)->down_edge;
+  int32_t first = CTX(graph_core)->down_start[v];
+  int32_t last = CTX(graph_core)->down_start[v + 1];
+  bool changed = false;
+  for ( int32_t i = first + 1; i < last; i++ )
+    {
+      int32_t neighbor_to_insert = neighbor[i];
+      int32_t edge_to_insert = edge[i];
+      int32_t key = position[ neighbor_to_insert ];
+      int32_t j = i - 1;
+      while ( j >= first && position[ neighbor[j] ] > key )
+        {
+          neighbor[j + 1] = neighbor[j];
+          edge[j + 1] = edge[j];
+          changed = true;
+          j--;
+        }
+      neighbor[j + 1] = neighbor_to_insert;
+      edge[j + 1] = edge_to_insert;
+    }
+  if ( ! changed ) return;
+  Edgeptr * down_edges = CTX(graph_core)->node_ptr[v]->down_edges;
+  for ( int32_t i = first; i < last; i++ )
+    down_edges[ i - first ] = CTX(graph_core)->edge_ptr[ edge[i] ];
+}
+
+/**
+ * Counts crossings between layers upper_layer - 1 and upper_layer with the
+ * accumulator tree, working on graph_core, and writes the crossings of the
+ * edges and nodes back to their records. The effect is the same as that of
+ * sorting the edges and calling initialize_crossings() followed by the
+ * pointer-based count.
+ * @return the number of crossings
+ */
+static int count_crossings_with_core( int upper_layer )
+{
+  InterLayerptr channel = CTX(between_layers)[ upper_layer ];
+  refreshLayerPositions( upper_layer - 1 );
+  refreshLayerPositions( upper_layer );
+  const int32_t * upper_order
+    = CTX(graph_core)->order + CTX(graph_core)->layer_start[ upper_layer ];
+  const int32_t * lower_order
+    = CTX(graph_core)->order + CTX(graph_core)->layer_start[ upper_layer - 1 ];
+  int upper_node_count = CTX(layers)[ upper_layer ]->node_count;
+  int lower_node_count = CTX(layers)[ upper_layer - 1 ]->node_count;
+
+  // gather the edges lexicographically based primarily on upper layer
+  // endpoints
+  int index = 0;
+  for ( int i = 0; i < upper_node_count; i++ )
+    {
+      int32_t v = upper_order[i];
+      sort_down_neighbors( v );
+      for ( int32_t k = CTX(graph_core)->down_start[v];
+            k < CTX(graph_core)->down_start[v + 1]; k++ )
+        {
+          channel->edge_ids[ index ] = CTX(graph_core)->down_edge[k];
+          channel->lower_ids[ index ] = CTX(graph_core)->down_neighbor[k];
+          index++;
+        }
+    }
+  for ( int i = 0; i < lower_node_count; i++ )
+    CTX(graph_core)->up_crossings[ lower_order[i] ] = 0;
+
+  int number_of_crossings
+    = count_crossings_accumulator( channel->edge_ids, channel->lower_ids,
+                                   channel->edge_count,
+                                   lower_node_count,
+                                   channel->accumulator_tree,
+                                   channel->edges_before );
+
+  // write back to the records, edges first
+  const int32_t * edge_crossings = CTX(graph_core)->edge_crossings;
+  for ( int i = 0; i < channel->edge_count; i++ )
+    {
+      Edgeptr edge = CTX(graph_core)->edge_ptr[ channel->edge_ids[i] ];
+      edge->crossings = edge_crossings[ channel->edge_ids[i] ];
+      channel->edges[i] = edge;
+    }
+  index = 0;
+  Nodeptr * upper_nodes = CTX(layers)[ upper_layer ]->nodes;
+  for ( int i = 0; i < upper_node_count; i++ )
+    {
+      int32_t v = upper_order[i];
+      int degree
+        = CTX(graph_core)->down_start[v + 1] - CTX(graph_core)->down_start[v];
+      int down_crossings = 0;
+      for ( int k = 0; k < degree; k++ )
+        down_crossings += edge_crossings[ channel->edge_ids[ index++ ] ];
+      upper_nodes[i]->down_crossings = down_crossings;
+    }
+  Nodeptr * lower_nodes = CTX(layers)[ upper_layer - 1 ]->nodes;
+  for ( int i = 0; i < lower_node_count; i++ )
+    lower_nodes[i]->up_crossings
+      = CTX(graph_core)->up_crossings[ lower_order[i] ];
+  return number_of_crossings;
+}
+
+/**
+ * Counts crossings between two adjacent layers and updates the relevant
+ * crossing fields of the two layers; does not touch the queues used by
+ * maxCrossingsNode() and maxCrossingsEdge(), so that channels can be counted
+ * in parallel.
  * @param upper_layer the higher of the two layers; crossings between layers
  * upper_layer - 1 and upper_layer are counted
  */
-void updateCrossingsBetweenLayers( int upper_layer )
+static void count_crossings_between_layers( int upper_layer )
 {
+  InterLayerptr channel = CTX(between_layers)[ upper_layer ];
+  if ( OPTION(crossing_counter) == ACCUMULATOR_TREE )
+    {
+      channel->number_of_crossings
+        = count_crossings_with_core( upper_layer );
+      update_channel_objectives( upper_layer );
+      return;
+    }
   // sort edges lexicographically based primarily on upper layer endpoints
-  Layerptr layer = layers[ upper_layer ];
+  Layerptr layer = CTX(layers)[ upper_layer ];
   int index = 0;                /* current index into edge array */
   int upper_position = 0;
-  for( ; upper_position < layer->number_of_nodes; upper_position++ )
+  for( ; upper_position < layer->node_count; upper_position++ )
     {
       Nodeptr node = layer->nodes[upper_position];
       sortByDownNodePosition( node->down_edges, node->down_degree );
-      add_edges_to_array( between_layers[ upper_layer ]->edges,
+      add_edges_to_array( channel->edges,
                           node->down_edges, node->down_degree, index );
       index += node->down_degree;
     }
   initialize_crossings( upper_layer );
-  between_layers[ upper_layer ]->number_of_crossings
-    = count_inversions_down( between_layers[ upper_layer ]->edges,
-                             between_layers[ upper_layer ]->number_of_edges,
-                             1 );
+  channel->number_of_crossings
+    = count_inversions_down( channel->edges, channel->edge_count, 1 );
+  update_channel_objectives( upper_layer );
+}
+
+/**
+ * @return the secondary key of the item at the given index of a master
+ * list; with randomize_order ties are broken randomly, otherwise in favor of
+ * the item that comes first in the list, as in a linear scan of the list
+ */
+static unsigned long tie_breaker( int index, int length )
+{
+  if ( OPTION(randomize_order) ) return genrand_int32();
+  return length - index;
+}
+
+/**
+ * Puts all unfixed nodes into the node queue with their current crossings
+ */
+static void fill_node_queue( void )
+{
+  pq_clear( CTX(node_queue) );
+  for ( int i = 0; i < CTX(number_of_nodes); i++ ) {
+    Nodeptr node = CTX(master_node_list)[i];
+    if ( isFixedNode( node ) ) continue;
+    pq_append( CTX(node_queue), node->id, numberOfCrossingsNode( node ),
+               tie_breaker( i, CTX(number_of_nodes) ) );
+  }
+  pq_heapify( CTX(node_queue) );
+}
+
+/**
+ * Puts all unfixed edges into the edge queue with their current crossings
+ */
+static void fill_edge_queue( void )
+{
+  pq_clear( CTX(edge_queue) );
+  for ( int i = 0; i < CTX(number_of_edges); i++ ) {
+    Edgeptr edge = CTX(master_edge_list)[i];
+    if ( isFixedEdge( edge ) ) continue;
+    pq_append( CTX(edge_queue), edge->id, edge->crossings,
+               tie_breaker( i, CTX(number_of_edges) ) );
+  }
+  pq_heapify( CTX(edge_queue) );
+}
+
+/**
+ * Brings the keys of the nodes on layers upper_layer - 1 and upper_layer
+ * and of the edges between them up to date after their crossings have been
+ * counted
+ */
+static void update_queue_keys( int upper_layer )
+{
+  if ( CTX(queue_updates_suspended) ) {
+    CTX(stale_queue_keys)[ upper_layer ] = true;
+    return;
+  }
+  if ( CTX(node_queue) != NULL ) {
+    for ( int layer = upper_layer - 1; layer <= upper_layer; layer++ ) {
+      Layerptr layer_ptr = CTX(layers)[ layer ];
+      for ( int i = 0; i < layer_ptr->node_count; i++ ) {
+        Nodeptr node = layer_ptr->nodes[i];
+        pq_update( CTX(node_queue), node->id, numberOfCrossingsNode( node ) );
+      }
+    }
+  }
+  if ( CTX(edge_queue) != NULL ) {
+    InterLayerptr channel = CTX(between_layers)[ upper_layer ];
+    for ( int i = 0; i < channel->edge_count; i++ ) {
+      Edgeptr edge = channel->edges[i];
+      pq_update( CTX(edge_queue), edge->id, edge->crossings );
+    }
+  }
+}
+
+/**
+ * Same as update_queue_keys() after the node now at new_position on the
+ * given layer, one of the two layers of the channel, moved there from
+ * old_position, passing over the nodes in between: only those nodes, their
+ * edges in the channel and the other endpoints of the edges have new keys
+ */
+static void adjust_queue_keys( int upper_layer, int layer,
+                               int old_position, int new_position )
+{
+  if ( CTX(queue_updates_suspended) ) {
+    CTX(stale_queue_keys)[ upper_layer ] = true;
+    return;
+  }
+  Nodeptr * nodes = CTX(layers)[ layer ]->nodes;
+  bool down = layer == upper_layer;
+  int first = old_position < new_position ? old_position : new_position;
+  int last = old_position < new_position ? new_position : old_position;
+  for ( int position = first; position <= last; position++ ) {
+    Nodeptr node = nodes[ position ];
+    if ( CTX(node_queue) != NULL )
+      pq_update( CTX(node_queue), node->id, numberOfCrossingsNode( node ) );
+    int degree = down ? node->down_degree : node->up_degree;
+    Edgeptr * edges = down ? node->down_edges : node->up_edges;
+    for ( int j = 0; j < degree; j++ ) {
+      Edgeptr edge = edges[j];
+      Nodeptr other = down ? edge->down_node : edge->up_node;
+      if ( CTX(node_queue) != NULL )
+        pq_update( CTX(node_queue), other->id,
+                   numberOfCrossingsNode( other ) );
+      if ( CTX(edge_queue) != NULL )
+        pq_update( CTX(edge_queue), edge->id, edge->crossings );
+    }
+  }
+}
+
+void suspendQueueUpdates( void )
+{
+  CTX(queue_updates_suspended) = true;
+}
+
+void resumeQueueUpdates( void )
+{
+  CTX(queue_updates_suspended) = false;
+  for ( int i = 1; i < CTX(number_of_layers); i++ ) {
+    if ( ! CTX(stale_queue_keys)[i] ) continue;
+    CTX(stale_queue_keys)[i] = false;
+    update_queue_keys( i );
+  }
+}
+
+/**
+ * A channel update writes only the crossings of the channel's edges, the
+ * down_crossings of nodes on its upper layer and the up_crossings of nodes
+ * on its lower layer. Channels i and i + 2 therefore have no nodes in
+ * common, and all odd numbered channels, followed by all even numbered
+ * ones, can be updated in parallel, by as many threads as OpenMP provides
+ * (-m sets that number, but some heuristics reset the option to 0 and
+ * still run other phases in parallel).
+ */
+void updateAllCrossings( void )
+{
+  updateAllPositions();
+  invalidateAllPairCrossings();
+  // channels are counted in parallel below
+  refreshAllPositions();
+  for( int parity = 1; parity <= 2; parity++ )
+    {
+      int i;
+#ifdef _OPENMP
+#pragma omp parallel for default(none) private(i) \
+  shared(parity) copyin(current_context) \
+  if(omp_get_max_threads() > 1) schedule(dynamic)
+#endif
+      for( i = parity; i < CTX(number_of_layers); i += 2 )
+        {
+          count_crossings_between_layers( i );
+        }
+    }
+  if ( CTX(node_queue) != NULL ) fill_node_queue();
+  if ( CTX(edge_queue) != NULL ) fill_edge_queue();
+}
+
+void updateCrossingsForLayer( int layer )
+{
+  updateNodePositions( layer );
+  invalidatePairCrossings( layer );
+  if( layer > 0 ) updateCrossingsBetweenLayers( layer );
+  if( layer < CTX(number_of_layers) - 1 )
+    updateCrossingsBetweenLayers( layer + 1 );
+}
+
+void updateCrossingsBetweenLayers( int upper_layer )
+{
+  count_crossings_between_layers( upper_layer );
+  update_queue_keys( upper_layer );
+}
+
+void adjustCrossingsForLayer( int layer, int old_position, int new_position,
+                              int down_change, int up_change )
+{
+  invalidatePairCrossings( layer );
+  if( layer > 0 )
+    {
+      CTX(between_layers)[ layer ]->number_of_crossings += down_change;
+      adjust_channel_objectives( layer, layer, old_position, new_position );
+      adjust_queue_keys( layer, layer, old_position, new_position );
+    }
+  if( layer < CTX(number_of_layers) - 1 )
+    {
+      CTX(between_layers)[ layer + 1 ]->number_of_crossings += up_change;
+      adjust_channel_objectives( layer + 1, layer,
+                                 old_position, new_position );
+      adjust_queue_keys( layer + 1, layer, old_position, new_position );
+    }
+}
+
+/**
+ * @return true if a recount of the channel gives the same total and maximum
+ * and the same crossings of edges and nodes as the ones currently recorded,
+ * and the recorded stretch of the channel is current; prints the
+ * differences on stderr otherwise. The recount uses scratch space only,
+ * so that nothing recorded changes and a checked run takes the same course
+ * as an unchecked one.
+ */
+static bool check_channel( int upper_layer )
+{
+  InterLayerptr channel = CTX(between_layers)[ upper_layer ];
+  refreshLayerPositions( upper_layer - 1 );
+  refreshLayerPositions( upper_layer );
+  const int32_t * position = CTX(graph_core)->position;
+  const int32_t * upper_order
+    = CTX(graph_core)->order + CTX(graph_core)->layer_start[ upper_layer ];
+  const int32_t * lower_order
+    = CTX(graph_core)->order + CTX(graph_core)->layer_start[ upper_layer - 1 ];
+  int upper_node_count = CTX(layers)[ upper_layer ]->node_count;
+  int lower_node_count = CTX(layers)[ upper_layer - 1 ]->node_count;
+
+  // gather the edges lexicographically based primarily on upper layer
+  // endpoints, without sorting the adjacency lists themselves
+  int32_t * edge_ids
+    = (int32_t *) malloc( ( channel->edge_count + 1 ) * sizeof(int32_t) );
+  int32_t * lower_ids
+    = (int32_t *) malloc( ( channel->edge_count + 1 ) * sizeof(int32_t) );
+  int index = 0;
+  for ( int i = 0; i < upper_node_count; i++ )
+    {
+      int32_t v = upper_order[i];
+      int first = index;
+      for ( int32_t k = CTX(graph_core)->down_start[v];
+            k < CTX(graph_core)->down_start[v + 1]; k++ )
+        {
+          int32_t edge_id = CTX(graph_core)->down_edge[k];
+          int32_t lower_id = CTX(graph_core)->down_neighbor[k];
+          int j = index - 1;
+          while ( j >= first && position[ lower_ids[j] ] > position[ lower_id ] )
+            {
+              edge_ids[j + 1] = edge_ids[j];
+              lower_ids[j + 1] = lower_ids[j];
+              j--;
+            }
+          edge_ids[j + 1] = edge_id;
+          lower_ids[j + 1] = lower_id;
+          index++;
+        }
+    }
+  for ( int i = 0; i < lower_node_count; i++ )
+    CTX(graph_core)->up_crossings[ lower_order[i] ] = 0;
+  int number_of_crossings
+    = count_crossings_accumulator( edge_ids, lower_ids, channel->edge_count,
+                                   lower_node_count,
+                                   channel->accumulator_tree,
+                                   channel->edges_before );
+
+  bool consistent = true;
+  if ( channel->number_of_crossings != number_of_crossings )
+    {
+      fprintf( stderr, "channel %d: recorded crossings = %d, actual = %d\n",
+               upper_layer, channel->number_of_crossings, number_of_crossings );
+      consistent = false;
+    }
+  const int32_t * edge_crossings = CTX(graph_core)->edge_crossings;
+  int max_crossings = 0;
+  index = 0;
+  for ( int i = 0; i < upper_node_count; i++ )
+    {
+      Nodeptr node = CTX(graph_core)->node_ptr[ upper_order[i] ];
+      int down_crossings = 0;
+      for ( int k = 0; k < node->down_degree; k++ )
+        {
+          Edgeptr edge = CTX(graph_core)->edge_ptr[ edge_ids[ index ] ];
+          int crossings = edge_crossings[ edge_ids[ index++ ] ];
+          down_crossings += crossings;
+          if ( crossings > max_crossings ) max_crossings = crossings;
+          if ( edge->crossings != crossings )
+            {
+              fprintf( stderr, "edge %s -> %s: recorded crossings = %d,"
+                       " actual = %d\n", NODE_NAME( edge->down_node ),
+                       NODE_NAME( edge->up_node ), edge->crossings,
+                       crossings );
+              consistent = false;
+            }
+        }
+      if ( node->down_crossings != down_crossings )
+        {
+          fprintf( stderr, "node %s: recorded down crossings = %d,"
+                   " actual = %d\n", NODE_NAME( node ),
+                   node->down_crossings, down_crossings );
+          consistent = false;
+        }
+    }
+  for ( int i = 0; i < lower_node_count; i++ )
+    {
+      Nodeptr node = CTX(graph_core)->node_ptr[ lower_order[i] ];
+      int up_crossings = CTX(graph_core)->up_crossings[ lower_order[i] ];
+      if ( node->up_crossings != up_crossings )
+        {
+          fprintf( stderr, "node %s: recorded up crossings = %d,"
+                   " actual = %d\n", NODE_NAME( node ),
+                   node->up_crossings, up_crossings );
+          consistent = false;
+        }
+    }
+  if ( channel->max_crossings != max_crossings )
+    {
+      fprintf( stderr, "channel %d: recorded max crossings = %d,"
+               " actual = %d\n", upper_layer, channel->max_crossings,
+               max_crossings );
+      consistent = false;
+    }
+  if ( CTX(channels) != NULL
+       && ( CTX(channels)[ upper_layer ]->stretch
+            != totalChannelStretch( upper_layer )
+            || CTX(channels)[ upper_layer ]->max_stretch
+            != maxEdgeStretchInChannel( upper_layer ) ) )
+    {
+      fprintf( stderr, "channel %d: recorded stretch = %f, max = %f;"
+               " actual = %f, max = %f\n", upper_layer,
+               CTX(channels)[ upper_layer ]->stretch,
+               CTX(channels)[ upper_layer ]->max_stretch,
+               totalChannelStretch( upper_layer ),
+               maxEdgeStretchInChannel( upper_layer ) );
+      consistent = false;
+    }
+  free( edge_ids );
+  free( lower_ids );
+  return consistent;
+}
+
+bool checkCrossingsForLayer( int layer )
+{
+  bool consistent = true;
+  if( layer > 0 && ! check_channel( layer ) ) consistent = false;
+  if( layer < CTX(number_of_layers) - 1 && ! check_channel( layer + 1 ) )
+    consistent = false;
+  return consistent;
+}
+
+void updateAllObjectives( void )
+{
+  for( int i = 1; i < CTX(number_of_layers); i++ )
+    {
+      update_channel_objectives( i );
+    }
+}
+
+void updatePositionsForLayer( int layer )
+{
+  Layerptr layer_ptr = CTX(layers)[ layer ];
+  for ( int i = 0; i < layer_ptr->node_count; i++ )
+    {
+      Nodeptr node = layer_ptr->nodes[i];
+      node->position = i;
+    }
+  layerOrderChanged( layer );
 }
 
 int maxCrossingsLayer( void ) {
   int max_crossings_layer = -1;
   int max_crossings = -1;
-  int * layer_sequence = (int *) malloc( number_of_layers * sizeof(int) );
-  for ( int i = 0; i < number_of_layers; i++ ) {
+  int * layer_sequence = (int *) malloc( CTX(number_of_layers) * sizeof(int) );
+  for ( int i = 0; i < CTX(number_of_layers); i++ ) {
     layer_sequence[i] = i;
   }
-  if ( randomize_order ) {
-    genrand_permute( layer_sequence, number_of_layers, sizeof(int) );
+  if ( OPTION(randomize_order) ) {
+    genrand_permute( layer_sequence, CTX(number_of_layers), sizeof(int) );
   }
-  for( int i = 0; i < number_of_layers; i++ ) {
+  for( int i = 0; i < CTX(number_of_layers); i++ ) {
     int layer = layer_sequence[i];
     if( numberOfCrossingsLayer( layer ) > max_crossings 
         && ! isFixedLayer( layer ) ) {
@@ -240,40 +852,53 @@ int maxCrossingsLayer( void ) {
 }
 
 Nodeptr maxCrossingsNode( void ) {
-  if ( randomize_order ) {
-    genrand_permute( master_node_list, number_of_nodes, sizeof(Nodeptr) );
+  if ( CTX(node_queue) == NULL ) {
+    CTX(node_queue) = pq_create( CTX(number_of_nodes) );
+    CTX(node_with_id)
+      = (Nodeptr *) malloc( CTX(number_of_nodes) * sizeof(Nodeptr) );
+    for ( int i = 0; i < CTX(number_of_nodes); i++ )
+      CTX(node_with_id)[ CTX(master_node_list)[i]->id ]
+        = CTX(master_node_list)[i];
+    fill_node_queue();
+  }
+  int id = pq_max( CTX(node_queue) );
+  while ( id >= 0 && isFixedNode( CTX(node_with_id)[id] ) ) {
+    pq_remove( CTX(node_queue), id );
+    id = pq_max( CTX(node_queue) );
   }
-  Nodeptr max_crossings_node = NULL;
-  int max_crossings = -1;
-  for ( int i = 0; i < number_of_nodes; i++ ) {
-    Nodeptr node = master_node_list[i];
 #ifdef DEBUG
-    printf( " loop: maxCrossingsNode, i =%d, node = %s\n", i, node->name );
+  if ( id >= 0 )
+    printf( " maxCrossingsNode, node = %s, crossings = %d\n",
+            NODE_NAME( CTX(node_with_id)[id] ),
+            numberOfCrossingsNode( CTX(node_with_id)[id] ) );
 #endif
-    if( numberOfCrossingsNode( node ) > max_crossings 
-        && ! isFixedNode( node) ) {
-      max_crossings = numberOfCrossingsNode( node );
-      max_crossings_node = node;
-    }
-  }
-  return max_crossings_node;
+  return id >= 0 ? CTX(node_with_id)[id] : NULL;
 }
 
 Edgeptr maxCrossingsEdge( void ) {
-  Edgeptr max_crossings_edge = NULL;
-  int max_crossings = -1;
-  if ( randomize_order ) {
-    genrand_permute( master_edge_list, number_of_edges, sizeof(Edgeptr) );
+  if ( CTX(edge_queue) == NULL ) {
+    CTX(edge_queue) = pq_create( CTX(number_of_edges) );
+    CTX(edge_with_id)
+      = (Edgeptr *) malloc( CTX(number_of_edges) * sizeof(Edgeptr) );
+    for ( int i = 0; i < CTX(number_of_edges); i++ )
+      CTX(edge_with_id)[ CTX(master_edge_list)[i]->id ]
+        = CTX(master_edge_list)[i];
+    fill_edge_queue();
   }
-  for ( int i = 0; i < number_of_edges; i++ ) {
-    Edgeptr edge = master_edge_list[i];
-    if( edge->crossings > max_crossings 
-        && ! isFixedEdge( edge ) ) {
-      max_crossings = edge->crossings;
-      max_crossings_edge = edge;
-    }
+  int id = pq_max( CTX(edge_queue) );
+  while ( id >= 0 && isFixedEdge( CTX(edge_with_id)[id] ) ) {
+    pq_remove( CTX(edge_queue), id );
+    id = pq_max( CTX(edge_queue) );
   }
-  return max_crossings_edge;
+  return id >= 0 ? CTX(edge_with_id)[id] : NULL;
+}
+
+void resetMaxCrossingsNode( void ) {
+  if ( CTX(node_queue) != NULL ) fill_node_queue();
+}
+
+void resetMaxCrossingsEdge( void ) {
+  if ( CTX(edge_queue) != NULL ) fill_edge_queue();
 }
 
 /**
@@ -287,8 +912,8 @@ Edgeptr maxCrossingsEdge( void ) {
 Edgeptr maxCrossingsEdgeStatic( void ) {
   Edgeptr max_crossings_edge = NULL;
   int max_crossings = -1;
-  for ( int i = 0; i < number_of_edges; i++ ) {
-    Edgeptr edge = master_edge_list[i];
+  for ( int i = 0; i < CTX(number_of_edges); i++ ) {
+    Edgeptr edge = CTX(master_edge_list)[i];
     if( edge->crossings > max_crossings ) { 
       max_crossings = edge->crossings;
       max_crossings_edge = edge;
@@ -302,13 +927,13 @@ Edgeptr maxCrossingsEdgeStatic( void ) {
  */
 static void print_down_crossings_nodes( int i )
 {
-  Layerptr layer = layers[ i ];
+  Layerptr layer = CTX(layers)[ i ];
   int j = 0;
-  for( ; j < layer->number_of_nodes; j++ )
+  for( ; j < layer->node_count; j++ )
     {
       Nodeptr node = layer->nodes[j];
       printf( "    %-10s layer = %3d, position = %3d, down_x = %3d\n",
-              node->name, node->layer, node->position, node->down_crossings );
+              NODE_NAME( node ), node->layer, node->position, node->down_crossings );
     }
 }
 
@@ -317,9 +942,9 @@ static void print_down_crossings_nodes( int i )
  */
 static void print_down_crossings_edges( int i )
 {
-  Layerptr layer = layers[ i ];
+  Layerptr layer = CTX(layers)[ i ];
   int j = 0;
-  for( ; j < layer->number_of_nodes; j++ )
+  for( ; j < layer->node_count; j++ )
     {
       Nodeptr node = layer->nodes[j];
       int edge_position = 0;
@@ -327,7 +952,7 @@ static void print_down_crossings_edges( int i )
         {
           Edgeptr edge = node->down_edges[ edge_position ];
           printf( " ::  %10s -> %10s has %4d crossings\n",
-                  edge->down_node->name, edge->up_node->name, edge->crossings );
+                  NODE_NAME( edge->down_node ), NODE_NAME( edge->up_node ), edge->crossings );
         }
     }
 }
@@ -337,13 +962,13 @@ static void print_down_crossings_edges( int i )
  */
 void print_up_crossings_nodes( int i )
 {
-  Layerptr layer = layers[ i ];
+  Layerptr layer = CTX(layers)[ i ];
   int j = 0;
-  for( ; j < layer->number_of_nodes; j++ )
+  for( ; j < layer->node_count; j++ )
     {
       Nodeptr node = layer->nodes[j];
       printf( "    %-10s layer = %3d, position = %3d,   up_x = %3d\n",
-              node->name, node->layer, node->position, node->up_crossings );
+              NODE_NAME( node ), node->layer, node->position, node->up_crossings );
     }
 }
 
@@ -353,7 +978,7 @@ void print_up_crossings_nodes( int i )
 void print_crossings_between_layers( int i )
 {
   printf( "  --- between layers %d and %d crossings = %3d\n",
-          i - 1, i, between_layers[i]->number_of_crossings );
+          i - 1, i, CTX(between_layers)[i]->number_of_crossings );
   printf( "    ___ upper nodes\n" );
   print_down_crossings_nodes( i );
   printf( "    ^^^ lower nodes\n" );
@@ -368,13 +993,13 @@ void printCrossings( void )
 {
   printf( "xxx total_crossings = %d\n", numberOfCrossings() );
   int i = 1;
-  for( ; i < number_of_layers; i++ )
+  for( ; i < CTX(number_of_layers); i++ )
     {
       print_crossings_between_layers( i );
     }
   printf("->-> edge crossings\n");
   i = 1;
-  for( ; i < number_of_layers; i++ )
+  for( ; i < CTX(number_of_layers); i++ )
     {
       print_down_crossings_edges( i );
     }
@@ -384,9 +1009,8 @@ void printCrossings( void )
 
 #include"graph_io.h"
 
-// the following are to avoid bringing in more modules than necessary
-int capture_iteration;
-int max_iterations;
+// the following are to avoid bringing in more modules than necessary; the
+// options are part of the run context
 void barycenterDownSweep(int layer) {}
 void barycenterUpSweep(int layer) {}
 
@@ -404,7 +1028,7 @@ int main( int argc, char * argv[] )
   for( ; node != NULL; node = maxCrossingsNode() )
     {
       printf( "max crossings node = %s, crossings = %d\n",
-              node->name, numberOfCrossingsNode( node ) );
+              NODE_NAME( node ), numberOfCrossingsNode( node ) );
       fixNode( node );
     }
   // test maximum crossings edge
@@ -414,7 +1038,7 @@ int main( int argc, char * argv[] )
   for( ; edge != NULL; edge = maxCrossingsEdge() )
     {
       printf( "max crossings edge: %s -> %s, crossings = %d\n",
-              edge->down_node->name, edge->up_node->name,
+              NODE_NAME( edge->down_node ), NODE_NAME( edge->up_node ),
               numberOfCrossingsEdge( edge ) );
       fixEdge( edge );
     }
@@ -433,4 +1057,4 @@ int main( int argc, char * argv[] )
 
 #endif
 
-/*  [Last modified: 2016 03 01 at 01:32:37 GMT] */
+/*  [Last modified: 2026 10 16 at 18:59:06 GMT] */
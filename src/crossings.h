@@ -21,13 +21,20 @@
  */
 void initCrossings( void );
 
+/**
+ * Deallocates the data structures created by initCrossings() and by the
+ * functions below, including graph_core
+ */
+void freeCrossings( void );
+
 /**
  * @return the total number of crossings in the graph
  */
 int numberOfCrossings( void );
 
 /**
- * @return the maximum number of crossings for any edge
+ * @return the maximum number of crossings for any edge; maintained per
+ * channel whenever crossings are updated
  */
 int maxEdgeCrossings( void );
 
@@ -44,7 +51,8 @@ int numberOfCrossingsNode( Nodeptr node );
 /**
  * Updates all crossings based on current ordering of nodes on each layer.
  * The position pointers for all nodes are made consistent as well, using
- * updateAllPositions() in the sorting module
+ * updateAllPositions() in the sorting module. When compiled with OpenMP and
+ * number_of_processors > 1, channels are counted in parallel.
  */
 void updateAllCrossings( void );
 
@@ -55,6 +63,39 @@ void updateAllCrossings( void );
  */
 void updateCrossingsForLayer( int layer );
 
+/**
+ * Brings crossing information up to date after the node now at new_position
+ * on the given layer has been moved there from old_position, passing over
+ * the nodes in between, and the crossings of the edges and nodes involved
+ * have already been adjusted, e.g., by change_pair_crossings(); the totals
+ * for the channels below and above the layer change by down_change and
+ * up_change, respectively. Positions must already be correct. This takes
+ * the place of updateCrossingsForLayer() when crossings are updated
+ * incrementally; only the nodes between the two positions, their edges and
+ * the other endpoints of the edges are looked at, along with the channel
+ * objectives and queue keys they affect.
+ */
+void adjustCrossingsForLayer( int layer, int old_position, int new_position,
+                              int down_change, int up_change );
+
+/**
+ * Recounts the crossings for the channels incident on the layer and
+ * compares the result with the crossings of channels, edges and nodes that
+ * are recorded, including the maximum and the stretch of each channel;
+ * differences are printed on stderr. The recorded crossings are left as
+ * they are.
+ * @return true if there are no differences
+ */
+bool checkCrossingsForLayer( int layer );
+
+/**
+ * Brings the per channel maximum edge crossings, stretch, and priority edge
+ * crossings up to date without recounting crossings; needed only when
+ * positions have been changed directly rather than via one of the update
+ * functions above, e.g., during swapping()
+ */
+void updateAllObjectives( void );
+
 /**
  * Updates crossings between two adjacent layers. Also updates the relevant
  * crossing fields and position fields of nodes for the two layers.
@@ -72,18 +113,37 @@ int maxCrossingsLayer( void );
 /**
  * @return A pointer to an unfixed node whose incident edges have the most
  * crossings, or NULL if all nodes are fixed. The layer and position of the
- * node are stored with it. When there are ties, bias is in favor of a node
- * not on the same layer as the most recent node chosen; this is to avoid a
- * lot of repeated sifting on the same layer.
+ * node are stored with it. Nodes are kept in a priority queue keyed on
+ * crossings; ties are broken randomly if randomize_order is set and in favor
+ * of the node that comes first in master_node_list otherwise.
  */
 Nodeptr maxCrossingsNode( void );
 
 /**
  * @return A pointer to an unfixed edge with the most crossings, or NULL if
- * all edges are fixed.
+ * all edges are fixed. Ties are broken as in maxCrossingsNode().
  */
 Edgeptr maxCrossingsEdge( void );
 
+/**
+ * Makes all unfixed nodes (edges) candidates for maxCrossingsNode()
+ * (maxCrossingsEdge()) again; must be called whenever fixed flags are
+ * cleared.
+ */
+void resetMaxCrossingsNode( void );
+void resetMaxCrossingsEdge( void );
+
+/**
+ * Between suspendQueueUpdates() and resumeQueueUpdates() the functions that
+ * update crossings only record which channels have changed and leave the
+ * queues used by maxCrossingsNode() and maxCrossingsEdge() alone; the
+ * queues are shared, so this is what allows nodes on layers at least two
+ * apart to be sifted concurrently. resumeQueueUpdates() brings the keys of
+ * the recorded channels up to date.
+ */
+void suspendQueueUpdates( void );
+void resumeQueueUpdates( void );
+
 /**
  * @return A pointer to an edge with the most crossings; ignores the current
  * status of the edge (fixed or not) and has no impact on the state of any
@@ -98,4 +158,4 @@ void printCrossings( void );
 
 #endif
 
-/*  [Last modified: 2016 05 19 at 20:23:37 GMT] */
+/*  [Last modified: 2026 10 16 at 18:59:06 GMT] */
@@ -12,8 +12,6 @@
 #include "graph.h"
 #include "dfs.h"
 
-static int preorder_number = 0;
-
 /**
  * Visits the given node, assigns it the next preorder number, and
  * recursively visits all unvisited adjacent nodes; edges to higher-numbered
@@ -27,12 +25,12 @@ static void dfs_visit( Nodeptr node );
 static void initialize_dfs_weights( void )
 {
   int layer = 0;
-  for( ; layer < number_of_layers; layer++ )
+  for( ; layer < CTX(number_of_layers); layer++ )
     {
       int position = 0;
-      for( ; position < layers[ layer ]->number_of_nodes; position++ )
+      for( ; position < CTX(layers)[ layer ]->node_count; position++ )
         {
-          Nodeptr node = layers[ layer ]->nodes[ position ];
+          Nodeptr node = CTX(layers)[ layer ]->nodes[ position ];
           node->weight = -1;
         }
     }
@@ -74,14 +72,14 @@ static void visit_lower_edges( Nodeptr node )
 static void dfs_visit( Nodeptr node )
 {
 #ifdef DEBUG
-  printf( "| ----> dfs_visit, node = %s\n", node->name );
+  printf( "| ----> dfs_visit, node = %s\n", NODE_NAME( node ) );
 #endif
-  node->weight = preorder_number++;
+  node->weight = CTX(preorder_number)++;
   visit_upper_edges( node );
   visit_lower_edges( node );
 #ifdef DEBUG
   printf( "<- | dfs_visit, node = %s, weight = %3.1f\n",
-          node->name, node->weight );
+          NODE_NAME( node ), node->weight );
 #endif
 }
 
@@ -93,22 +91,23 @@ static void dfs_visit( Nodeptr node )
  */
 static void dfs( void )
 {
-  preorder_number = 0;
+  CTX(preorder_number) = 0;
   int number_of_components = 0;
   int size_of_largest_component = 0;
   // traverse all nodes, starting a new dfs_visit for any node not yet
   // visited
-  for( int layer = 0; layer < number_of_layers; layer++ )
+  for( int layer = 0; layer < CTX(number_of_layers); layer++ )
     {
-      for( int position = 0; position < layers[ layer ]->number_of_nodes; position++ )
+      for( int position = 0;
+           position < CTX(layers)[ layer ]->node_count; position++ )
         {
-          Nodeptr node = layers[ layer ]->nodes[ position ];
+          Nodeptr node = CTX(layers)[ layer ]->nodes[ position ];
           if( node->weight == -1 )
             {
               number_of_components++;
-              int start_preorder_number = preorder_number;
+              int start_preorder_number = CTX(preorder_number);
               dfs_visit( node );
-              int end_preorder_number = preorder_number;
+              int end_preorder_number = CTX(preorder_number);
               int size_of_current_component
                 = end_preorder_number - start_preorder_number;
               if ( size_of_current_component > size_of_largest_component )
@@ -126,4 +125,4 @@ void assignDfsWeights( void )
   dfs();
 }
 
-/*  [Last modified: 2011 06 04 at 20:19:23 GMT] */
+/*  [Last modified: 2026 10 16 at 16:03:56 GMT] */
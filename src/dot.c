@@ -35,133 +35,116 @@
 #include"dot.h"
 #include"defs.h"
 
-#define MAX_MSG_LENGTH 512
-#define MAX_NAME_LENGTH 512
-
-static char error_message[MAX_MSG_LENGTH];
-static char graph_name[MAX_NAME_LENGTH];
-static int line_number = 1;
+// thread-local, so that different threads can read dot files at the same time
+static __thread char graph_name[MAX_NAME_LENGTH];
 
 /* -----------  UTILITY FUNCTIONS -------------- */
 
 /**
- * Prints the message in 'error_message' with the line number
- * @param fatal if true, program will exit (fatal error)
+ * Skips blanks and C and C++ style comments in the input, updating the line
+ * number.
+ * @return the character that ends the sequence of blanks and comments, or
+ * EOF; the input is positioned at that character
  */
-static void error( bool fatal )
+static int skip_blanks_and_comments( MappedInputptr in )
 {
-  fprintf( stderr, "Line %d: %s\n", line_number, error_message );
-  if( fatal ) exit( EXIT_FAILURE );
+  const char * position = in->position;
+  const char * end = in->end;
+  while ( position < end )
+    {
+      char ch = * position;
+      if ( ch == '\n' )
+        {
+          in->line_number++;
+          position++;
+        }
+      else if ( ch == ' ' || ch == '\t' || ch == '\r' )
+        position++;
+      else if ( ch == '/' && position + 1 < end && position[1] == '/' )
+        {
+          // C++ comment; the newline that ends it is counted above
+          while ( position < end && * position != '\n' ) position++;
+        }
+      else if ( ch == '/' && position + 1 < end && position[1] == '*' )
+        {
+          position += 2;
+          while ( position < end
+                  && ! ( * position == '*' && position + 1 < end
+                         && position[1] == '/' ) )
+            {
+              if ( * position == '\n' ) in->line_number++;
+              position++;
+            }
+          position = ( position < end ) ? position + 2 : end;
+        }
+      else
+        break;
+    }
+  in->position = position;
+  return ( position < end ) ? (unsigned char) * position : EOF;
 }
 
 /**
- * Skips blanks and comments in the input stream using a finite-state
- * machine. Also updates the line number when appropriate.
- * @param ch the starting character for the sequence, as provided by the
- * client
- * @return the character that ends the sequence of blanks and comments, to be
- * used by the client
+ * Scans an identifier, i.e., a (possibly empty) sequence of letters, digits
+ * and underscores
+ * @return the identifier; the input is positioned at the character after it
  */
-static int skip_blanks_and_comments( int ch, FILE * in_stream )
+static NameSlice scan_identifier( MappedInputptr in )
 {
-  enum state_type { BLANK, C_COMMENT, CPP_COMMENT, SLASH, STAR } state = BLANK;
-#ifdef DEBUG
-  printf( "-> skip_blanks_and_comments, ch = %d\n", ch ); 
-#endif
-  bool done = false;
-  while( ! done )
-    {
-      switch( ch ) {
-      case '\n':
-        line_number++;
-        if( state == CPP_COMMENT ) { state = BLANK; break; }
-      case ' ': case '\t': case '\r':
-        if( state == SLASH )
-          {
-            // the slash was not the beginning of a comment and therefore ends
-            // the sequence
-            ungetc( ch, in_stream );
-            ch = '/';
-            done = true;
-          }
-        else if( state == STAR ) state = C_COMMENT;
-        break;
-      case '/':
-        if( state == BLANK ) state = SLASH;
-        else if( state == SLASH ) state = CPP_COMMENT;
-        else if( state == STAR ) state = BLANK;
-        break;
-      case '*':
-        if( state == C_COMMENT ) state = STAR;
-        else if( state == SLASH ) state = C_COMMENT;
-        else if( state == STAR ) state = C_COMMENT;
-        else if( state == BLANK ) done = true;
-        break;
-      case EOF:
-        done = true;
-      default:
-        if( state == SLASH )
-          {
-            // the slash was not the beginning of a comment and therefore ends
-            // the sequence
-            ungetc( ch, in_stream );
-            ch = '/';
-            done = true;
-          }
-        else if( state == STAR ) state = C_COMMENT;
-        else if( state == BLANK ) done = true;
-        break;
-      } // end, switch
-#ifdef DEBUG
-      printf( " skipping, ch = %d, state = %d\n", ch, state );
-#endif      
-      if( ! done ) ch = getc( in_stream );
-    } // end, infinite loop
-#ifdef DEBUG
-  printf( "<- skip_blanks_and_comments, ch = %d\n", ch ); 
-#endif
-  return ch;
+  const char * start = in->position;
+  const char * position = start;
+  while ( position < in->end
+          && ( isalnum( (unsigned char) * position ) || * position == '_' ) )
+    position++;
+  in->position = position;
+  NameSlice identifier = { start, (int) ( position - start ) };
+  return identifier;
 }
 
 /**
- * Reads an identifier from the input stream into the buffer
- * @param ch the beginning of the identifier
- * @return the character after the identifier
+ * Scans a word, i.e., a sequence of non-blank characters, after skipping
+ * blanks (but not comments)
  */
-static char read_identifier( int ch, FILE * in, char * id_buf )
+static NameSlice scan_word( MappedInputptr in )
 {
-  int index = 0;
-  while( isalnum( ch ) || ch == '_' ) {
-    id_buf[ index++ ] = ch;
-    ch = getc( in );
-  }
-  id_buf[index] = '\0';
-  return ch;
+  const char * position = in->position;
+  while ( position < in->end && isspace( (unsigned char) * position ) )
+    {
+      if ( * position == '\n' ) in->line_number++;
+      position++;
+    }
+  const char * start = position;
+  while ( position < in->end && ! isspace( (unsigned char) * position ) )
+    position++;
+  in->position = position;
+  NameSlice word = { start, (int) ( position - start ) };
+  return word;
 }
 
 /* -----------  INPUT FUNCTIONS -------------- */
 
-void initDot( FILE * in )
+void initDot( MappedInputptr in )
 {
-  int ch = getc( in );
-  ch = skip_blanks_and_comments( ch, in );
+  skip_blanks_and_comments( in );
   /** @todo eventually will want to pick up the first comment */
-  ungetc( ch, in );
-  char digraph[MAX_NAME_LENGTH];
-  fscanf( in, "%s", digraph );
-  if( strcmp( digraph, "digraph" ) != 0 )
+  NameSlice digraph = scan_word( in );
+  if( digraph.length != 7 || strncmp( digraph.start, "digraph", 7 ) != 0 )
     {
-      sprintf( error_message, "expected 'digraph', got '%s'", digraph );
-      error( true );
+      inputError( in, "expected 'digraph', got '%.*s'",
+                  digraph.length, digraph.start );
+      exit( EXIT_FAILURE );
     }
-  fscanf( in, "%s", graph_name );
-  ch = getc( in );
-  ch = skip_blanks_and_comments( ch, in );
+  NameSlice name = scan_word( in );
+  int length = name.length < MAX_NAME_LENGTH ? name.length : MAX_NAME_LENGTH - 1;
+  memcpy( graph_name, name.start, length );
+  graph_name[ length ] = '\0';
+  int ch = skip_blanks_and_comments( in );
   if( ch != '{' )
     {
-      sprintf( error_message, "expected '{', got %c", ch );
-      error( true );
+      inputError( in, "expected '{', got %c", ch );
+      exit( EXIT_FAILURE );
     }
+  in->position++;
 }
 
 void getNameFromDotFile( char * buffer )
@@ -169,90 +152,111 @@ void getNameFromDotFile( char * buffer )
   strcpy( buffer, graph_name );
 }
 
-bool nextEdge( FILE * in, char * src_buf, char * dst_buf )
+bool nextEdge( MappedInputptr in, NameSlice * source, NameSlice * destination )
 {
-  char ch = getc( in );
-  ch = skip_blanks_and_comments( ch, in );
-  if( ch == EOF || ch == '}' ) return false;
-  ch = read_identifier( ch, in, src_buf ); 
-  if( ch == EOF )
+  int ch = skip_blanks_and_comments( in );
+  if( ch == EOF || ch == '}' )
+    {
+      if ( ch == '}' )
+        {
+          // comments after the closing brace still belong to the dot file
+          in->position++;
+          skip_blanks_and_comments( in );
+        }
+      return false;
+    }
+  * source = scan_identifier( in );
+  if( in->position == in->end )
     {
-      sprintf( error_message, "premature end of file" );
-      error( true );
+      inputError( in, "premature end of file" );
+      exit( EXIT_FAILURE );
     }
-  ch = skip_blanks_and_comments( ch, in );
-  int dash = ch;
-  int arrow_head = getc( in );
-  if( dash != '-' || arrow_head != '>' )
+  skip_blanks_and_comments( in );
+  if( in->end - in->position < 2
+      || in->position[0] != '-' || in->position[1] != '>' )
     {
-      sprintf( error_message, "expected '->', got '%c%c'", dash, arrow_head );
-      error( true );
+      inputError( in, "expected '->', got '%.*s'",
+                  (int) ( in->end - in->position < 2
+                          ? in->end - in->position : 2 ),
+                  in->position );
+      exit( EXIT_FAILURE );
     }
-  ch = getc( in );
-  ch = skip_blanks_and_comments( ch, in );
-  ch = read_identifier( ch, in, dst_buf ); 
-  if( ch == EOF )
+  in->position += 2;
+  skip_blanks_and_comments( in );
+  * destination = scan_identifier( in );
+  if( in->position == in->end )
     {
-      sprintf( error_message, "premature end of file" );
-      error( true );
+      inputError( in, "premature end of file" );
+      exit( EXIT_FAILURE );
     }
-  ch = skip_blanks_and_comments( ch, in );
+  ch = skip_blanks_and_comments( in );
   if( ch != ';' )
     {
-      sprintf( error_message, "expected ';', got '%c'", ch );
-      error( true );
+      inputError( in, "expected ';', got '%c'", ch );
+      exit( EXIT_FAILURE );
     }
+  in->position++;
   return true;
 }
 
 /* -----------  OUTPUT FUNCTIONS -------------- */
 
-void dotPreamble( FILE * out, const char * graph_name,
+void dotPreamble( OutputBufferptr out, const char * name_of_graph,
                    const char * seed_info )
 {
-  fprintf( out, "/* %s */\n", seed_info );
-  fprintf( out, "digraph %s {\n", graph_name );
+  appendFormatted( out, "/* %s */\n", seed_info );
+  appendFormatted( out, "digraph %s {\n", name_of_graph );
 }
 
-void endDot( FILE * out )
+void endDot( OutputBufferptr out )
 {
-  fprintf( out, "}\n" );
+  appendString( out, "}\n" );
 }
 
-void outputEdge( FILE * out, const char * src_name,
+void outputEdge( OutputBufferptr out, const char * src_name,
                  const char * dst_name )
 {
-  fprintf( out, " %s -> %s;\n", src_name, dst_name );
+  appendChar( out, ' ' );
+  appendString( out, src_name );
+  appendString( out, " -> " );
+  appendString( out, dst_name );
+  appendString( out, ";\n" );
 }
 
 #ifdef TEST
 
 /**
- * Test program: reads a dot file from standard input and sends it to
- * standard output.
+ * Test program: reads the dot file given on the command line and sends it
+ * to standard output.
  */
-static void test_dot()
+static void test_dot( const char * file_name )
 {
-  initDot( stdin );
-  char name_buf[100];
-  getName( name_buf );
+  MappedInputptr in = openMappedInput( file_name );
+  initDot( in );
+  char name_buf[MAX_NAME_LENGTH];
+  getNameFromDotFile( name_buf );
   fprintf( stderr, "name = %s\n", name_buf );
-  dotPreamble( stdout, name_buf, "seed" );
-  char src_buf[100];
-  char dst_buf[100];
-  while ( nextEdge( stdin, src_buf, dst_buf ) ) {
+  OutputBufferptr out = createOutputBuffer( stdout, false );
+  dotPreamble( out, name_buf, "seed" );
+  NameSlice src, dst;
+  while ( nextEdge( in, & src, & dst ) ) {
+    char src_buf[MAX_NAME_LENGTH];
+    char dst_buf[MAX_NAME_LENGTH];
+    sprintf( src_buf, "%.*s", src.length, src.start );
+    sprintf( dst_buf, "%.*s", dst.length, dst.start );
     fprintf( stderr, "src = %s, dst = %s\n", src_buf, dst_buf );
-    outputEdge( stdout, src_buf, dst_buf );
+    outputEdge( out, src_buf, dst_buf );
   }
-  endDot( stdout );
+  endDot( out );
+  writeOutputBuffer( out );
+  closeMappedInput( in );
 }
 
-int main()
+int main( int argc, char * argv[] )
 {
-  test_dot();
+  test_dot( argv[1] );
   return 0;
 }
-
 #endif
 
-/*  [Last modified: 2011 04 19 at 20:48:01 GMT] */
+/*  [Last modified: 2026 10 16 at 17:58:28 GMT] */
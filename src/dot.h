@@ -30,6 +30,8 @@
 
 #include<stdio.h>
 #include<stdbool.h>
+#include"mapped_input.h"
+#include"output_buffer.h"
 
 /* -----------  INPUT FUNCTIONS -------------- */
 
@@ -38,7 +40,7 @@
  * advances the input to the point where edges can be read.
  * NOTE: information in an initial comment is lost
  */
-void initDot( FILE * in );
+void initDot( MappedInputptr in );
 
 /**
  * Stores the name of the graph in the given buffer. Assumes the buffer is
@@ -47,47 +49,50 @@ void initDot( FILE * in );
 void getNameFromDotFile( char * buffer );
 
 /**
- * Reads the next edge from the input, storing the names of the vertices in
- * buffers. Assumes the buffers are large enough.
+ * Reads the next edge from the input; the names of the vertices are slices
+ * of the input, valid until it is closed. After the last edge the input is
+ * positioned after the closing brace and any comments that follow it, e.g.,
+ * at the start of an ord file that comes next in the same stream.
  * @return true if another edge was found.
  */
-bool nextEdge( FILE * in, char * source_buffer, char * destination_buffer );
+bool nextEdge( MappedInputptr in, NameSlice * source, NameSlice * destination );
 
-// The typical way to read a dot file from stream 'in' is ...
+// The typical way to read a dot file with name 'file_name' is ...
 //
+//     MappedInputptr in = openMappedInput( file_name );
 //     initDot( in );
 //     char name_buf[MAX_NAME_LENGTH];
-//     get_name( name_buf );
+//     getNameFromDotFile( name_buf );
 //     // do something with the name
-//     char src_buf[MAX_NAME_LENGTH];
-//     char dst_buf[MAX_NAME_LENGTH];
-//     while ( nextEdge( in, src_buf, dst_buf ) )
+//     NameSlice source, destination;
+//     while ( nextEdge( in, & source, & destination ) )
 //       {
 //         // do something with the edge
 //       }
+//     closeMappedInput( in );
 
 /* -----------  OUTPUT FUNCTIONS -------------- */
 
 /**
- * Writes the first part of a dot file to the output stream: comments about
+ * Writes the first part of a dot file to the output buffer: comments about
  * how the graph was created and seed information
  */
-void dotPreamble( FILE * out,
-                  const char * graph_name,
+void dotPreamble( OutputBufferptr out,
+                  const char * name_of_graph,
                   const char * initial_comment );
 
 /**
  * Writes the final '}'
  */
-void endDot( FILE * out );
+void endDot( OutputBufferptr out );
 
 /**
  * Writes the edge (src, dst) to the output
  */
-void outputEdge( FILE * out,
+void outputEdge( OutputBufferptr out,
                  const char * src, const char * dst );
 
 #endif
 
-/*  [Last modified: 2011 04 19 at 20:31:55 GMT] */
+/*  [Last modified: 2026 10 16 at 17:58:28 GMT] */
 
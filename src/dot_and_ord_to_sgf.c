@@ -65,29 +65,29 @@ static void printUsage( void ) {
  */
 static void write_sgf( void ) {
   printf( "t %s %d %d %d\n",
-           graph_name,
-           number_of_nodes,
-           number_of_edges,
-           number_of_layers
+           CTX(graph_name),
+           CTX(number_of_nodes),
+           CTX(number_of_edges),
+           CTX(number_of_layers)
            );
   
   // add lines for the nodes
-  for( int layer = 0; layer < number_of_layers; layer++ ) {
+  for( int layer = 0; layer < CTX(number_of_layers); layer++ ) {
     for( int position = 0;
-         position < layers[ layer ]->number_of_nodes;
+         position < CTX(layers)[ layer ]->node_count;
          position++ ) {
-      Nodeptr node = layers[ layer ]->nodes[ position ];
+      Nodeptr node = CTX(layers)[ layer ]->nodes[ position ];
       printf( "n %d %d %d\n", node->id, layer, position );
     }
   }
 
   // add lines for the edges
-  for( int layer = 0; layer < number_of_layers - 1; layer++ ) {
+  for( int layer = 0; layer < CTX(number_of_layers) - 1; layer++ ) {
     for(
         int node_position = 0;
-        node_position < layers[ layer ]->number_of_nodes;
+        node_position < CTX(layers)[ layer ]->node_count;
         node_position++ ) {
-      Nodeptr node = layers[ layer ]->nodes[ node_position ];
+      Nodeptr node = CTX(layers)[ layer ]->nodes[ node_position ];
       for( int edge_position = 0;
            edge_position < node->up_degree;
            edge_position++ ) {
@@ -113,4 +113,4 @@ int main( int argc, char * argv[] )
   return EXIT_SUCCESS;
 }
 
-/*  [Last modified: 2014 07 17 at 20:14:41 GMT] */
+/*  [Last modified: 2026 10 16 at 16:03:56 GMT] */
@@ -7,19 +7,21 @@
  * @date 2008/12/19
  * $Id: graph.h 90 2014-08-13 20:31:25Z mfms $
  *
- * Global data
+ * Global data (fields of the run context - see context.h)
  *  - number_of_layers
  *  - layers: an array of pointers to layer_struct's
  *  - graph_name: used for output
  * Layers are referred to by number except when internal info is needed.<br>
  * Nodes are referred to by pointers to node_struct's and all information
  * about a node (including layer and position) is stored in the struct.
+ * A compact view of the graph, indexed by node and edge id's, is
+ * maintained in graph_core.h for loops that would otherwise chase pointers.
  *
  * To traverse all the nodes of a graph, do the following; see also master_node_list:
  *
      for( int layer = 0; layer < number_of_layers; layer++ )
        {
-         for( int position = 0; position < layers[ layer ]->number_of_nodes; position++ )
+         for( int position = 0; position < layers[ layer ]->node_count; position++ )
            {
              Nodeptr node = layers[ layer ]->nodes[ position ];
              // do something with the node
@@ -33,7 +35,7 @@
     {
       for(
           int node_position = 0;
-          node_position < layers[ layer ]->number_of_nodes;
+          node_position < layers[ layer ]->node_count;
           node_position++ )
         {
           Nodeptr node = layers[ layer ]->nodes[ node_position ];
@@ -58,11 +60,13 @@ typedef struct node_struct * Nodeptr;
 typedef struct edge_struct * Edgeptr;
 typedef struct layer_struct * Layerptr;
 
+/**
+ * Fields are ordered so that the ones used in the inner loops of crossing
+ * counts, weight computations and sifting come first and the record fits
+ * in 56 bytes; the name of a node is kept in node_names - see NODE_NAME()
+ */
 struct node_struct
 {
-  char * name;
-  int id;                       /* unique identifier */
-  int layer;
   /**
    * position of the node within its layer; this is essential for correct
    * computation of crossings; it is automatically updated by the update
@@ -71,6 +75,7 @@ struct node_struct
    * crossings.
    */
   int position;
+  int layer;
   int up_degree;
   int down_degree;
 
@@ -82,28 +87,25 @@ struct node_struct
   double weight;
 
   // Added on 09-11-08 for max. crossings node heuristic
-  bool fixed;
   int up_crossings;
   int down_crossings;
-  
-  // for DFS
-  bool marked;
-  int preorder_number;
+
+  int id;                       /* unique identifier */
+  bool fixed;
 };
 
 #define DEGREE( node ) ( node->up_degree + node->down_degree )
 #define CROSSINGS( node ) ( node->up_crossings + node->down_crossings )
+#define NODE_NAME( node ) ( CTX(node_names)[ (node)->id ] )
 
 struct edge_struct {
   Nodeptr up_node;
   Nodeptr down_node;
+  int id;                       /* unique identifier */
   int crossings;
 
-  // for heuristics
-  /**
-   * true if edge has been processed in current iteration
-   */
-  bool fixed;
+  // for heuristics; whether an edge has been processed in the current
+  // iteration is recorded in graph_core - see isFixedEdge()
   /**
    * true if minimizing crossings for this edge should be given priority (not
    * used - instead, a list of priority edges is maintained)
@@ -112,14 +114,15 @@ struct edge_struct {
 };
 
 struct layer_struct {
-  int number_of_nodes;
+  int node_count;
   Nodeptr * nodes;
 
   // for algorithms that fix layers during an iteration
   bool fixed;
 };
 
-// The following are defined in graph_io.c
+// The following are read by graph_io.c; they are fields of the current
+// run context, see context.h
 
 /**
  * Allows nodes to be accessed randomly by their unique id #'s; not used for
@@ -127,21 +130,25 @@ struct layer_struct {
  *
  * @todo this and master_edge_list could really be useful for heuristics such
  * as mcn and mce.
+ *
+ *   Nodeptr * master_node_list;
+ *   Edgeptr * master_edge_list;
+ *
+ * node_names[i] is the name of the node whose id is i; names are needed
+ * only for input and output, so they are kept apart from the nodes
+ *
+ *   char ** node_names;
+ *
+ *   int number_of_layers;
+ *   int number_of_nodes;
+ *   int number_of_edges;
+ *   int number_of_isolated_nodes;
+ *   Layerptr * layers;
+ *   char graph_name[MAX_NAME_LENGTH];
  */
-extern Nodeptr * master_node_list;
-
-/**
- * @see master_node_list
- */
-extern Edgeptr * master_edge_list;
 
-extern int number_of_layers;
-extern int number_of_nodes;
-extern int number_of_edges;
-extern int number_of_isolated_nodes;
-extern Layerptr * layers;
-extern char graph_name[MAX_NAME_LENGTH];
+#include"context.h"
 
 #endif
 
-/*  [Last modified: 2016 02 15 at 16:44:04 GMT] */
+/*  [Last modified: 2026 10 16 at 16:03:56 GMT] */
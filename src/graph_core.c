@@ -0,0 +1,153 @@
+/**
+ * @file graph_core.c
+ * @brief Construction and maintenance of the structure-of-arrays view of
+ * the graph - see graph_core.h
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+#include"graph_core.h"
+#include"graph.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<assert.h>
+
+static int32_t * alloc_ids( int count )
+{
+  // count + 1 so that an empty array is never requested
+  return (int32_t *) calloc( count + 1, sizeof(int32_t) );
+}
+
+/**
+ * Fills the CSR arrays for one direction; start must have room for
+ * number_of_nodes + 1 entries
+ */
+static void build_adjacency( bool up, int32_t * start,
+                             int32_t * neighbor, int32_t * edge_ids )
+{
+  int32_t index = 0;
+  for ( int v = 0; v < CTX(number_of_nodes); v++ )
+    {
+      Nodeptr node = CTX(graph_core)->node_ptr[v];
+      int degree = up ? node->up_degree : node->down_degree;
+      Edgeptr * edges = up ? node->up_edges : node->down_edges;
+      start[v] = index;
+      for ( int i = 0; i < degree; i++ )
+        {
+          Edgeptr edge = edges[i];
+          neighbor[index] = up ? edge->up_node->id : edge->down_node->id;
+          edge_ids[index] = edge->id;
+          index++;
+        }
+    }
+  start[ CTX(number_of_nodes) ] = index;
+}
+
+void buildGraphCore( void )
+{
+  CTX(graph_core)
+    = (GraphCoreptr) calloc( 1, sizeof(struct graph_core_struct) );
+
+  CTX(graph_core)->node_ptr
+    = (Nodeptr *) calloc( CTX(number_of_nodes) + 1, sizeof(Nodeptr) );
+  for ( int i = 0; i < CTX(number_of_nodes); i++ )
+    {
+      Nodeptr node = CTX(master_node_list)[i];
+      assert( node->id >= 0 && node->id < CTX(number_of_nodes) );
+      CTX(graph_core)->node_ptr[ node->id ] = node;
+    }
+  CTX(graph_core)->edge_ptr
+    = (Edgeptr *) calloc( CTX(number_of_edges) + 1, sizeof(Edgeptr) );
+  for ( int i = 0; i < CTX(number_of_edges); i++ )
+    {
+      Edgeptr edge = CTX(master_edge_list)[i];
+      assert( edge->id >= 0 && edge->id < CTX(number_of_edges) );
+      CTX(graph_core)->edge_ptr[ edge->id ] = edge;
+    }
+
+  CTX(graph_core)->layer_start = alloc_ids( CTX(number_of_layers) );
+  int32_t total = 0;
+  for ( int layer = 0; layer < CTX(number_of_layers); layer++ )
+    {
+      CTX(graph_core)->layer_start[ layer ] = total;
+      total += CTX(layers)[ layer ]->node_count;
+    }
+  CTX(graph_core)->layer_start[ CTX(number_of_layers) ] = total;
+  CTX(graph_core)->order = alloc_ids( CTX(number_of_nodes) );
+  CTX(graph_core)->position = alloc_ids( CTX(number_of_nodes) );
+
+  CTX(graph_core)->up_start = alloc_ids( CTX(number_of_nodes) );
+  CTX(graph_core)->up_neighbor = alloc_ids( CTX(number_of_edges) );
+  CTX(graph_core)->up_edge = alloc_ids( CTX(number_of_edges) );
+  CTX(graph_core)->down_start = alloc_ids( CTX(number_of_nodes) );
+  CTX(graph_core)->down_neighbor = alloc_ids( CTX(number_of_edges) );
+  CTX(graph_core)->down_edge = alloc_ids( CTX(number_of_edges) );
+  build_adjacency( true, CTX(graph_core)->up_start,
+                   CTX(graph_core)->up_neighbor, CTX(graph_core)->up_edge );
+  build_adjacency( false, CTX(graph_core)->down_start,
+                   CTX(graph_core)->down_neighbor, CTX(graph_core)->down_edge );
+
+  CTX(graph_core)->edge_crossings = alloc_ids( CTX(number_of_edges) );
+  CTX(graph_core)->edge_fixed
+    = (bool *) calloc( CTX(number_of_edges) + 1, sizeof(bool) );
+  CTX(graph_core)->up_crossings = alloc_ids( CTX(number_of_nodes) );
+
+  CTX(graph_core)->stale_positions
+    = (bool *) calloc( CTX(number_of_layers), sizeof(bool) );
+  for ( int layer = 0; layer < CTX(number_of_layers); layer++ )
+    CTX(graph_core)->stale_positions[ layer ] = true;
+  refreshAllPositions();
+}
+
+void freeGraphCore( void )
+{
+  if ( CTX(graph_core) == NULL ) return;
+  free( CTX(graph_core)->node_ptr );
+  free( CTX(graph_core)->edge_ptr );
+  free( CTX(graph_core)->layer_start );
+  free( CTX(graph_core)->order );
+  free( CTX(graph_core)->position );
+  free( CTX(graph_core)->up_start );
+  free( CTX(graph_core)->up_neighbor );
+  free( CTX(graph_core)->up_edge );
+  free( CTX(graph_core)->down_start );
+  free( CTX(graph_core)->down_neighbor );
+  free( CTX(graph_core)->down_edge );
+  free( CTX(graph_core)->edge_crossings );
+  free( CTX(graph_core)->edge_fixed );
+  free( CTX(graph_core)->up_crossings );
+  free( CTX(graph_core)->stale_positions );
+  free( CTX(graph_core) );
+  CTX(graph_core) = NULL;
+}
+
+void layerPositionsChanged( int layer )
+{
+  if ( CTX(graph_core) == NULL ) return;
+  CTX(graph_core)->stale_positions[ layer ] = true;
+}
+
+void refreshLayerPositions( int layer )
+{
+  if ( ! CTX(graph_core)->stale_positions[ layer ] ) return;
+  Layerptr layerptr = CTX(layers)[ layer ];
+  int32_t * order
+    = CTX(graph_core)->order + CTX(graph_core)->layer_start[ layer ];
+  for ( int i = 0; i < layerptr->node_count; i++ )
+    {
+      Nodeptr node = layerptr->nodes[i];
+      order[i] = node->id;
+      CTX(graph_core)->position[ node->id ] = node->position;
+    }
+  CTX(graph_core)->stale_positions[ layer ] = false;
+}
+
+void refreshAllPositions( void )
+{
+  for ( int layer = 0; layer < CTX(number_of_layers); layer++ )
+    refreshLayerPositions( layer );
+}
+
+/*  [Last modified: 2026 10 16 at 16:51:03 GMT] */
@@ -0,0 +1,116 @@
+/**
+ * @file graph_core.h
+ * @brief A compact, structure-of-arrays view of the layered graph in
+ * graph.h, for the loops (crossing counts, barycenter and median weights)
+ * that would otherwise chase node and edge pointers.
+ *
+ * Nodes and edges are identified by their id's, which are 0,...,n-1 and
+ * 0,...,m-1, respectively. The adjacency lists are stored in compressed
+ * sparse row (CSR) form: the down neighbors of node v are
+ *   down_neighbor[ down_start[v] ], ..., down_neighbor[ down_start[v+1] - 1 ]
+ * and the corresponding edges are in down_edge; similarly for up neighbors.
+ *
+ * Positions are mirrored lazily: layerPositionsChanged() marks a layer
+ * whose order has changed and refreshLayerPositions() brings the layer's
+ * entries of order and position up to date. Since a refresh writes to the
+ * core, code that runs on several layers in parallel must call
+ * refreshAllPositions() first; a thread may then refresh only a layer that
+ * it changed itself.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+#ifndef GRAPH_CORE_H
+#define GRAPH_CORE_H
+
+#include<stdbool.h>
+#include<stdint.h>
+#include"graph.h"
+
+typedef struct graph_core_struct {
+  /**
+   * the nodes of layer i, in order of position, are
+   * order[ layer_start[i] ], ..., order[ layer_start[i+1] - 1 ]
+   */
+  int32_t * layer_start;
+  int32_t * order;
+  /**
+   * position[v] is the position of node v within its layer
+   */
+  int32_t * position;
+
+  int32_t * up_start;
+  int32_t * up_neighbor;
+  int32_t * up_edge;
+  int32_t * down_start;
+  int32_t * down_neighbor;
+  int32_t * down_edge;
+
+  /**
+   * edge_crossings[e] is the number of crossings of edge e as of the last
+   * time its channel was counted by the accumulator tree; incremental
+   * updates by sifting change only the crossings field of the edge
+   */
+  int32_t * edge_crossings;
+  /**
+   * edge_fixed[e] is true if edge e has been fixed by a heuristic; these
+   * are the only fixed flags for edges - see isFixedEdge()
+   */
+  bool * edge_fixed;
+
+  /**
+   * scratch space for the up crossings of the lower nodes of a channel,
+   * indexed by node id
+   */
+  int32_t * up_crossings;
+
+  /**
+   * the records that correspond to the id's, for writing results back
+   */
+  Nodeptr * node_ptr;
+  Edgeptr * edge_ptr;
+
+  /**
+   * stale_positions[i] is true if order and position are out of date for
+   * layer i
+   */
+  bool * stale_positions;
+} * GraphCoreptr;
+
+/**
+ * The core of the current graph is part of the run context - see context.h
+ *
+ *   GraphCoreptr graph_core;
+ */
+
+/**
+ * Creates graph_core from the current graph; assumes that the graph has
+ * been read - @see readGraph()
+ */
+void buildGraphCore( void );
+
+/**
+ * Deallocates graph_core; the graph itself is not affected
+ */
+void freeGraphCore( void );
+
+/**
+ * Records that the order of the given layer has changed; called by
+ * layerOrderChanged()
+ */
+void layerPositionsChanged( int layer );
+
+/**
+ * Brings order and position up to date for the given layer
+ */
+void refreshLayerPositions( int layer );
+
+/**
+ * Brings order and position up to date for all layers
+ */
+void refreshAllPositions( void );
+
+#endif
+
+/*  [Last modified: 2026 10 16 at 16:51:03 GMT] */
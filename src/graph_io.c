@@ -9,63 +9,120 @@
  */
 
 #include"graph.h"
+#include"graph_io.h"
 #include"hash.h"
 #include"defs.h"
 #include"dot.h"
 #include"ord.h"
+#include"sgf.h"
+#include"snapshot.h"
+#include"graph_core.h"
+#include"order.h"
 #include"min_crossings.h"
+#include"arena.h"
+#include"output_buffer.h"
 
 #include<stdio.h>
 #include<stdlib.h>
 #include<string.h>
 #include<assert.h>
+#include<ctype.h>
+#include<stdint.h>
 
 #define MIN_LAYER_CAPACITY 1 
 
-Nodeptr * master_node_list;
-Edgeptr * master_edge_list;
-int number_of_nodes = 0;
-int number_of_layers = 0;
-int number_of_edges = 0;
-int number_of_isolated_nodes = 0;
-Layerptr * layers = NULL;
-char graph_name[MAX_NAME_LENGTH];
+// The graph and the state of reading it are part of the run context - see
+// context.h
 
-// initial allocated size of layer array (will double as needed)
-static int layer_capacity = MIN_LAYER_CAPACITY;
+// CTX(layer_capacity) is the allocated size of the layer array (it doubles
+// as needed)
 
-// The input algorithm is as follows:
-//   1. Read the ord file (first pass) and
+/**
+ * Initial size of the blocks of graph_arena; later blocks are larger
+ */
+#define GRAPH_ARENA_BLOCK_SIZE ( 1 << 16 )
+
+/**
+ * Initial size of the hash table that maps node names to nodes; it grows
+ * as the nodes are read
+ */
+#define MIN_HASH_TABLE_ENTRIES 1024
+
+/**
+ * CTX(graph_arena) owns all records and arrays of the graph except the
+ * layers array, which grows as layers are read; released by freeGraph()
+ */
+
+/**
+ * Node records are handed out by makeNode() from chunks allocated in
+ * graph_arena; CTX(node_records) points to the next free record of the
+ * current chunk, which has CTX(node_records_left) records left. The edge
+ * records, CTX(edge_records), are allocated in one piece once their number
+ * is known; addEdge() hands them out in order.
+ */
+
+/**
+ * The first chunk of node records has this many records; each chunk is
+ * twice as large as the previous one, up to MAX_NODE_CHUNK
+ */
+#define MIN_NODE_CHUNK 1024
+#define MAX_NODE_CHUNK ( 1 << 16 )
+
+/**
+ * CTX(node_capacity) is the allocated size of node_names and
+ * master_node_list while the ord file is read; both grow as needed and are
+ * moved to graph_arena at the end
+ */
+
+/**
+ * CTX(snapshot_input) is the snapshot file that the graph was read from,
+ * if any; the node names are part of it, so it stays mapped until
+ * freeGraph()
+ */
+
+// CTX(next_node_id) and CTX(next_edge_id) are the id's of the next node
+// and edge to be created
+
+// The input algorithm reads each file once:
+//   1. Read the ord file and
 //       (a) create each layer and expand the 'layers' array as needed
-//       (b) count the number of nodes on each layer and store in
-//           'number_of_nodes'; also count the global number of nodes
-//       (c) allocate the 'nodes' array for each layer
-//   2. Read the ord file again and 
-//       (a) create each node
-//       (b) add each node to the appropriate layer
-//   3. Read the dot file (first pass) and
-//       (a) count the 'up_degree' and 'down_degree' of each node
-//       (b) go through all the nodes and allocate the 'up_edges' and
-//           the 'down_edges'
-//       (c) reset 'up_degree' and 'down_degree' to 0 so that edges can
-//           be put in the right positions on the second pass 
-//   4. Read the dot file again and put the nodes into the adjacency lists
-//      based on the edges
+//       (b) create each node, map its name to its record and count it on
+//           its layer; node_names and master_node_list grow as needed
+//   2. Allocate the 'nodes' array for each layer and copy the nodes from
+//      master_node_list, where the nodes of each layer are consecutive
+//   3. Read the dot file and for each edge
+//       (a) look up its endpoints and check that they are on adjacent layers
+//       (b) count the 'up_degree' and 'down_degree' of the endpoints
+//       (c) save the edge as a pair of node id's, upper node first
+//   4. Go through all the nodes and allocate the 'up_edges' and the
+//      'down_edges' as consecutive pieces of a single array; reset
+//      'up_degree' and 'down_degree' to 0
+//   5. Create the edges from the saved pairs, in the order of the dot file,
+//      and put them into the adjacency lists, i.e., a counting sort of the
+//      edges by endpoint
+//
+// An sgf file has the nodes, with their layers and positions, and the edges
+// in one file; steps 1 and 3 are done as its lines are read and step 2
+// afterwards, when the nodes are also renumbered in order of layer and
+// position, the way they would be numbered if read from an ord file.
 //
-// Note: The last phase ignores directions of the edges in the dot file and
-// only looks at layer information to determine 'up' and 'down' edges for
-// each node. For example, if a->b in the dot file and a is on layer 1 while
-// b is on layer 0, then the edge is an up-edge for b and a down-edge for a.
+// Note: The dot file phase ignores directions of the edges in the dot file
+// and only looks at layer information to determine 'up' and 'down' edges
+// for each node. For example, if a->b in the dot file and a is on layer 1
+// while b is on layer 0, then the edge is an up-edge for b and a down-edge
+// for a.
 
 /**
  * Creates a new node and maps its name to (a pointer to) its record
- * @param name the name of the node
+ * @param name the name of the node, name[0], ..., name[length - 1]; need not
+ * be terminated by '\0'
  * @return (a pointer to) the newly created node
  */
-Nodeptr makeNode( const char * name );
+Nodeptr makeNode( const char * name, int length );
 
 /**
- * Put a node in the next available position on a given layer
+ * Put a node in the next available position on a given layer; the nodes
+ * of a layer must be created consecutively
  */
 void addNodeToLayer( Nodeptr node, int layer );
 
@@ -76,127 +133,140 @@ void addNodeToLayer( Nodeptr node, int layer );
 void makeLayer();
 
 /**
- * Adds an edge to the graph. The edge comes directly from the dot
- * file. Although instances usually direct edges from lower to higher layers,
- * no such assumption is made here.  A fatal error occurs if the nodes are
- * not on adjacent layers.
+ * Adds an edge between two nodes on adjacent layers to the graph; there
+ * must be room for it in the adjacency lists of its endpoints.
  */
-void addEdge( const char * name1, const char * name2 );
+void addEdge( Nodeptr upper_node, Nodeptr lower_node );
 
-Nodeptr makeNode( const char * name )
+/**
+ * @return the array, reallocated with twice the capacity (or
+ * CAPACITY_INCREMENT elements if it is empty); capacity is updated
+ */
+static void * grow_array( void * array, int * capacity, size_t element_size )
 {
-  static int current_id = 0;
+  int new_capacity
+    = ( * capacity == 0 ) ? CAPACITY_INCREMENT : 2 * ( * capacity );
+  array = realloc( array, (size_t) new_capacity * element_size );
+  if ( array == NULL )
+    {
+      fprintf( stderr, "FATAL: unable to allocate %d elements of size %zu\n",
+               new_capacity, element_size );
+      abort();
+    }
+  * capacity = new_capacity;
+  return array;
+}
 
-  Nodeptr new_node = (Nodeptr) malloc( sizeof(struct node_struct));
-  new_node->name = (char *) malloc( strlen(name) + 1 );
-  strcpy( new_node->name, name );
+Nodeptr makeNode( const char * name, int length )
+{
+  if ( CTX(node_records_left) == 0 )
+    {
+      int chunk = CTX(next_node_id) < MIN_NODE_CHUNK
+        ? MIN_NODE_CHUNK : CTX(next_node_id);
+      if ( chunk > MAX_NODE_CHUNK ) chunk = MAX_NODE_CHUNK;
+      CTX(node_records)
+        = (struct node_struct *) arena_alloc( CTX(graph_arena),
+                                              chunk * sizeof(struct node_struct) );
+      CTX(node_records_left) = chunk;
+    }
+  if ( CTX(next_node_id) == CTX(node_capacity) )
+    {
+      int capacity = CTX(node_capacity);
+      CTX(node_names) = (char **) grow_array( CTX(node_names), & capacity,
+                                         sizeof(char *) );
+      CTX(master_node_list) = (Nodeptr *) grow_array( CTX(master_node_list),
+                                                 & CTX(node_capacity),
+                                                 sizeof(Nodeptr) );
+    }
+  Nodeptr new_node = CTX(node_records)++;
+  CTX(node_records_left)--;
   // delay assignment of id's until edges are added so that the numbering
   // depends on .dot file only (easier to standardize)
-  new_node->id = current_id++;
+  new_node->id = CTX(next_node_id)++;
   new_node->layer = new_node->position = -1; /* to indicate "uninitialized" */
   new_node->up_degree = new_node->down_degree = 0;
   new_node->up_edges = new_node->down_edges = NULL;
   new_node->up_crossings = new_node->down_crossings = 0;
-  new_node->marked = new_node->fixed = false;
-  new_node->preorder_number = -1;
-  insertInHashTable( name, new_node );
-  master_node_list[ new_node->id ] = new_node;
+  new_node->fixed = false;
+  CTX(node_names)[ new_node->id ] = insertInHashTable( name, length, new_node );
+  CTX(master_node_list)[ new_node->id ] = new_node;
   return new_node;
 }
 
 void addNodeToLayer( Nodeptr node, int layer )
 {
-  static int current_layer = 0;
-  static int current_position = 0;
-  if( layer != current_layer )
-    {
-      current_layer = layer;
-      current_position = 0;
-    }
-  node->layer = current_layer;
-  node->position = current_position;
-  layers[ layer ]->nodes[ current_position++ ] = node;
+  node->layer = layer;
+  node->position = CTX(layers)[ layer ]->node_count++;
 }
 
 void makeLayer()
 {
-  Layerptr new_layer = (Layerptr) malloc( sizeof(struct layer_struct) );
-  new_layer->number_of_nodes = 0;
+  Layerptr new_layer
+    = (Layerptr) arena_alloc( CTX(graph_arena), sizeof(struct layer_struct) );
+  new_layer->node_count = 0;
   new_layer->nodes = NULL;
-  if( number_of_layers >= layer_capacity )
+  if( CTX(number_of_layers) >= CTX(layer_capacity) )
     {
-      layer_capacity *= 2;
-      layers
-        = (Layerptr *) realloc( layers, layer_capacity * sizeof(Layerptr) );
+      CTX(layer_capacity) *= 2;
+      CTX(layers)
+        = (Layerptr *) realloc( CTX(layers),
+                                CTX(layer_capacity) * sizeof(Layerptr) );
     }
-  layers[ number_of_layers++ ] = new_layer;
+  CTX(layers)[ CTX(number_of_layers)++ ] = new_layer;
 }
 
-void addEdge( const char * name1, const char * name2 )
+void addEdge( Nodeptr upper_node, Nodeptr lower_node )
 {
-  static int num_edges_so_far = 0;
-  Nodeptr node1 = getFromHashTable( name1 );
-  Nodeptr node2 = getFromHashTable( name2 );
-  if ( node1->layer == node2->layer ) {
-    fprintf( stderr, "FATAL: addEdge, nodes on same layer.\n" );
-    fprintf( stderr, " Nodes %s and %s are on layer %d.\n",
-             node1->name, node2->name, node1->layer);
-    abort();
-  }
-
-  // a warning about missing nodes was already issued in the first pass
-  if ( node1 == NULL || node2 == NULL ) return;
-
-  Nodeptr upper_node
-    = ( node1->layer > node2->layer ) ? node1 : node2;
-  Nodeptr lower_node
-    = ( node1->layer < node2->layer ) ? node1 : node2;
-  if ( upper_node->layer - lower_node->layer != 1 ) {
-      fprintf( stderr, "FATAL: addEdge, nodes not on adjacent layers.\n" );
-      fprintf( stderr, " Nodes %s is on layer %d and %s is on layer %d.\n",
-               upper_node->name, upper_node->layer,
-               lower_node->name, lower_node->layer);
-      abort();
-  }
-  Edgeptr new_edge = malloc( sizeof(struct edge_struct) );
+  Edgeptr new_edge = & CTX(edge_records)[ CTX(next_edge_id) ];
   new_edge->up_node = upper_node;
   new_edge->down_node = lower_node;
-  new_edge->fixed = false;
+  new_edge->id = CTX(next_edge_id);
   upper_node->down_edges[ upper_node->down_degree++ ] = new_edge;
   lower_node->up_edges[ lower_node->up_degree++ ] = new_edge;
-  master_edge_list[ num_edges_so_far++ ] = new_edge;
+  CTX(master_edge_list)[ CTX(next_edge_id)++ ] = new_edge;
 }
 
 /**
- * Sets number of nodes for the layer and allocates space for them. Note: the
- * global number of nodes is updated in allocateLayers().
+ * @return an array of count pointers in graph_arena with the same content
+ * as the given one, which is deallocated
  */
-static void setNumberOfNodes( int layer, int number )
+static void * move_to_arena( void * array, int count, size_t element_size )
 {
-  layers[ layer ]->number_of_nodes = number;
-  layers[ layer ]->nodes = (Nodeptr *) calloc( number, sizeof(Nodeptr) );
+  void * copy = arena_alloc( CTX(graph_arena), count * element_size );
+  if ( count > 0 ) memcpy( copy, array, count * element_size );
+  free( array );
+  return copy;
 }
 
 /**
- * Implements the first pass of reading the ord file: allocates a record for
- * each layer and space for the nodes on each layer. Creates the nodes
- * and maps their names to (pointers to) their records. Counts the total
- * number of nodes.
+ * @return the input file with the given name; a fatal error occurs if it
+ * cannot be opened
  */
-static void allocateLayers( const char * ord_file )
+static MappedInputptr openInputFile( const char * file_name )
 {
-  FILE * in = fopen( ord_file, "r" );
+  MappedInputptr in = openMappedInput( file_name );
   if( in == NULL )
     {
-      fprintf( stderr, "Unable to open file %s for input\n", ord_file );
+      fprintf( stderr, "Unable to open file %s for input\n", file_name );
       exit( EXIT_FAILURE );
     }
-  layer_capacity = MIN_LAYER_CAPACITY;
-  layers = (Layerptr *) calloc( layer_capacity, sizeof(Layerptr) );
+  return in;
+}
+
+/**
+ * Reads an ord file, or what is left of the input: creates the layers and
+ * the nodes and maps the names of the nodes to (pointers to) their
+ * records; then allocates space for the nodes on each layer and puts them
+ * there.
+ */
+static void readOrdInput( MappedInputptr in )
+{
+  CTX(layer_capacity) = MIN_LAYER_CAPACITY;
+  CTX(layers) = (Layerptr *) calloc( CTX(layer_capacity), sizeof(Layerptr) );
 
   int layer;
   int expected_layer = 0;
-  char name_buf[MAX_NAME_LENGTH];
+  NameSlice name;
   while ( nextLayer( in, & layer ) )
     {
       if( layer != expected_layer )
@@ -207,123 +277,309 @@ static void allocateLayers( const char * ord_file )
         }
       expected_layer++;
       makeLayer();
-      int node_count = 0;
-      while ( nextNode( in, name_buf ) )
+      while ( nextNode( in, & name ) )
         {
-          node_count++;
-          number_of_nodes++;    /* global node count */
+          Nodeptr node = makeNode( name.start, name.length );
+          addNodeToLayer( node, layer );
         }
-      setNumberOfNodes( layer, node_count );
-  }
-  fclose( in );
+    }
+
+  CTX(number_of_nodes) = CTX(next_node_id);
+  CTX(master_node_list)
+    = (Nodeptr *) move_to_arena( CTX(master_node_list), CTX(number_of_nodes),
+                                 sizeof(Nodeptr) );
+  CTX(node_names)
+    = (char **) move_to_arena( CTX(node_names), CTX(number_of_nodes),
+                               sizeof(char *) );
+  CTX(node_capacity) = 0;
+  Nodeptr * layer_nodes = CTX(master_node_list);
+  for ( layer = 0; layer < CTX(number_of_layers); layer++ )
+    {
+      int node_count = CTX(layers)[ layer ]->node_count;
+      CTX(layers)[ layer ]->nodes
+        = (Nodeptr *) arena_alloc( CTX(graph_arena),
+                                   node_count * sizeof(Nodeptr) );
+      if ( node_count > 0 )
+        memcpy( CTX(layers)[ layer ]->nodes, layer_nodes,
+                node_count * sizeof(Nodeptr) );
+      layer_nodes += node_count;
+    }
 }
 
 /**
- * Reads the ord file and put the nodes on their appropriate layers
+ * @return the node with the given name, which is an endpoint of the edge
+ * from source to target; a fatal error occurs if there is no such node
+ * @param node_file the kind of file the nodes come from, ".ord" or ".sgf"
  */
-static void assignNodesToLayers( const char * ord_file )
+static Nodeptr edgeEndpoint( NameSlice name,
+                             NameSlice source, NameSlice target,
+                             const char * node_file )
 {
-  FILE * in = fopen( ord_file, "r" );
-  int layer;
-  char name_buf[MAX_NAME_LENGTH];
-  while( nextLayer( in, & layer ) )
+  Nodeptr node = getFromHashTableWithLength( name.start, name.length );
+  if( node == NULL )
     {
-      while( nextNode( in, name_buf ) )
-        {
-          Nodeptr node = makeNode( name_buf );
-          addNodeToLayer( node, layer );
-        }
+      fprintf( stderr, "Fatal error: Node '%.*s' does not exist in %s file\n"
+               " edge is %.*s->%.*s\n", name.length, name.start, node_file,
+               source.length, source.start, target.length, target.start );
+      abort();
     }
-  fclose( in );
+  return node;
 }
 
 /**
- * Increments the degrees of the endpoints of an edge between name1 and name2
+ * Edges as they are read: pairs of node id's, upper node first, in the
+ * order of the input; they are turned into edge records by createEdges()
  */
-void incrementDegrees( const char * name1, const char * name2 )
+typedef struct saved_edges {
+  int32_t * endpoints;
+  int capacity;
+} SavedEdges;
+
+/**
+ * Checks that the endpoints of an edge are on adjacent layers, updates the
+ * appropriate degree for each and saves their id's
+ */
+static void saveEdge( SavedEdges * saved, Nodeptr node1, Nodeptr node2 )
 {
-  Nodeptr node1 = getFromHashTable( name1 );
-  if( node1 == NULL )
-    {
-      fprintf( stderr, "Fatal error: Node '%s' does not exist in .ord file\n"
-               " edge is %s->%s\n", name1, name1, name2);
-      abort();
-    }
-  Nodeptr node2 = getFromHashTable( name2 );
-  if( node2 == NULL )
-    {
-      fprintf( stderr, "Fatal error: Node '%s' does not exist in .ord file\n"
-               " edge is %s->%s\n", name2, name1, name2);
-      abort();
-    }
+  if ( node1->layer == node2->layer ) {
+    fprintf( stderr, "FATAL: addEdge, nodes on same layer.\n" );
+    fprintf( stderr, " Nodes %s and %s are on layer %d.\n",
+             NODE_NAME( node1 ), NODE_NAME( node2 ), node1->layer);
+    abort();
+  }
   Nodeptr upper_node
     = ( node1->layer > node2->layer ) ? node1 : node2;
   Nodeptr lower_node
     = ( node1->layer < node2->layer ) ? node1 : node2;
+  if ( upper_node->layer - lower_node->layer != 1 ) {
+    fprintf( stderr, "FATAL: addEdge, nodes not on adjacent layers.\n" );
+    fprintf( stderr, " Nodes %s is on layer %d and %s is on layer %d.\n",
+             NODE_NAME( upper_node ), upper_node->layer,
+             NODE_NAME( lower_node ), lower_node->layer);
+    abort();
+  }
+  if ( 2 * CTX(number_of_edges) == saved->capacity )
+    saved->endpoints = (int32_t *) grow_array( saved->endpoints,
+                                               & saved->capacity,
+                                               sizeof(int32_t) );
+  saved->endpoints[ 2 * CTX(number_of_edges) ] = upper_node->id;
+  saved->endpoints[ 2 * CTX(number_of_edges) + 1 ] = lower_node->id;
+  CTX(number_of_edges)++;
   upper_node->down_degree++;
   lower_node->up_degree++;
 }
 
 /**
- * Reads the dot file and makes room for nodes on all the adjacency lists;
- * resets up and down node degrees. This is the first pass of reading the dot
- * file.  Also saves the name of the graph.
+ * Allocates the adjacency lists, now that all degrees are known, and
+ * creates the saved edges; the nodes must be on their layers.
  */
-void allocateAdjacencyLists( const char * dot_file )
+static void createEdges( SavedEdges * saved )
 {
-  FILE * in = fopen( dot_file, "r" );
-  if( in == NULL )
+  // allocate adjacency lists for all nodes based on the appropriate
+  // degrees; they are consecutive pieces of a single array, each edge
+  // appearing twice
+  Edgeptr * adjacency
+    = (Edgeptr *) arena_calloc( CTX(graph_arena), 2 * CTX(number_of_edges),
+                                sizeof(Edgeptr) );
+  int layer = 0;
+  for( ; layer < CTX(number_of_layers); layer++ )
     {
-      fprintf( stderr, "Unable to open file %s for input\n", dot_file );
-      exit( EXIT_FAILURE );
+      int position = 0;
+      for( ; position < CTX(layers)[ layer ]->node_count; position++ )
+        {
+          Nodeptr node = CTX(layers)[ layer ]->nodes[ position ];
+          node->up_edges = adjacency;
+          adjacency += node->up_degree;
+          node->down_edges = adjacency;
+          adjacency += node->down_degree;
+          node->up_degree = 0;
+          node->down_degree = 0;
+        }
     }
+
+  CTX(master_edge_list)
+    = (Edgeptr *) arena_calloc( CTX(graph_arena), CTX(number_of_edges),
+                                sizeof(Edgeptr) );
+  CTX(edge_records)
+    = (struct edge_struct *) arena_calloc( CTX(graph_arena),
+                                           CTX(number_of_edges),
+                                           sizeof(struct edge_struct) );
+  int32_t * endpoints = saved->endpoints;
+  for ( int i = 0; i < CTX(number_of_edges); i++ )
+    addEdge( CTX(master_node_list)[ endpoints[ 2 * i ] ],
+             CTX(master_node_list)[ endpoints[ 2 * i + 1 ] ] );
+  free( endpoints );
+  saved->endpoints = NULL;
+  saved->capacity = 0;
+}
+
+/**
+ * Reads a dot file and adds all the edges; the adjacency lists are
+ * allocated once all degrees are known. Also saves the name of the graph.
+ */
+static void readDotInput( MappedInputptr in )
+{
   initDot( in );
-  getNameFromDotFile( graph_name );
-  // read the edges and use each edge to update the appropriate degree for
-  // each endpoint
-  char src_buf[MAX_NAME_LENGTH];
-  char dst_buf[MAX_NAME_LENGTH];
-  while ( nextEdge( in, src_buf, dst_buf ) )
+  getNameFromDotFile( CTX(graph_name) );
+  SavedEdges saved = { NULL, 0 };
+  NameSlice source, destination;
+  while ( nextEdge( in, & source, & destination ) )
     {
 #ifdef DEBUG
-      printf( " new edge: %s -> %s\n", src_buf, dst_buf );
+      printf( " new edge: %.*s -> %.*s\n", source.length, source.start,
+              destination.length, destination.start );
 #endif
-      number_of_edges++;
-      incrementDegrees( src_buf, dst_buf );
+      saveEdge( & saved,
+                edgeEndpoint( source, source, destination, ".ord" ),
+                edgeEndpoint( destination, source, destination, ".ord" ) );
     }
-  // allocate adjacency lists for all nodes based on the appropriate degrees
-  int layer = 0;
-  for( ; layer < number_of_layers; layer++ )
+  createEdges( & saved );
+}
+
+/**
+ * Reads a dot file followed by an ord file from a single input. The edges
+ * come first, but their endpoints are not known until the ord part has
+ * been read, so the names of the endpoints are kept as slices of the input
+ * until then.
+ */
+static void readDotAndOrdInput( MappedInputptr in )
+{
+  initDot( in );
+  getNameFromDotFile( CTX(graph_name) );
+  NameSlice * endpoint_names = NULL;
+  int capacity = 0;
+  int edge_count = 0;
+  NameSlice source, destination;
+  while ( nextEdge( in, & source, & destination ) )
     {
-      int position = 0;
-      for( ; position < layers[ layer ]->number_of_nodes; position++ )
+      if ( 2 * edge_count == capacity )
+        endpoint_names = (NameSlice *) grow_array( endpoint_names, & capacity,
+                                                   sizeof(NameSlice) );
+      endpoint_names[ 2 * edge_count ] = source;
+      endpoint_names[ 2 * edge_count + 1 ] = destination;
+      edge_count++;
+    }
+  readOrdInput( in );
+  SavedEdges saved = { NULL, 0 };
+  for ( int i = 0; i < edge_count; i++ )
+    {
+      source = endpoint_names[ 2 * i ];
+      destination = endpoint_names[ 2 * i + 1 ];
+      saveEdge( & saved,
+                edgeEndpoint( source, source, destination, ".ord" ),
+                edgeEndpoint( destination, source, destination, ".ord" ) );
+    }
+  free( endpoint_names );
+  createEdges( & saved );
+}
+
+/**
+ * Puts the nodes read from an sgf file on their layers, at the positions
+ * given in the file, and renumbers them in order of layer and position, as
+ * if they had been read from an ord file; the saved edges are renumbered
+ * accordingly. Also moves master_node_list and node_names to graph_arena.
+ */
+static void placeSgfNodes( SavedEdges * saved )
+{
+  for ( int layer = 0; layer < CTX(number_of_layers); layer++ )
+    CTX(layers)[ layer ]->nodes
+      = (Nodeptr *) arena_calloc( CTX(graph_arena),
+                                  CTX(layers)[ layer ]->node_count,
+                                  sizeof(Nodeptr) );
+  for ( int i = 0; i < CTX(number_of_nodes); i++ )
+    {
+      Nodeptr node = CTX(master_node_list)[i];
+      Layerptr layer = CTX(layers)[ node->layer ];
+      if ( node->position < 0 || node->position >= layer->node_count
+           || layer->nodes[ node->position ] != NULL )
         {
-          Nodeptr node = layers[ layer ]->nodes[ position ];
-          node->up_edges
-            = (Edgeptr *) calloc( node->up_degree, sizeof(Nodeptr) );
-          node->down_edges
-            = (Edgeptr *) calloc( node->down_degree, sizeof(Nodeptr) );
-          node->up_degree = 0;
-          node->down_degree = 0;
+          fprintf( stderr, "Fatal error: Node %s has position %d on layer %d,"
+                   " which has %d nodes",
+                   NODE_NAME( node ), node->position, node->layer,
+                   layer->node_count );
+          if ( node->position >= 0 && node->position < layer->node_count )
+            fprintf( stderr, "; the position is taken by node %s",
+                     NODE_NAME( layer->nodes[ node->position ] ) );
+          fprintf( stderr, "\n" );
+          abort();
         }
+      layer->nodes[ node->position ] = node;
     }
-  fclose( in );
+
+  Nodeptr * node_with_old_id = CTX(master_node_list);
+  char ** old_node_names = CTX(node_names);
+  CTX(master_node_list)
+    = (Nodeptr *) arena_alloc( CTX(graph_arena),
+                               CTX(number_of_nodes) * sizeof(Nodeptr) );
+  CTX(node_names)
+    = (char **) arena_alloc( CTX(graph_arena),
+                             CTX(number_of_nodes) * sizeof(char *) );
+  int id = 0;
+  for ( int layer = 0; layer < CTX(number_of_layers); layer++ )
+    for ( int position = 0;
+          position < CTX(layers)[ layer ]->node_count; position++ )
+      {
+        Nodeptr node = CTX(layers)[ layer ]->nodes[ position ];
+        CTX(node_names)[ id ] = old_node_names[ node->id ];
+        CTX(master_node_list)[ id ] = node;
+        node->id = id++;
+      }
+  for ( int i = 0; i < 2 * CTX(number_of_edges); i++ )
+    saved->endpoints[i] = node_with_old_id[ saved->endpoints[i] ]->id;
+  free( node_with_old_id );
+  free( old_node_names );
+  CTX(node_capacity) = 0;
 }
 
 /**
- * Reads the dot file and adds all the edges. This is the second pass.
+ * Reads an sgf file: creates the layers and the nodes, as readOrdInput()
+ * does, and saves the edges, as readDotInput() does. Once the nodes are on
+ * their layers, the edges are added.
  */
-void createEdges( const char * dot_file )
+static void readSgfInput( MappedInputptr in )
 {
-  FILE * in = fopen( dot_file, "r" );
-  initDot( in );
-  char src_buf[MAX_NAME_LENGTH];
-  char dst_buf[MAX_NAME_LENGTH];
-  while ( nextEdge( in, src_buf, dst_buf ) )
+  NameSlice name;
+  int expected_nodes, expected_edges, expected_layers;
+  readSgfTitle( in, & name, & expected_nodes, & expected_edges,
+                & expected_layers );
+  int length = name.length < MAX_NAME_LENGTH ? name.length : MAX_NAME_LENGTH - 1;
+  memcpy( CTX(graph_name), name.start, length );
+  CTX(graph_name)[ length ] = '\0';
+
+  CTX(layer_capacity) = expected_layers > MIN_LAYER_CAPACITY
+    ? expected_layers : MIN_LAYER_CAPACITY;
+  CTX(layers) = (Layerptr *) calloc( CTX(layer_capacity), sizeof(Layerptr) );
+
+  SavedEdges saved = { NULL, 0 };
+  SgfItem item;
+  while ( nextSgfItem( in, & item ) )
     {
-      addEdge( src_buf, dst_buf );
+      if ( item.type == 'n' )
+        {
+          if ( item.layer < 0 )
+            {
+              inputError( in, "negative layer %d", item.layer );
+              exit( EXIT_FAILURE );
+            }
+          while ( CTX(number_of_layers) <= item.layer ) makeLayer();
+          Nodeptr node = makeNode( item.node.start, item.node.length );
+          node->layer = item.layer;
+          node->position = item.position;
+          CTX(layers)[ item.layer ]->node_count++;
+        }
+      else
+        {
+          saveEdge( & saved,
+                    edgeEndpoint( item.source, item.source, item.target,
+                                  ".sgf" ),
+                    edgeEndpoint( item.target, item.source, item.target,
+                                  ".sgf" ) );
+        }
     }
-  fclose( in );
+
+  CTX(number_of_nodes) = CTX(next_node_id);
+  placeSgfNodes( & saved );
+  createEdges( & saved );
 }
 
 /**
@@ -347,12 +603,12 @@ static int countIsolatedNodes()
    */
   int isolated_nodes = 0;
   int layer = 0;
-  for( ; layer < number_of_layers; layer++ )
+  for( ; layer < CTX(number_of_layers); layer++ )
     {
       int position = 0;
-      for( ; position < layers[ layer ]->number_of_nodes; position++ )
+      for( ; position < CTX(layers)[ layer ]->node_count; position++ )
         {
-          Nodeptr node = layers[ layer ]->nodes[ position ];
+          Nodeptr node = CTX(layers)[ layer ]->nodes[ position ];
           if( node->up_degree + node->down_degree == 0 )
             isolated_nodes++;
         }
@@ -362,36 +618,458 @@ static int countIsolatedNodes()
 
 void readGraph( const char * dot_file, const char * ord_file )
 {
-  number_of_nodes = 0;
-  number_of_edges = 0;
-  number_of_layers = 0;
-  allocateLayers( ord_file );
-  master_node_list = (Nodeptr *) calloc( number_of_nodes, sizeof(Nodeptr) );
-  initHashTable( number_of_nodes );
-  assignNodesToLayers( ord_file );
+  freeGraph();
+  CTX(graph_arena) = arena_create( GRAPH_ARENA_BLOCK_SIZE );
+  initHashTable( MIN_HASH_TABLE_ENTRIES, CTX(graph_arena) );
+  MappedInputptr in = openInputFile( ord_file );
+  readOrdInput( in );
+  closeMappedInput( in );
 #ifdef DEBUG
   printf( "Master node list after reading ord file:\n" );
-  for ( int i = 0; i < number_of_nodes; i++ ) {
-    printf( "%s, layer = %d, position = %d\n", master_node_list[i]->name,
-            master_node_list[i]->layer, master_node_list[i]->position );
+  for ( int i = 0; i < CTX(number_of_nodes); i++ ) {
+    printf( "%s, layer = %d, position = %d\n",
+            NODE_NAME( CTX(master_node_list)[i] ),
+            CTX(master_node_list)[i]->layer,
+            CTX(master_node_list)[i]->position );
   }
 #endif
-  allocateAdjacencyLists( dot_file );
-  // at this point the number of edges is known
-  master_edge_list = (Edgeptr *) calloc( number_of_edges, sizeof(Edgeptr) );
-  createEdges( dot_file );
-  number_of_isolated_nodes = countIsolatedNodes();
+  in = openInputFile( dot_file );
+  readDotInput( in );
+  closeMappedInput( in );
+  CTX(number_of_isolated_nodes) = countIsolatedNodes();
+  removeHashTable();
+}
+
+void readSgf( const char * sgf_file )
+{
+  freeGraph();
+  CTX(graph_arena) = arena_create( GRAPH_ARENA_BLOCK_SIZE );
+  initHashTable( MIN_HASH_TABLE_ENTRIES, CTX(graph_arena) );
+  MappedInputptr in = openInputFile( sgf_file );
+  readSgfInput( in );
+  closeMappedInput( in );
+  CTX(number_of_isolated_nodes) = countIsolatedNodes();
+  removeHashTable();
+}
+
+/**
+ * @return true if the input looks like an sgf file, i.e., its first
+ * nonblank line is a comment or a title line; a dot file starts with a
+ * C-style comment or 'digraph'
+ */
+static bool isSgfInput( MappedInputptr in )
+{
+  const char * position = in->position;
+  while ( position < in->end && isspace( (unsigned char) * position ) )
+    position++;
+  return position + 1 < in->end
+    && ( * position == 'c' || * position == 't' )
+    && isspace( (unsigned char) position[1] );
+}
+
+enum graph_format_enum readGraphStream( FILE * stream,
+                                        const char * stream_name )
+{
+  MappedInputptr in = readMappedStream( stream, stream_name );
+  if( in == NULL )
+    {
+      fprintf( stderr, "Unable to read %s\n", stream_name );
+      exit( EXIT_FAILURE );
+    }
+  freeGraph();
+  CTX(graph_arena) = arena_create( GRAPH_ARENA_BLOCK_SIZE );
+  initHashTable( MIN_HASH_TABLE_ENTRIES, CTX(graph_arena) );
+  enum graph_format_enum format = isSgfInput( in ) ? SGF : DOT_AND_ORD;
+  if ( format == SGF )
+    readSgfInput( in );
+  else
+    readDotAndOrdInput( in );
+  closeMappedInput( in );
+  CTX(number_of_isolated_nodes) = countIsolatedNodes();
   removeHashTable();
+  return format;
+}
+
+/**
+ * Reports that a snapshot file is invalid and exits
+ */
+static void snapshotError( MappedInputptr in, const char * message )
+{
+  fprintf( stderr, "Fatal error: %s is not a valid snapshot: %s\n",
+           in->file_name, message );
+  exit( EXIT_FAILURE );
+}
+
+/**
+ * @return true if the section with the given offset and number of elements
+ * of the given size is properly aligned and lies within the file
+ */
+static bool validSection( const SnapshotHeader * header, uint64_t offset,
+                          uint64_t count, size_t element_size )
+{
+  return offset % SNAPSHOT_ALIGNMENT == 0
+    && offset >= header->header_size
+    && offset <= header->file_size
+    && count <= ( header->file_size - offset ) / element_size;
+}
+
+/**
+ * @return the header of the snapshot, after checking that the file is a
+ * snapshot that this program can read and that all sections are within it
+ */
+static const SnapshotHeader * snapshotHeader( MappedInputptr in )
+{
+  const SnapshotHeader * header = (const SnapshotHeader *) in->text;
+  if ( in->size < sizeof(SnapshotHeader)
+       || memcmp( header->magic, SNAPSHOT_MAGIC, sizeof(header->magic) ) != 0 )
+    snapshotError( in, "wrong file type" );
+  if ( header->byte_order != SNAPSHOT_BYTE_ORDER )
+    snapshotError( in, "written on a machine with a different byte order" );
+  if ( header->version != SNAPSHOT_VERSION
+       || header->header_size != sizeof(SnapshotHeader) )
+    snapshotError( in, "unknown version" );
+  if ( header->file_size != in->size )
+    snapshotError( in, "wrong size, file is truncated or corrupt" );
+  uint64_t nodes = header->node_count;
+  uint64_t edges = header->edge_count;
+  uint64_t orders = header->order_count;
+  if ( header->layer_count < 0 || header->node_count < 0
+       || header->edge_count < 0 || header->order_count < 0
+       || ! validSection( header, header->layer_size,
+                          header->layer_count, sizeof(int32_t) )
+       || ! validSection( header, header->node_name, nodes, sizeof(uint32_t) )
+       || ! validSection( header, header->string_pool,
+                          header->string_pool_size, sizeof(char) )
+       || ! validSection( header, header->edge, 2 * edges, sizeof(int32_t) )
+       || ! validSection( header, header->up_start, nodes + 1,
+                          sizeof(int32_t) )
+       || ! validSection( header, header->up_edge, edges, sizeof(int32_t) )
+       || ! validSection( header, header->down_start, nodes + 1,
+                          sizeof(int32_t) )
+       || ! validSection( header, header->down_edge, edges, sizeof(int32_t) )
+       || ! validSection( header, header->order_name, orders,
+                          sizeof(uint32_t) )
+       || ! validSection( header, header->order, orders * nodes,
+                          sizeof(int32_t) ) )
+    snapshotError( in, "a section is outside the file" );
+  if ( header->string_pool_size == 0
+       || in->text[ header->string_pool + header->string_pool_size - 1 ]
+       != '\0'
+       || header->graph_name_offset >= header->string_pool_size )
+    snapshotError( in, "bad string pool" );
+  return header;
+}
+
+/**
+ * Sets up the adjacency list of the given node in one direction from the
+ * CSR arrays of the snapshot
+ * @return the part of the adjacency array after the list
+ */
+static Edgeptr * snapshotAdjacency( MappedInputptr in, int v,
+                                    const int32_t * start,
+                                    const int32_t * edge_ids,
+                                    Edgeptr * adjacency, int * degree )
+{
+  if ( start[v] > start[v + 1] || start[v + 1] > CTX(number_of_edges) )
+    snapshotError( in, "bad adjacency lists" );
+  * degree = start[v + 1] - start[v];
+  for ( int i = start[v]; i < start[v + 1]; i++ )
+    {
+      if ( edge_ids[i] < 0 || edge_ids[i] >= CTX(number_of_edges) )
+        snapshotError( in, "bad edge in adjacency list" );
+      * adjacency++ = & CTX(edge_records)[ edge_ids[i] ];
+    }
+  return adjacency;
+}
+
+/**
+ * Puts the nodes on their layers in the saved ordering with the given name
+ */
+static void restoreSnapshotOrder( MappedInputptr in,
+                                  const SnapshotHeader * header,
+                                  const char * order_name )
+{
+  const char * pool = in->text + header->string_pool;
+  const uint32_t * name_offset
+    = (const uint32_t *) ( in->text + header->order_name );
+  int k = 0;
+  while ( k < header->order_count
+          && ( name_offset[k] >= header->string_pool_size
+               || strcmp( pool + name_offset[k], order_name ) != 0 ) )
+    k++;
+  if ( k == header->order_count )
+    {
+      fprintf( stderr, "Fatal error: snapshot %s has no ordering %s;"
+               " it has", in->file_name, order_name );
+      for ( k = 0; k < header->order_count; k++ )
+        if ( name_offset[k] < header->string_pool_size )
+          fprintf( stderr, " %s", pool + name_offset[k] );
+      fprintf( stderr, "\n" );
+      exit( EXIT_FAILURE );
+    }
+  const int32_t * order
+    = (const int32_t *) ( in->text + header->order )
+    + (size_t) k * CTX(number_of_nodes);
+  for ( int layer = 0; layer < CTX(number_of_layers); layer++ )
+    {
+      Nodeptr * nodes = CTX(layers)[ layer ]->nodes;
+      int node_count = CTX(layers)[ layer ]->node_count;
+      for ( int position = 0; position < node_count; position++ )
+        {
+          int32_t id = * order++;
+          if ( id < 0 || id >= CTX(number_of_nodes)
+               || CTX(master_node_list)[ id ]->layer != layer )
+            snapshotError( in, "bad ordering" );
+          nodes[ position ] = CTX(master_node_list)[ id ];
+          nodes[ position ]->position = position;
+        }
+      // a node that appears twice has the later of its positions
+      for ( int position = 0; position < node_count; position++ )
+        if ( nodes[ position ]->position != position )
+          snapshotError( in, "bad ordering" );
+    }
+}
+
+void readSnapshot( const char * snapshot_file, const char * order_name )
+{
+  freeGraph();
+  MappedInputptr in = openMappedInput( snapshot_file );
+  if( in == NULL )
+    {
+      fprintf( stderr, "Unable to open file %s for input\n", snapshot_file );
+      exit( EXIT_FAILURE );
+    }
+  const SnapshotHeader * header = snapshotHeader( in );
+  CTX(snapshot_input) = in;
+  CTX(graph_arena) = arena_create( GRAPH_ARENA_BLOCK_SIZE );
+  const char * pool = in->text + header->string_pool;
+  strncpy( CTX(graph_name), pool + header->graph_name_offset,
+           MAX_NAME_LENGTH - 1 );
+  CTX(graph_name)[ MAX_NAME_LENGTH - 1 ] = '\0';
+  CTX(number_of_nodes) = header->node_count;
+  CTX(number_of_edges) = header->edge_count;
+
+  // layers; the nodes of each layer have consecutive id's
+  const int32_t * layer_size
+    = (const int32_t *) ( in->text + header->layer_size );
+  CTX(layer_capacity) = header->layer_count > MIN_LAYER_CAPACITY
+    ? header->layer_count : MIN_LAYER_CAPACITY;
+  CTX(layers) = (Layerptr *) calloc( CTX(layer_capacity), sizeof(Layerptr) );
+  int first_id = 0;
+  for ( int layer = 0; layer < header->layer_count; layer++ )
+    {
+      if ( layer_size[ layer ] < 0
+           || layer_size[ layer ] > CTX(number_of_nodes) - first_id )
+        snapshotError( in, "bad layer sizes" );
+      makeLayer();
+      CTX(layers)[ layer ]->node_count = layer_size[ layer ];
+      CTX(layers)[ layer ]->nodes = (Nodeptr *)
+        arena_alloc( CTX(graph_arena), layer_size[ layer ] * sizeof(Nodeptr) );
+      first_id += layer_size[ layer ];
+    }
+  if ( first_id != CTX(number_of_nodes) )
+    snapshotError( in, "bad layer sizes" );
+
+  // nodes, in the order of their id's; the names stay in the file
+  const uint32_t * name_offset
+    = (const uint32_t *) ( in->text + header->node_name );
+  const int32_t * up_start = (const int32_t *) ( in->text + header->up_start );
+  const int32_t * up_edge = (const int32_t *) ( in->text + header->up_edge );
+  const int32_t * down_start
+    = (const int32_t *) ( in->text + header->down_start );
+  const int32_t * down_edge
+    = (const int32_t *) ( in->text + header->down_edge );
+  CTX(node_names)
+    = (char **) arena_alloc( CTX(graph_arena),
+                             CTX(number_of_nodes) * sizeof(char *) );
+  CTX(master_node_list) = (Nodeptr *)
+    arena_alloc( CTX(graph_arena), CTX(number_of_nodes) * sizeof(Nodeptr) );
+  CTX(node_records) = (struct node_struct *)
+    arena_calloc( CTX(graph_arena), CTX(number_of_nodes),
+                  sizeof(struct node_struct) );
+  CTX(edge_records) = (struct edge_struct *)
+    arena_calloc( CTX(graph_arena), CTX(number_of_edges),
+                  sizeof(struct edge_struct) );
+  Edgeptr * adjacency = (Edgeptr *)
+    arena_alloc( CTX(graph_arena), 2 * CTX(number_of_edges) * sizeof(Edgeptr) );
+  int id = 0;
+  for ( int layer = 0; layer < CTX(number_of_layers); layer++ )
+    for ( int position = 0; position < CTX(layers)[ layer ]->node_count;
+          position++, id++ )
+      {
+        if ( name_offset[ id ] >= header->string_pool_size )
+          snapshotError( in, "bad node name" );
+        CTX(node_names)[ id ] = (char *) pool + name_offset[ id ];
+        Nodeptr node = & CTX(node_records)[ id ];
+        node->id = id;
+        node->layer = layer;
+        node->position = position;
+        node->up_edges = adjacency;
+        adjacency = snapshotAdjacency( in, id, up_start, up_edge,
+                                       adjacency, & node->up_degree );
+        node->down_edges = adjacency;
+        adjacency = snapshotAdjacency( in, id, down_start, down_edge,
+                                       adjacency, & node->down_degree );
+        CTX(master_node_list)[ id ] = node;
+        CTX(layers)[ layer ]->nodes[ position ] = node;
+      }
+  if ( up_start[ CTX(number_of_nodes) ] + down_start[ CTX(number_of_nodes) ]
+       != 2 * CTX(number_of_edges) )
+    snapshotError( in, "bad adjacency lists" );
+  CTX(next_node_id) = CTX(number_of_nodes);
+
+  // edges
+  const int32_t * endpoint = (const int32_t *) ( in->text + header->edge );
+  CTX(master_edge_list) = (Edgeptr *)
+    arena_alloc( CTX(graph_arena), CTX(number_of_edges) * sizeof(Edgeptr) );
+  for ( int i = 0; i < CTX(number_of_edges); i++ )
+    {
+      int32_t upper = endpoint[ 2 * i ];
+      int32_t lower = endpoint[ 2 * i + 1 ];
+      if ( upper < 0 || upper >= CTX(number_of_nodes)
+           || lower < 0 || lower >= CTX(number_of_nodes)
+           || CTX(master_node_list)[ upper ]->layer
+           != CTX(master_node_list)[ lower ]->layer + 1 )
+        snapshotError( in, "bad edge" );
+      Edgeptr edge = & CTX(edge_records)[i];
+      edge->up_node = CTX(master_node_list)[ upper ];
+      edge->down_node = CTX(master_node_list)[ lower ];
+      edge->id = i;
+      CTX(master_edge_list)[i] = edge;
+    }
+  CTX(next_edge_id) = CTX(number_of_edges);
+
+  if ( order_name != NULL )
+    restoreSnapshotOrder( in, header, order_name );
+  CTX(number_of_isolated_nodes) = countIsolatedNodes();
+}
+
+void copyGraph( RunContextptr source )
+{
+  // the fields of the source are only accessible while it is current
+  RunContextptr target = current_context;
+  setRunContext( source );
+  int layer_count = CTX(number_of_layers);
+  int node_count = CTX(number_of_nodes);
+  int edge_count = CTX(number_of_edges);
+  int isolated_node_count = CTX(number_of_isolated_nodes);
+  Layerptr * source_layers = CTX(layers);
+  Nodeptr * source_nodes = CTX(master_node_list);
+  Edgeptr * source_edges = CTX(master_edge_list);
+  char ** source_names = CTX(node_names);
+  const char * source_graph_name = CTX(graph_name);
+  setRunContext( target );
+
+  freeGraph();
+  CTX(graph_arena) = arena_create( GRAPH_ARENA_BLOCK_SIZE );
+  strcpy( CTX(graph_name), source_graph_name );
+  CTX(number_of_nodes) = node_count;
+  CTX(number_of_edges) = edge_count;
+  CTX(layer_capacity)
+    = layer_count > MIN_LAYER_CAPACITY ? layer_count : MIN_LAYER_CAPACITY;
+  CTX(layers) = (Layerptr *) calloc( CTX(layer_capacity), sizeof(Layerptr) );
+  CTX(node_names)
+    = (char **) arena_alloc( CTX(graph_arena), node_count * sizeof(char *) );
+  CTX(master_node_list)
+    = (Nodeptr *) arena_alloc( CTX(graph_arena), node_count * sizeof(Nodeptr) );
+  CTX(master_edge_list)
+    = (Edgeptr *) arena_alloc( CTX(graph_arena), edge_count * sizeof(Edgeptr) );
+  CTX(node_records) = (struct node_struct *)
+    arena_alloc( CTX(graph_arena), node_count * sizeof(struct node_struct) );
+  CTX(edge_records) = (struct edge_struct *)
+    arena_alloc( CTX(graph_arena), edge_count * sizeof(struct edge_struct) );
+  Edgeptr * adjacency = (Edgeptr *)
+    arena_alloc( CTX(graph_arena), 2 * edge_count * sizeof(Edgeptr) );
+
+  // records are indexed by id, so the copy of a node or edge is found
+  // without a lookup; master_node_list and master_edge_list keep the order
+  // of the source
+  for ( int i = 0; i < edge_count; i++ )
+    {
+      Edgeptr edge = & CTX(edge_records)[ source_edges[i]->id ];
+      * edge = * source_edges[i];
+      edge->up_node = & CTX(node_records)[ source_edges[i]->up_node->id ];
+      edge->down_node = & CTX(node_records)[ source_edges[i]->down_node->id ];
+      CTX(master_edge_list)[i] = edge;
+    }
+  for ( int i = 0; i < node_count; i++ )
+    {
+      Nodeptr source_node = source_nodes[i];
+      Nodeptr node = & CTX(node_records)[ source_node->id ];
+      * node = * source_node;
+      node->up_edges = adjacency;
+      for ( int j = 0; j < node->up_degree; j++ )
+        * adjacency++ = & CTX(edge_records)[ source_node->up_edges[j]->id ];
+      node->down_edges = adjacency;
+      for ( int j = 0; j < node->down_degree; j++ )
+        * adjacency++ = & CTX(edge_records)[ source_node->down_edges[j]->id ];
+      CTX(node_names)[ node->id ] = source_names[ source_node->id ];
+      CTX(master_node_list)[i] = node;
+    }
+  for ( int layer = 0; layer < layer_count; layer++ )
+    {
+      makeLayer();
+      int size = source_layers[ layer ]->node_count;
+      CTX(layers)[ layer ]->node_count = size;
+      CTX(layers)[ layer ]->nodes
+        = (Nodeptr *) arena_alloc( CTX(graph_arena), size * sizeof(Nodeptr) );
+      for ( int position = 0; position < size; position++ )
+        CTX(layers)[ layer ]->nodes[ position ]
+          = & CTX(node_records)
+              [ source_layers[ layer ]->nodes[ position ]->id ];
+    }
+  CTX(next_node_id) = node_count;
+  CTX(next_edge_id) = edge_count;
+  CTX(number_of_isolated_nodes) = isolated_node_count;
+}
+
+void freeGraph( void )
+{
+  if ( CTX(snapshot_input) != NULL )
+    closeMappedInput( CTX(snapshot_input) );
+  CTX(snapshot_input) = NULL;
+  arena_free( CTX(graph_arena) );
+  CTX(graph_arena) = NULL;
+  free( CTX(layers) );
+  CTX(layers) = NULL;
+  CTX(master_node_list) = NULL;
+  CTX(master_edge_list) = NULL;
+  CTX(node_names) = NULL;
+  CTX(node_records) = NULL;
+  CTX(node_records_left) = 0;
+  CTX(node_capacity) = 0;
+  CTX(edge_records) = NULL;
+  CTX(number_of_nodes) = 0;
+  CTX(number_of_edges) = 0;
+  CTX(number_of_layers) = 0;
+  CTX(number_of_isolated_nodes) = 0;
+  CTX(next_node_id) = 0;
+  CTX(next_edge_id) = 0;
 }
 
 // --------------- Output to dot and ord files
 
-static void writeNodes( FILE * out, Layerptr layerptr )
+/**
+ * Opens a file for output; the file is written when the buffer returned is
+ * passed to writeOutputBuffer(), perhaps by the output thread
+ */
+static OutputBufferptr openOutputFile( const char * file_name )
+{
+  FILE * out = fopen( file_name, "w" );
+  if( out == NULL )
+    {
+      fprintf( stderr, "Unable to open file %s for output\n", file_name );
+      exit( EXIT_FAILURE );
+    }
+  return createOutputBuffer( out, true );
+}
+
+static void writeNodes( OutputBufferptr out, Layerptr layerptr )
 {
   int i = 0;
-  for( ; i < layerptr->number_of_nodes; i++ )
+  for( ; i < layerptr->node_count; i++ )
     {
-      outputNode( out, layerptr->nodes[i]->name );
+      outputNode( out, NODE_NAME( layerptr->nodes[i] ) );
     }
 }
 
@@ -404,45 +1082,263 @@ static void writeNodes( FILE * out, Layerptr layerptr )
  */
 void writeOrd( const char * ord_file )
 {
-  FILE * out = fopen( ord_file, "w" );
-  if( out == NULL )
-    {
-      fprintf( stderr, "Unable to open file %s for output\n", ord_file );
-      exit( EXIT_FAILURE );
-    }
-  ordPreamble( out, graph_name, "" );
+  OutputBufferptr out = openOutputFile( ord_file );
+  ordPreamble( out, CTX(graph_name), "" );
   int layer = 0;
-  for( ; layer < number_of_layers; layer++ )
+  for( ; layer < CTX(number_of_layers); layer++ )
     {
       beginLayer( out, layer, "heuristic-based" );
-      writeNodes( out, layers[ layer ] );
+      writeNodes( out, CTX(layers)[ layer ] );
       endLayer( out );
     }
-  fclose( out );
+  writeOutputBuffer( out );
 }
 
 void writeDot( const char * dot_file_name,
-               const char * graph_name,
+               const char * name_of_graph,
                const char * header_information,
-               Edgeptr * edge_list,
+               const Edgeptr * edge_list,
                int edge_list_length
                )
 {
-  FILE * out = fopen( dot_file_name, "w" );
-  if( out == NULL )
-    {
-      fprintf( stderr, "Unable to open file %s for output\n", dot_file_name );
-      exit( EXIT_FAILURE );
-    }
-  dotPreamble( out, graph_name, header_information );
+  OutputBufferptr out = openOutputFile( dot_file_name );
+  dotPreamble( out, name_of_graph, header_information );
   for ( int i = 0; i < edge_list_length; i++ )
     {
       Edgeptr current = edge_list[i];
       Nodeptr up_node = current->up_node;
       Nodeptr down_node = current->down_node;
-      outputEdge( out, up_node->name, down_node->name );
+      outputEdge( out, NODE_NAME( up_node ), NODE_NAME( down_node ) );
     }
   endDot( out );
+  writeOutputBuffer( out );
+}
+
+void writeSgf( const char * sgf_file )
+{
+  OutputBufferptr out = openOutputFile( sgf_file );
+  outputSgfComment( out, "heuristic-based ordering" );
+  outputSgfTitle( out, CTX(graph_name), CTX(number_of_nodes),
+                  CTX(number_of_edges), CTX(number_of_layers) );
+  for( int layer = 0; layer < CTX(number_of_layers); layer++ )
+    for( int position = 0;
+         position < CTX(layers)[ layer ]->node_count; position++ )
+      outputSgfNode( out, NODE_NAME( CTX(layers)[ layer ]->nodes[ position ] ),
+                     layer, position );
+  for( int i = 0; i < CTX(number_of_edges); i++ )
+    {
+      Edgeptr edge = CTX(master_edge_list)[i];
+      outputSgfEdge( out, NODE_NAME( edge->down_node ),
+                     NODE_NAME( edge->up_node ) );
+    }
+  writeOutputBuffer( out );
+}
+
+void writeOrdering( const char * file_name )
+{
+  if ( OPTION(graph_format) == SGF )
+    writeSgf( file_name );
+  else
+    writeOrd( file_name );
+}
+
+/**
+ * @return the offset rounded up to a multiple of SNAPSHOT_ALIGNMENT
+ */
+static uint64_t alignOffset( uint64_t offset )
+{
+  return ( offset + SNAPSHOT_ALIGNMENT - 1 )
+    / SNAPSHOT_ALIGNMENT * SNAPSHOT_ALIGNMENT;
+}
+
+/**
+ * Writes zeros up to the given offset and then the data
+ * @param written the number of bytes written so far; updated
+ */
+static void writeSection( FILE * out, uint64_t * written, uint64_t offset,
+                          const void * data, size_t size )
+{
+  for ( ; * written < offset; ( * written )++ ) putc( '\0', out );
+  if ( size > 0 ) fwrite( data, 1, size, out );
+  * written += size;
+}
+
+/**
+ * @return the CSR adjacency of the nodes in one direction, in the form
+ * described in snapshot.h: number_of_nodes + 1 starts followed by
+ * number_of_edges edge id's; the edges of each node are in order of id,
+ * i.e., the order in which they were read, since counting crossings sorts
+ * the down edges of each node by the positions of their down nodes. The
+ * nodes are taken in order of id from graph_core, since sifting permutes
+ * master_node_list.
+ */
+static int32_t * csrAdjacency( bool up )
+{
+  int32_t * csr
+    = (int32_t *) malloc( ( CTX(number_of_nodes) + 1 + CTX(number_of_edges) )
+                          * sizeof(int32_t) );
+  int32_t * edge_ids = csr + CTX(number_of_nodes) + 1;
+  int32_t index = 0;
+  for ( int v = 0; v < CTX(number_of_nodes); v++ )
+    {
+      Nodeptr node = CTX(graph_core)->node_ptr[v];
+      int degree = up ? node->up_degree : node->down_degree;
+      Edgeptr * edges = up ? node->up_edges : node->down_edges;
+      csr[v] = index;
+      for ( int i = 0; i < degree; i++ )
+        {
+          int32_t id = edges[i]->id;
+          int32_t j = index - 1;
+          while ( j >= csr[v] && edge_ids[j] > id )
+            {
+              edge_ids[j + 1] = edge_ids[j];
+              j--;
+            }
+          edge_ids[j + 1] = id;
+          index++;
+        }
+    }
+  csr[ CTX(number_of_nodes) ] = index;
+  return csr;
+}
+
+void writeSnapshot( const char * snapshot_file, int order_count,
+                    const struct order_struct * const * orders,
+                    const char * const * order_names )
+{
+  SnapshotHeader header;
+  memset( & header, 0, sizeof(header) );
+  memcpy( header.magic, SNAPSHOT_MAGIC, sizeof(header.magic) );
+  header.version = SNAPSHOT_VERSION;
+  header.byte_order = SNAPSHOT_BYTE_ORDER;
+  header.header_size = sizeof(header);
+  header.layer_count = CTX(number_of_layers);
+  header.node_count = CTX(number_of_nodes);
+  header.edge_count = CTX(number_of_edges);
+  header.order_count = order_count;
+
+  // string pool: graph name, node names, ordering names
+  uint32_t * name_offset
+    = (uint32_t *) malloc( ( CTX(number_of_nodes) + order_count + 1 )
+                           * sizeof(uint32_t) );
+  uint32_t * order_name_offset = name_offset + CTX(number_of_nodes);
+  uint64_t pool_size = strlen( CTX(graph_name) ) + 1;
+  for ( int v = 0; v < CTX(number_of_nodes); v++ )
+    {
+      name_offset[v] = pool_size;
+      pool_size += strlen( CTX(node_names)[v] ) + 1;
+    }
+  for ( int k = 0; k < order_count; k++ )
+    {
+      order_name_offset[k] = pool_size;
+      pool_size += strlen( order_names[k] ) + 1;
+    }
+  if ( pool_size > UINT32_MAX )
+    {
+      fprintf( stderr, "FATAL: writeSnapshot, names take more than 4GB\n" );
+      abort();
+    }
+  header.graph_name_offset = 0;
+  header.string_pool_size = pool_size;
+
+  uint64_t nodes = CTX(number_of_nodes);
+  uint64_t edges = CTX(number_of_edges);
+  header.layer_size = alignOffset( sizeof(header) );
+  header.node_name
+    = alignOffset( header.layer_size
+                   + CTX(number_of_layers) * sizeof(int32_t) );
+  header.string_pool
+    = alignOffset( header.node_name + nodes * sizeof(uint32_t) );
+  header.edge = alignOffset( header.string_pool + pool_size );
+  header.up_start = alignOffset( header.edge + 2 * edges * sizeof(int32_t) );
+  header.up_edge
+    = alignOffset( header.up_start + ( nodes + 1 ) * sizeof(int32_t) );
+  header.down_start
+    = alignOffset( header.up_edge + edges * sizeof(int32_t) );
+  header.down_edge
+    = alignOffset( header.down_start + ( nodes + 1 ) * sizeof(int32_t) );
+  header.order_name
+    = alignOffset( header.down_edge + edges * sizeof(int32_t) );
+  header.order
+    = alignOffset( header.order_name + order_count * sizeof(uint32_t) );
+  header.file_size
+    = alignOffset( header.order + order_count * nodes * sizeof(int32_t) );
+
+  FILE * out = fopen( snapshot_file, "w" );
+  if( out == NULL )
+    {
+      fprintf( stderr, "Unable to open file %s for output\n", snapshot_file );
+      exit( EXIT_FAILURE );
+    }
+  uint64_t written = 0;
+  writeSection( out, & written, 0, & header, sizeof(header) );
+
+  int32_t * ids = (int32_t *)
+    malloc( ( 2 * CTX(number_of_edges) + CTX(number_of_nodes)
+              + CTX(number_of_layers) + 1 )
+            * sizeof(int32_t) );
+  for ( int layer = 0; layer < CTX(number_of_layers); layer++ )
+    ids[ layer ] = CTX(layers)[ layer ]->node_count;
+  writeSection( out, & written, header.layer_size,
+                ids, CTX(number_of_layers) * sizeof(int32_t) );
+
+  writeSection( out, & written, header.node_name,
+                name_offset, nodes * sizeof(uint32_t) );
+  writeSection( out, & written, header.string_pool,
+                CTX(graph_name), strlen( CTX(graph_name) ) + 1 );
+  for ( int v = 0; v < CTX(number_of_nodes); v++ )
+    writeSection( out, & written, written,
+                  CTX(node_names)[v], strlen( CTX(node_names)[v] ) + 1 );
+  for ( int k = 0; k < order_count; k++ )
+    writeSection( out, & written, written,
+                  order_names[k], strlen( order_names[k] ) + 1 );
+
+  for ( int i = 0; i < CTX(number_of_edges); i++ )
+    {
+      Edgeptr edge = CTX(master_edge_list)[i];
+      ids[ 2 * edge->id ] = edge->up_node->id;
+      ids[ 2 * edge->id + 1 ] = edge->down_node->id;
+    }
+  writeSection( out, & written, header.edge,
+                ids, 2 * edges * sizeof(int32_t) );
+
+  int32_t * csr = csrAdjacency( true );
+  writeSection( out, & written, header.up_start,
+                csr, ( nodes + 1 ) * sizeof(int32_t) );
+  writeSection( out, & written, header.up_edge,
+                csr + nodes + 1, edges * sizeof(int32_t) );
+  free( csr );
+  csr = csrAdjacency( false );
+  writeSection( out, & written, header.down_start,
+                csr, ( nodes + 1 ) * sizeof(int32_t) );
+  writeSection( out, & written, header.down_edge,
+                csr + nodes + 1, edges * sizeof(int32_t) );
+  free( csr );
+
+  writeSection( out, & written, header.order_name,
+                order_name_offset, order_count * sizeof(uint32_t) );
+  for ( int k = 0; k < order_count; k++ )
+    {
+      uint64_t offset = header.order + k * nodes * sizeof(int32_t);
+      int32_t * order = ids;
+      for ( int layer = 0; layer < CTX(number_of_layers); layer++ )
+        {
+          Nodeptr * image = orders[k]->layer_image[ layer ]->nodes;
+          for ( int i = 0; i < CTX(layers)[ layer ]->node_count; i++ )
+            * order++ = image[i]->id;
+        }
+      writeSection( out, & written, offset,
+                    ids, nodes * sizeof(int32_t) );
+    }
+  writeSection( out, & written, header.file_size, NULL, 0 );
+
+  free( ids );
+  free( name_offset );
+  if ( ferror( out ) )
+    {
+      fprintf( stderr, "Error while writing file %s\n", snapshot_file );
+      exit( EXIT_FAILURE );
+    }
   fclose( out );
 }
 
@@ -451,7 +1347,7 @@ void writeDot( const char * dot_file_name,
 static void printNode( Nodeptr node )
 {
   printf("    [%3d ] %s layer=%d position=%d up=%d down=%d up_x=%d down_x=%d\n",
-         node->id, node->name, node->layer, node->position,
+         node->id, NODE_NAME( node ), node->layer, node->position,
          node->up_degree, node->down_degree,
          node->up_crossings, node->down_crossings );
   printf("      ^^^^up");
@@ -459,7 +1355,7 @@ static void printNode( Nodeptr node )
   for( ; i < node->up_degree; i++ )
     {
       Edgeptr edge = node->up_edges[i];
-      printf(" %s", edge->up_node->name );
+      printf(" %s", NODE_NAME( edge->up_node ) );
     }
   printf("\n");
   printf("      __down");
@@ -467,7 +1363,7 @@ static void printNode( Nodeptr node )
   for( ; i < node->down_degree; i++ )
     {
       Edgeptr edge = node->down_edges[i];
-      printf(" %s", edge->down_node->name );
+      printf(" %s", NODE_NAME( edge->down_node ) );
     }
   printf("\n");
 }
@@ -475,20 +1371,20 @@ static void printNode( Nodeptr node )
 static void printLayer( int layer )
 {
   printf("  --- layer %d nodes=%d fixed=%d\n",
-         layer, layers[layer]->number_of_nodes, layers[layer]->fixed );
+         layer, CTX(layers)[layer]->node_count, CTX(layers)[layer]->fixed );
   int node = 0;
-  for( ; node < layers[layer]->number_of_nodes; node++ )
+  for( ; node < CTX(layers)[layer]->node_count; node++ )
     {
-      printNode( layers[layer]->nodes[node] );
+      printNode( CTX(layers)[layer]->nodes[node] );
     }
 }
 
 void printGraph()
 {
   printf("+++ begin-graph %s nodes=%d, layers=%d\n",
-         graph_name, number_of_nodes, number_of_layers);
+         CTX(graph_name), CTX(number_of_nodes), CTX(number_of_layers));
   int layer = 0;
-  for( ; layer < number_of_layers; layer++ )
+  for( ; layer < CTX(number_of_layers); layer++ )
     {
       printLayer( layer );
     }
@@ -508,4 +1404,4 @@ int main( int argc, char * argv[] )
 
 #endif
 
-/*  [Last modified: 2014 09 10 at 14:34:28 GMT] */
+/*  [Last modified: 2026 10 16 at 18:53:46 GMT] */
@@ -12,16 +12,65 @@
 #ifndef GRAPH_IO_H
 #define GRAPH_IO_H
 
+#include<stdio.h>
 #include"graph.h"
 
 /**
  * Reads the graph from the given files, specified by their names. Each file
- * is read twice so that arrays can be allocated to the correct size on the
- * first pass. Also initializes all graph-related data structures and global
- * variables.
+ * is memory-mapped and scanned once, in place (see mapped_input.h); the
+ * edges are saved as pairs of node id's until all degrees are known and
+ * then put into the adjacency lists. Also initializes all graph-related
+ * data structures and global variables. A graph read earlier is released
+ * first - see freeGraph().
  */
 void readGraph( const char * dot_file, const char * ord_file );
 
+/**
+ * Same as readGraph(), but reads the graph, including the order of the
+ * nodes on each layer, from a single sgf file (see sgf.h). The node id's of
+ * the sgf file become the node names; the nodes are numbered in order of
+ * layer and position, as with an ord file.
+ */
+void readSgf( const char * sgf_file );
+
+/**
+ * Same as readGraph(), but reads the graph from a stream, e.g., standard
+ * input, that holds either an sgf file or a dot file followed by an ord
+ * file; which of the two it is follows from the first nonblank line. The
+ * stream is read once, to end of file, and scanned in memory, so it can be
+ * a pipe.
+ * @param stream_name the name of the stream used in error messages
+ * @return SGF or DOT_AND_ORD, depending on what the stream holds
+ */
+enum graph_format_enum readGraphStream( FILE * stream,
+                                        const char * stream_name );
+
+/**
+ * Same as readGraph(), but maps a snapshot file written by writeSnapshot()
+ * (see snapshot.h) and builds the graph from its arrays, without parsing or
+ * name lookup; the names of the nodes remain in the file, which stays
+ * mapped until the graph is released.
+ * @param order_name the name of a saved ordering in the snapshot in which
+ * the nodes are to be put on their layers; if NULL, the order is the one
+ * in which the graph was originally read
+ */
+void readSnapshot( const char * snapshot_file, const char * order_name );
+
+/**
+ * Makes the graph of the current context a copy of the graph of the source
+ * context, in the same order, e.g., so that several runs can start from a
+ * graph that has been read only once; the node names are shared with the
+ * source, so the source graph must not be freed before the copy
+ */
+void copyGraph( RunContextptr source );
+
+/**
+ * Releases all memory occupied by the graph read by readGraph() in one
+ * step and resets the global variables, so that another graph can be read;
+ * data structures of other modules that refer to the graph become invalid.
+ */
+void freeGraph( void );
+
 /**
  * Prints the graph in a verbose format on standard output for debugging
  * purposes. May also be used for piping to a graphical trace later.
@@ -33,6 +82,31 @@ void printGraph();
  */
 void writeOrd( const char * ord_file );
 
+/**
+ * Writes the graph, with the current layer orderings, to an sgf file with
+ * the given name; the edges are in the order they were read and go from
+ * lower to upper layer.
+ */
+void writeSgf( const char * sgf_file );
+
+/**
+ * Writes the current layer orderings with writeSgf() if the graph format
+ * is SGF, with writeOrd() otherwise.
+ */
+void writeOrdering( const char * file_name );
+
+/**
+ * Writes a snapshot of the graph (see snapshot.h) to a file with the given
+ * name. The nodes are in the order in which the graph was read, regardless
+ * of the current order.
+ * @param order_count the number of saved orderings to be included
+ * @param orders the orderings; see order.h
+ * @param order_names their names, which identify them for readSnapshot()
+ */
+void writeSnapshot( const char * snapshot_file, int order_count,
+                    const struct order_struct * const * orders,
+                    const char * const * order_names );
+
 /**
  * Writes a dot file with the given name.
  * @param dot_file_name the output file name (including .dot extension)
@@ -42,7 +116,7 @@ void writeOrd( const char * ord_file );
  * @param edge_list_length length of the edge list
  */
 void writeDot( const char * dot_file_name,
-               const char * graph_name,
+               const char * name_of_graph,
                const char * header_information,
                const Edgeptr * edge_list,
                int edge_list_length
@@ -59,4 +133,4 @@ void renumberNodesUsingDotFile( const char * dot_file );
 
 #endif
 
-/*  [Last modified: 2016 02 16 at 20:06:09 GMT] */
+/*  [Last modified: 2026 10 16 at 16:51:03 GMT] */
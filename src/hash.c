@@ -5,7 +5,11 @@
  * @date 2008/12/21
  * $Id: hash.c 2 2011-06-07 19:50:41Z mfms $
  *
- * Uses a polynomial hash function.
+ * Open addressing with linear probing in a table whose size is a power of
+ * two, so that the index is obtained by masking rather than division. Each
+ * entry keeps the length of its name and the high half of its 64-bit hash
+ * value (a fingerprint), so that a probe of an entry with a different name
+ * is almost always settled without looking at the name itself.
  */
 
 #include"defs.h"
@@ -13,190 +17,266 @@
 #include<stdlib.h>
 #include<stdio.h>
 #include<string.h>
+#include<stdint.h>
 
 #define LOAD_FACTOR 0.75
-#define POLYNOMIAL_VALUE 37
 #define MIN_TABLE_SIZE 8
 
 /**
- * 2^k - 1 where k is chosen to give the right table size; this is also a the
- * table size.
+ * Constants of the hash function: the multiplier is 2^64 divided by the
+ * golden ratio, the others are those of the MurmurHash3 finalizer
  */
-static unsigned int modulus;
+#define HASH_MULTIPLIER 0x9e3779b97f4a7c15ULL
+#define FINAL_MULTIPLIER_1 0xff51afd7ed558ccdULL
+#define FINAL_MULTIPLIER_2 0xc4ceb9fe1a85ec53ULL
 
-static Nodeptr * hash_table = NULL;
-
-// for statistics
-static int number_of_probes = 0;
-static int number_of_accesses = 0;
+struct hash_entry {
+  /** high 32 bits of the hash value of the name */
+  uint32_t fingerprint;
+  uint32_t length;
+  /** '\0'-terminated copy of the name; NULL if the entry is empty */
+  const char * name;
+  Nodeptr node;
+};
 
 /**
- * Computes a suitable table size (modulus) based on a given desired number
- * of entries. The choice used here is a power of two minus one.
+ * The table, CTX(hash_table), and the copies of the names,
+ * CTX(hash_name_arena), are part of the run context - see context.h.
+ * CTX(hash_mask) is the table size - 1, where the table size is a power of
+ * two. CTX(number_of_entries) is the number of nodes in the table; the
+ * table is doubled in size when this would exceed LOAD_FACTOR times the
+ * table size. CTX(number_of_probes), CTX(number_of_accesses) and
+ * CTX(number_of_false_matches) are for statistics.
  */
-static unsigned int getTableSize( int entries );
 
 /**
- * Compute the reverse of a string
- * @param reversed a buffer to hold the reversed version (destination)
- * @param original the original string
+ * Computes a suitable table size based on a given desired number of
+ * entries. The choice used here is a power of two.
  */
-static void reverse( char * reversed, const char * original );
+static unsigned int getTableSize( int entries );
 
 /**
- * Calculates the hash value of a given node name. Overflow doesn't
- * matter because this is supposed to be 'random' anyway.
- * The name is reversed because most node names have common prefixes.
+ * Calculates the hash value of a given node name, name[0], ...,
+ * name[length - 1]; the name is consumed eight bytes at a time and all bits
+ * of the result depend on all bytes of the name, so that names that share
+ * long prefixes, as most node names do, are spread well.
  */
-static unsigned int hashValue( const char * name );
+static uint64_t hashValue( const char * name, int length );
 
 /**
- * Computes an index into the table from the name.
+ * @param name The name of a node, not necessarily terminated by '\0'
+ * @param length The length of the name
+ * @param hash The hash value of the name
+ * @return the entry where the node has been found or the first empty entry
+ * after the hash value of the name.
  */
-static unsigned int hashIndex( const char * name );
+static struct hash_entry * getEntry( const char * name, int length,
+                                     uint64_t hash );
 
 /**
- * @param name The name of a node
- * @return the index of the position in the hash table where the node has
- * been found or of the first empty position after the hash value of the name. 
+ * Doubles the size of the table and reinserts all the nodes
  */
-static unsigned int getIndex( const char * name );
+static void growHashTable( void );
 
 #ifdef DEBUG
 static void printHashTable();
 #endif
 
-void initHashTable( int number_of_items )
+static struct hash_entry * allocateTable( unsigned int size )
 {
-  modulus = getTableSize( number_of_items );
-  hash_table = (Nodeptr *) calloc( modulus, sizeof(Nodeptr) );
-  // the following is not really necessary since calloc fills the allocated
-  // memory with 0's, but it doesn't hurt to be careful
-  int i = 0;
-  for( ; i < modulus; i++ ) hash_table[i] = NULL;
-  number_of_probes = 0;
-  number_of_accesses = 0;
+  struct hash_entry * table
+    = (struct hash_entry *) calloc( size, sizeof(struct hash_entry) );
+  if ( table == NULL )
+    {
+      fprintf( stderr, "FATAL: hash table, unable to allocate %u entries\n",
+               size );
+      abort();
+    }
+  return table;
 }
 
-void insertInHashTable( const char * name, Nodeptr node )
+void initHashTable( int number_of_items, Arenaptr arena )
 {
-  unsigned int index = getIndex( name );
-  if( hash_table[index] != NULL )
+  unsigned int table_size = getTableSize( number_of_items );
+  CTX(hash_mask) = table_size - 1;
+  CTX(hash_table) = allocateTable( table_size );
+  CTX(hash_name_arena) = arena;
+  CTX(number_of_entries) = 0;
+  CTX(number_of_probes) = 0;
+  CTX(number_of_accesses) = 0;
+  CTX(number_of_false_matches) = 0;
+}
+
+char * insertInHashTable( const char * name, int length, Nodeptr node )
+{
+  if ( CTX(number_of_entries) + 1 > LOAD_FACTOR * ( CTX(hash_mask) + 1 ) )
+    growHashTable();
+  uint64_t hash = hashValue( name, length );
+  struct hash_entry * entry = getEntry( name, length, hash );
+  if( entry->name != NULL )
     {
-      fprintf( stderr, "insertInHashTable: Entry for '%s' already exists\n",
-               name );
+      fprintf( stderr, "insertInHashTable: Entry for '%.*s' already exists\n",
+               length, name );
       abort();
     }
-  hash_table[index] = node;
+  char * copy = arena_strndup( CTX(hash_name_arena), name, length );
+  entry->fingerprint = (uint32_t) ( hash >> 32 );
+  entry->length = length;
+  entry->name = copy;
+  entry->node = node;
+  CTX(number_of_entries)++;
 #ifdef DEBUG
-  printf("*** insert: name='%s' node->name='%s' position=%u"
-         " index=%u value=%u\n",
-         name, node->name, hashIndex(name), index, hashValue(name) );
+  printf("*** insert: name='%s' position=%u index=%u value=%llx\n",
+         copy, (unsigned int) ( hash & CTX(hash_mask) ),
+         (unsigned int) ( entry - CTX(hash_table) ),
+         (unsigned long long) hash );
   printHashTable();
   printf("***\n");
 #endif
+  return copy;
 }
 
 Nodeptr getFromHashTable( const char * name )
 {
-  unsigned int index = getIndex( name );
-  return hash_table[index];
+  return getFromHashTableWithLength( name, strlen( name ) );
+}
+
+Nodeptr getFromHashTableWithLength( const char * name, int length )
+{
+  return getEntry( name, length, hashValue( name, length ) )->node;
 }
 
 void removeHashTable()
 {
-  free(hash_table);
+  free(CTX(hash_table));
+  CTX(hash_table) = NULL;
 }
 
 double getAverageNumberOfProbes()
 {
-  return ((double) number_of_probes) / number_of_accesses;
+  if ( CTX(number_of_accesses) == 0 ) return 0;
+  return ((double) CTX(number_of_probes)) / CTX(number_of_accesses);
+}
+
+long getNumberOfHashAccesses()
+{
+  return CTX(number_of_accesses);
+}
+
+long getNumberOfFalseMatches()
+{
+  return CTX(number_of_false_matches);
 }
 
 #ifdef DEBUG
 static void printHashTable()
 {
-  printf("--\n hash_table, size = %u\n", modulus);
-  int i = 0;
-  for( ; i < modulus; i++ )
+  printf("--\n hash_table, size = %u\n", CTX(hash_mask) + 1);
+  unsigned int i = 0;
+  for( ; i <= CTX(hash_mask); i++ )
     {
-      if( hash_table[i] == NULL ) printf("  0\n");
-      else printf("  %4d: '%s' position=%u index=%u value=%u\n",
-                  i, hash_table[i]->name,
-                  hashIndex( hash_table[i]->name ),
-                  getIndex( hash_table[i]->name ),
-                  hashValue( hash_table[i]->name )
-                  );
+      const struct hash_entry * entry = CTX(hash_table) + i;
+      if( entry->name == NULL ) printf("  0\n");
+      else printf("  %4u: '%s' length=%u fingerprint=%08x node=%d\n",
+                  i, entry->name, entry->length, entry->fingerprint,
+                  entry->node->id );
     }
   printf("--\n");
 }
 #endif
 
+static void growHashTable( void )
+{
+  struct hash_entry * old_table = CTX(hash_table);
+  unsigned int old_size = CTX(hash_mask) + 1;
+  CTX(hash_mask) = 2 * old_size - 1;
+  CTX(hash_table) = allocateTable( CTX(hash_mask) + 1 );
+  // the names are distinct, so each node goes into the first empty
+  // position; the index is recovered from the name, the fingerprint only
+  // gives the high half of the hash value. These probes are not counted in
+  // the statistics.
+  for ( unsigned int i = 0; i < old_size; i++ )
+    {
+      if ( old_table[i].name == NULL ) continue;
+      unsigned int index
+        = (unsigned int) hashValue( old_table[i].name, old_table[i].length )
+        & CTX(hash_mask);
+      while ( CTX(hash_table)[ index ].name != NULL )
+        index = (index + 1) & CTX(hash_mask);
+      CTX(hash_table)[ index ] = old_table[i];
+    }
+  free( old_table );
+}
+
 static unsigned int getTableSize( int entries )
 {
   int target_value = (int) (entries / LOAD_FACTOR);
   unsigned int table_size = MIN_TABLE_SIZE;
   for( ; table_size < target_value; table_size *= 2 );
-  return table_size - 1;
+  return table_size;
 }
 
-static void reverse( char * reversed, const char * original )
+static uint64_t hashValue( const char * name, int length )
 {
-  char * rev_ptr = reversed;
-  const char * org_ptr = original + strlen(original) - 1;
-  // store the reverse of the string in buffer
-  for( ; org_ptr >= original; org_ptr-- )
+  uint64_t value = (uint64_t) length * HASH_MULTIPLIER;
+  const char * end = name + length;
+  uint64_t word;
+  for ( ; end - name >= 8; name += 8 )
     {
-      * rev_ptr++ = * org_ptr;
+      memcpy( & word, name, 8 );
+      value = ( value ^ word ) * HASH_MULTIPLIER;
+      value ^= value >> 29;
     }
-  * rev_ptr = '\0';
-}
-
-static unsigned int hashValue( const char * name )
-{
-  char rev_buf[MAX_NAME_LENGTH];
-  reverse( rev_buf, name );
-  char * rev_ptr = rev_buf;
-  unsigned int value = 0;
-  for( ; * rev_ptr != '\0'; rev_ptr++ )
+  if ( name < end )
     {
-      value = (value + POLYNOMIAL_VALUE * value + * rev_ptr);
+      word = 0;
+      memcpy( & word, name, end - name );
+      value = ( value ^ word ) * HASH_MULTIPLIER;
     }
+  value ^= value >> 33;
+  value *= FINAL_MULTIPLIER_1;
+  value ^= value >> 33;
+  value *= FINAL_MULTIPLIER_2;
+  value ^= value >> 33;
   return value;
 }
 
-static unsigned int hashIndex( const char * name )
-{
-  return hashValue( name ) % modulus;
-}
-
-static unsigned int getIndex( const char * name )
+static struct hash_entry * getEntry( const char * name, int length,
+                                     uint64_t hash )
 {
-  number_of_accesses++;
-  unsigned int index = hashIndex( name );
-  number_of_probes++;
-  while( hash_table[ index ] != NULL
-         && strcmp( name, hash_table[ index ]->name ) != 0 )
+  CTX(number_of_accesses)++;
+  uint32_t fingerprint = (uint32_t) ( hash >> 32 );
+  unsigned int index = (unsigned int) hash & CTX(hash_mask);
+  for ( ; ; index = (index + 1) & CTX(hash_mask) )
     {
-      index = (index + 1) % modulus;
-      number_of_probes++;
+      struct hash_entry * entry = CTX(hash_table) + index;
+      CTX(number_of_probes)++;
+      if ( entry->name == NULL ) return entry;
+      if ( entry->fingerprint == fingerprint && entry->length == length )
+        {
+          if ( memcmp( entry->name, name, length ) == 0 ) return entry;
+          CTX(number_of_false_matches)++;
+        }
     }
-  return index;
 }
 
 #ifdef TEST
 int main()
 {
-  initHashTable( 7 );
+  Arenaptr arena = arena_create( 1024 );
+  initHashTable( 7, arena );
   char name[MAX_NAME_LENGTH];
   fgets( name, MAX_NAME_LENGTH, stdin );
   name[ strlen(name) - 1 ] = '\0';
   Nodeptr new_node = (Nodeptr) malloc( sizeof(struct node_struct));
-  new_node->name = (char *) malloc( strlen(name) + 1 );
-  strcpy( new_node->name, name );
-  insertInHashTable( name, new_node );
+  new_node->id = 0;
+  CTX(node_names) = (char **) malloc( sizeof(char *) );
+  CTX(node_names)[0] = insertInHashTable( name, strlen( name ), new_node );
+  printf( "'%s' -> %d\n", CTX(node_names)[0], getFromHashTable( name )->id );
+  removeHashTable();
+  arena_free( arena );
   return 0;
 }
 #endif
 
-/*  [Last modified: 2008 12 29 at 16:35:13 GMT] */
+/*  [Last modified: 2026 10 16 at 16:32:56 GMT] */
@@ -1,6 +1,7 @@
 /**
  * @file hash.h
- * @brief A simple map based on a hash table, maps names to node pointers
+ * @brief A simple map based on a hash table, maps names to node pointers;
+ * the names are interned, i.e., the table keeps its own copy of each name
  * @author Matthias Stallmann
  * @date 2008/12/21
  * $Id: hash.h 2 2011-06-07 19:50:41Z mfms $
@@ -11,18 +12,23 @@
 
 #include"defs.h"
 #include"graph.h"
+#include"arena.h"
 
 /**
  * Initializes the hash table so that it can "comfortably" accommodate the
- * given number of items
+ * given number of items; the table grows if more items are inserted
+ * @param name_arena the arena in which copies of the names are allocated;
+ * they outlive the table
  */
-void initHashTable( int number_of_items );
+void initHashTable( int number_of_items, Arenaptr name_arena );
 
 /**
- * Inserts A node into the hash table.
+ * Inserts a node into the hash table under the name name[0], ...,
+ * name[length - 1], which need not be terminated by '\0'.
  * Assumes that the node is not already present (fatal error otherwise)
+ * @return the copy of the name kept by the table, terminated by '\0'
  */
-void insertInHashTable( const char * name, Nodeptr node );
+char * insertInHashTable( const char * name, int length, Nodeptr node );
 
 /**
  * Retrieves a node from the table, given its name
@@ -31,15 +37,36 @@ void insertInHashTable( const char * name, Nodeptr node );
 Nodeptr getFromHashTable( const char * name );
 
 /**
- * Deallocates the memory used by the table
+ * Same as getFromHashTable(), but the name is name[0], ..., name[length - 1]
+ * and need not be terminated by '\0', e.g., a slice of an input file
+ */
+Nodeptr getFromHashTableWithLength( const char * name, int length );
+
+/**
+ * Deallocates the memory used by the table, but not the names, which
+ * belong to the arena; the statistics below remain available
  */
 void removeHashTable();
 
 /**
- * @return The average number of probes per call to insert or get.
+ * @return The average number of probes per call to insert or get, 0 if
+ * there were none.
  */
 double getAverageNumberOfProbes();
 
+/**
+ * @return The number of calls to insert or get since the table was
+ * initialized
+ */
+long getNumberOfHashAccesses();
+
+/**
+ * @return The number of probes in which the fingerprint of a name matched
+ * that of the entry probed but the name did not; all other probes of
+ * nonempty entries are settled without comparing names
+ */
+long getNumberOfFalseMatches();
+
 #endif
 
-/*  [Last modified: 2008 12 22 at 15:56:44 GMT] */
+/*  [Last modified: 2026 10 16 at 16:32:56 GMT] */
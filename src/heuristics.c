@@ -24,6 +24,7 @@
 #include"min_crossings.h"
 #include"heuristics.h"
 #include"graph.h"
+#include"graph_core.h"
 #include"barycenter.h"
 #include"median.h"
 #include"dfs.h"
@@ -44,45 +45,36 @@
  */
 #define TRACE_FREQ_THRESHOLD 2
 
-int iteration = 0;
-int post_processing_iteration = 0;
-
-int min_crossings = INT_MAX;
-int post_processing_crossings = INT_MAX;
-int min_edge_crossings = INT_MAX;
-int min_crossings_iteration = -1;
-int min_edge_crossings_iteration = -1;
-
 /**
  * buffer for formatting all tracePrint strings
  */
-static char buffer[ MAX_NAME_LENGTH ];
+static __thread char buffer[ MAX_NAME_LENGTH ];
 
 
 #if ! defined( TEST )
 
 void createOrdFileName( char * output_file_name, const char * appendix )
 {
-  if ( output_base_name == NULL )
+  if ( OPTION(output_base_name) == NULL )
     {
-      output_base_name = "temp";
+      OPTION(output_base_name) = "temp";
       printf( "WARNING: no output base name specified, using %s\n", "temp" );
       printf( " Use -o to get something different\n" );
     }
-  strcpy( output_file_name, output_base_name );
+  strcpy( output_file_name, OPTION(output_base_name) );
   strcat( output_file_name, "-" );
-  strcat( output_file_name, preprocessor );
-  if( strcmp( preprocessor, "" ) != 0 
-      && strcmp( heuristic, "" ) != 0 )
+  strcat( output_file_name, OPTION(preprocessor) );
+  if( strcmp( OPTION(preprocessor), "" ) != 0 
+      && strcmp( OPTION(heuristic), "" ) != 0 )
     strcat( output_file_name, "+" );
-  strcat( output_file_name, heuristic );
+  strcat( output_file_name, OPTION(heuristic) );
   strcat( output_file_name, appendix );
-  strcat( output_file_name, ".ord" );
+  strcat( output_file_name, OPTION(graph_format) == SGF ? ".sgf" : ".ord" );
 }
 
 void createDotFileName( char * output_file_name, const char * appendix )
 {
-  strcpy( output_file_name, graph_name );
+  strcpy( output_file_name, CTX(graph_name) );
   if ( strcmp( appendix, "" ) != 0 )
     strcat( output_file_name, "-" );
   strcat( output_file_name, appendix );
@@ -113,22 +105,23 @@ static void trace_printer( int layer, const char * message )
           " | bottleneck %2d | best %2d | stretch %5.2f | best %5.2f"
           " | time %4.2f"
           " | %s\n",
-          tag, iteration, layer, number_of_crossings, total_crossings.best,
-          bottleneck_crossings, max_edge_crossings.best,
-          current_total_stretch, total_stretch.best,
+          tag, CTX(iteration), layer, number_of_crossings,
+          CTX(total_crossings).best,
+          bottleneck_crossings, CTX(max_edge_crossings).best,
+          current_total_stretch, CTX(total_stretch).best,
           RUNTIME, message );
 }
 
 void tracePrint( int layer, const char * message )
 {
-  static int previous_print_iteration = 0;
-  if ( trace_freq > 0 && iteration % trace_freq == 0 
-       && iteration > previous_print_iteration ) {
+  if ( OPTION(trace_freq) > 0 && CTX(iteration) % OPTION(trace_freq) == 0 
+       && CTX(iteration) > CTX(previous_print_iteration) ) {
     trace_printer( layer, message );
     if ( layer >= 0 )
-      previous_print_iteration = iteration;
+      CTX(previous_print_iteration) = CTX(iteration);
   }
-  else if ( trace_freq >= 0 && trace_freq <= TRACE_FREQ_THRESHOLD && layer < 0 ) {
+  else if ( OPTION(trace_freq) >= 0
+            && OPTION(trace_freq) <= TRACE_FREQ_THRESHOLD && layer < 0 ) {
       trace_printer( layer, message );
   }
 }
@@ -142,12 +135,15 @@ void tracePrint( int layer, const char * message )
 static bool no_improvement( void )
 {
   // avoid shortcut logic to make sure side effects really happen
-  bool better_total_crossings = has_improved_int( & total_crossings );
-  bool better_max_edge_crossings = has_improved_int( & max_edge_crossings );
-  bool better_total_stretch = has_improved_double( & total_stretch );
-  bool better_bottleneck_stretch = has_improved_double( & bottleneck_stretch );
+  bool better_total_crossings = has_improved_int( & CTX(total_crossings) );
+  bool better_max_edge_crossings
+    = has_improved_int( & CTX(max_edge_crossings) );
+  bool better_total_stretch = has_improved_double( & CTX(total_stretch) );
+  bool better_bottleneck_stretch
+    = has_improved_double( & CTX(bottleneck_stretch) );
 #ifdef FAVORED
-  bool better_favored_edge_crossings = has_improved( & favored_edge_crossings );
+  bool better_favored_edge_crossings
+    = has_improved( & CTX(favored_edge_crossings) );
 #endif
   return
     ! better_total_crossings
@@ -168,7 +164,7 @@ static void print_last_iteration_message( void )
 {
   // stopping early because of reaching max iterations even though
   // improvement has occurred
-  if ( iteration >= max_iterations 
+  if ( CTX(iteration) >= OPTION(max_iterations) 
        && ! no_improvement() )
     {
       /**
@@ -176,7 +172,7 @@ static void print_last_iteration_message( void )
        */
        printf( "*** still improving but max iterations or runtime reached:"
               " iteration %d, runtime %2.3f, graph %s\n",
-              iteration, RUNTIME, graph_name );
+              CTX(iteration), RUNTIME, CTX(graph_name) );
     }
 }
 
@@ -184,15 +180,15 @@ bool end_of_iteration( void )
 {
 #ifdef DEBUG
   printf( "-> end_of_iteration: iteration = %d, capture_iteration = %d\n",
-          iteration, capture_iteration );
+          CTX(iteration), OPTION(capture_iteration) );
 #endif
-  if( capture_iteration == iteration )
+  if( OPTION(capture_iteration) == CTX(iteration) )
     {
       char output_file_name[MAX_NAME_LENGTH];
       char appendix[MAX_NAME_LENGTH];
-      sprintf( appendix, "-%d", iteration );
+      sprintf( appendix, "-%d", CTX(iteration) );
       createOrdFileName( output_file_name, appendix );
-      writeOrd( output_file_name );
+      writeOrdering( output_file_name );
     }
 #ifdef DEBUG
   printf( " ### crossings at end of iteration:\n"
@@ -215,18 +211,19 @@ bool end_of_iteration( void )
 #ifdef MAX_EDGE
           maxEdgeCrossings(),
 #endif
-          total_crossings.best,
+          CTX(total_crossings).best,
 #ifdef MAX_EDGE
-          max_edge_crossings.best,
+          CTX(max_edge_crossings).best,
 #endif
-          total_crossings.best_heuristic_iteration
+          CTX(total_crossings).best_heuristic_iteration
 #ifdef MAX_EDGE
-          , max_edge_crossings.best_heuristic_iteration
+          , CTX(max_edge_crossings).best_heuristic_iteration
 #endif
           );
 #endif // DEBUG
   bool done = false;
-  if ( iteration >= max_iterations ||  RUNTIME >= max_runtime )
+  if ( CTX(iteration) >= OPTION(max_iterations)
+       ||  RUNTIME >= OPTION(max_runtime) )
     {
       done = true;
       print_last_iteration_message();
@@ -234,9 +231,9 @@ bool end_of_iteration( void )
   update_best_all();
 #ifdef DEBUG
   printf( "<- end_of_iteration: iteration = %d, max_iterations = %d, done = %d\n",
-          iteration, max_iterations, done );
+          CTX(iteration), OPTION(max_iterations), done );
 #endif
-  iteration++;
+  CTX(iteration)++;
   return done;
 }
 
@@ -247,23 +244,22 @@ bool end_of_iteration( void )
  */
 static void print_standard_termination_message()
 {
-  /** message already printed? */
-  static bool standard_termination_message_printed = false;
-
-  if ( ! standard_termination_message_printed )
+  // CTX(standard_termination_message_printed) is true if the message has
+  // already been printed
+  if ( ! CTX(standard_termination_message_printed) )
     {
       printf( "*** standard termination here: iteration %d crossings %d"
 #ifdef MAX_EDGE              
               " edge_crossings %d"
 #endif
               " graph %s ***\n",
-              iteration, total_crossings.best,
+              CTX(iteration), CTX(total_crossings).best,
 #ifdef MAX_EDGE
-              max_edge_crossings.best,
+              CTX(max_edge_crossings).best,
 #endif
-              graph_name );
+              CTX(graph_name) );
     }
-  standard_termination_message_printed = true;
+  CTX(standard_termination_message_printed) = true;
 }
 
 /**
@@ -284,28 +280,31 @@ static bool terminate()
   if ( no_improvement_seen )
     print_standard_termination_message();
 
-  if ( standard_termination && no_improvement_seen ) return true;
-  if ( iteration >= max_iterations ) return true;
+  if ( OPTION(standard_termination) && no_improvement_seen ) return true;
+  if ( CTX(iteration) >= OPTION(max_iterations) ) return true;
   return false;
 }
 
 #endif // ! defined( TEST )
 
 bool isFixedNode( Nodeptr node ) { return node->fixed; }
-bool isFixedEdge( Edgeptr edge ) { return edge->fixed; }
-bool isFixedLayer( int layer ) { return layers[layer]->fixed; }
+bool isFixedEdge( Edgeptr edge )
+{
+  return CTX(graph_core)->edge_fixed[ edge->id ];
+}
+bool isFixedLayer( int layer ) { return CTX(layers)[layer]->fixed; }
 void fixNode( Nodeptr node ) { node->fixed = true; }
-void fixEdge( Edgeptr edge ) { edge->fixed = true; }
-void fixLayer( int layer ) { layers[layer]->fixed = true; }
+void fixEdge( Edgeptr edge ) { CTX(graph_core)->edge_fixed[ edge->id ] = true; }
+void fixLayer( int layer ) { CTX(layers)[layer]->fixed = true; }
 bool allNodesFixed( void )
 {
   int layer = 0;
-  for( ; layer < number_of_layers; layer++ )
+  for( ; layer < CTX(number_of_layers); layer++ )
     {
       int position = 0;
-      for( ; position < layers[ layer ]->number_of_nodes; position++ )
+      for( ; position < CTX(layers)[ layer ]->node_count; position++ )
         {
-          Nodeptr node = layers[ layer ]->nodes[ position ];
+          Nodeptr node = CTX(layers)[ layer ]->nodes[ position ];
           if( ! isFixedNode( node ) ) return false;
         }
     }
@@ -315,42 +314,33 @@ bool allNodesFixed( void )
 void clearFixedNodes( void )
 {
   int layer = 0;
-  for( ; layer < number_of_layers; layer++ )
+  for( ; layer < CTX(number_of_layers); layer++ )
     {
       int position = 0;
-      for( ; position < layers[ layer ]->number_of_nodes; position++ )
+      for( ; position < CTX(layers)[ layer ]->node_count; position++ )
         {
-          Nodeptr node = layers[ layer ]->nodes[ position ];
+          Nodeptr node = CTX(layers)[ layer ]->nodes[ position ];
           node->fixed = false;
         }
     }
+  resetMaxCrossingsNode();
 }
 
 void clearFixedEdges( void )
 {
-  int layer = 1;
-  for( ; layer < number_of_layers; layer++ )
+  for( int edge_id = 0; edge_id < CTX(number_of_edges); edge_id++ )
     {
-      int node_position = 0;
-      for( ; node_position < layers[ layer ]->number_of_nodes; node_position++ )
-        {
-          Nodeptr node = layers[ layer ]->nodes[ node_position ];
-          int edge_position = 0;
-          for( ; edge_position < node->down_degree; edge_position++ )
-            {
-              Edgeptr edge = node->down_edges[ edge_position ];
-              edge->fixed = false;
-            }
-        }
+      CTX(graph_core)->edge_fixed[ edge_id ] = false;
     }
+  resetMaxCrossingsEdge();
 }
 
 void clearFixedLayers( void )
 {
   int layer = 0;
-  for( ; layer < number_of_layers; layer++ )
+  for( ; layer < CTX(number_of_layers); layer++ )
     {
-      layers[ layer ]->fixed = false;
+      CTX(layers)[ layer ]->fixed = false;
     }
 }
 
@@ -358,9 +348,9 @@ int totalDegree( int layer )
 {
   int total = 0;
   int position = 0;
-  for( ; position < layers[ layer ]->number_of_nodes; position++ )
+  for( ; position < CTX(layers)[ layer ]->node_count; position++ )
     {
-      Nodeptr node = layers[ layer ]->nodes[ position ];
+      Nodeptr node = CTX(layers)[ layer ]->nodes[ position ];
       total += node->up_degree + node->down_degree;
     }
   return total;
@@ -371,7 +361,7 @@ int maxDegreeLayer( void )
   int max_deg_layer = -1;
   int max_deg = -1;
   int layer = 0;
-  for( ; layer < number_of_layers; layer++ )
+  for( ; layer < CTX(number_of_layers); layer++ )
     {
       int layer_degree = totalDegree( layer );
       if ( layer_degree > max_deg )
@@ -388,12 +378,12 @@ Nodeptr maxDegreeNode( void )
   int layer = 0;
   int max_degree = 0;
   Nodeptr max_degree_node = NULL;
-  for( ; layer < number_of_layers; layer++ )
+  for( ; layer < CTX(number_of_layers); layer++ )
     {
       int position = 0;
-      for( ; position < layers[ layer ]->number_of_nodes; position++ )
+      for( ; position < CTX(layers)[ layer ]->node_count; position++ )
         {
-          Nodeptr node = layers[ layer ]->nodes[ position ];
+          Nodeptr node = CTX(layers)[ layer ]->nodes[ position ];
           if ( DEGREE( node ) > max_degree )
             {
               max_degree = DEGREE( node );
@@ -419,7 +409,7 @@ void median( void )
       // sweep functions
       if ( medianUpSweep( 1 ) )
         return;
-      if ( medianDownSweep( number_of_layers - 2 ) )
+      if ( medianDownSweep( CTX(number_of_layers) - 2 ) )
         return;
       tracePrint( -1, "--- median end of pass" );
     }
@@ -434,7 +424,7 @@ void barycenter( void )
       // sweep functions
       if ( barycenterUpSweep( 1 ) )
         return;
-      if ( barycenterDownSweep( number_of_layers - 2 ) )
+      if ( barycenterDownSweep( CTX(number_of_layers) - 2 ) )
         return;
       tracePrint( -1, "--- bary end of pass" );
     }
@@ -472,22 +462,97 @@ void modifiedBarycenter( void )
 }
 
 /**
- * @todo For the following variations of barycenter, staticBarycenter() and
- * evenOddBarycenter(), which are intended to be parallelized, it would be
- * useful to have a global variable 'number_of_processors' to govern when the
- * end of an iteration takes place. The current code assumes that the number
- * of processors is unlimited, but synchronization and capture of current
- * minimum takes place only at synchronization points, i.e., calls to
- * end_of_iteration().
+ * The parallel barycenter versions below alternate between a parallel
+ * phase, in which a set of layers is sorted and the crossings are updated,
+ * and a serial synchronization phase, in which the layers are traced and
+ * the end of an iteration is recorded. A layer's weights depend only on the
+ * positions of its neighbors, and crossing updates for layers at least two
+ * apart write disjoint channels and disjoint fields of the nodes between
+ * them, so the results do not depend on the number of OpenMP threads (-m).
  *
- * The mechanism would count local_iterations and do something like:<br>
- *      if ( local_iterations % number_of_processors == 0 )
- *         end_of_iteration();
- * <br>
- * local_iterations would be updated in the body of each for loop that is
- *      intended to be parallelized (and effects a change) and the above code
- *      woul occur at the end of such a loop
+ * If number_of_processors is 1 each layer is a phase of its own, i.e., the
+ * parallel algorithm is simulated with one processor and end_of_iteration()
+ * is called after each layer; otherwise (0 means unlimited) it is called
+ * only at the end of each phase.
+ */
+
+/**
+ * CTX(phase_layers) holds the layers sorted during the current phase;
+ * allocated by the first phase
+ */
+
+/**
+ * Puts the layers start_layer, start_layer + 2, ... into phase_layers
+ * @return the number of layers
+ */
+static int alternate_layers( int start_layer )
+{
+  if ( CTX(phase_layers) == NULL )
+    CTX(phase_layers) = (int *) malloc( CTX(number_of_layers) * sizeof(int) );
+  int count = 0;
+  for ( int layer = start_layer; layer < CTX(number_of_layers); layer += 2 )
+    CTX(phase_layers)[ count++ ] = layer;
+  return count;
+}
+
+/**
+ * The parallel part of a phase: computes weights for, sorts, and updates
+ * crossings for each of the given layers, which must be at least two apart
+ */
+static void sort_layers_in_parallel( const int * layer_list, int count,
+                                     Orientation orientation )
+{
+  // the queues for maxCrossingsNode() and maxCrossingsEdge() are shared,
+  // and so are the positions of the layers between the ones being sorted
+  suspendQueueUpdates();
+  refreshAllPositions();
+  int i;
+#ifdef _OPENMP
+#pragma omp parallel for default(none) private(i) \
+  shared(layer_list, count, orientation) copyin(current_context) \
+  if(count > 1) schedule(dynamic)
+#endif
+  for ( i = 0; i < count; i++ )
+    {
+      int layer = layer_list[i];
+      barycenterWeights( layer, orientation );
+      layerSort( layer );
+      updateCrossingsForLayer( layer );
+    }
+  resumeQueueUpdates();
+}
+
+/**
+ * Sorts the given layers, which must be at least two apart, and traces each
+ * of them with the given message; calls end_of_iteration() after each layer
+ * if number_of_processors is 1; otherwise the caller is expected to call it
+ * at the end of the phase. With one processor the layers are simply sorted
+ * one after the other, as in the sequential heuristics, without suspending
+ * the queues.
+ * @return true if max_iterations reached
  */
+static bool barycenter_phase( const int * layer_list, int count,
+                              Orientation orientation, const char * message )
+{
+  if ( OPTION(number_of_processors) == 1 )
+    {
+      for ( int i = 0; i < count; i++ )
+        {
+          int layer = layer_list[i];
+          barycenterWeights( layer, orientation );
+          layerSort( layer );
+          updateCrossingsForLayer( layer );
+          tracePrint( layer, message );
+          if ( end_of_iteration() )
+            return true;
+        }
+      return false;
+    }
+  sort_layers_in_parallel( layer_list, count, orientation );
+  for ( int i = 0; i < count; i++ )
+    tracePrint( layer_list[i], message );
+  return false;
+}
 
 void staticBarycenter( void )
 {
@@ -496,19 +561,42 @@ void staticBarycenter( void )
     {
       // sort all layers independently (in parallel) and do a sweep - doesn't
       // matter which direction
-      for ( int layer = 0; layer < number_of_layers; layer++ )
+      int layer;
+      refreshAllPositions();
+#ifdef _OPENMP
+#pragma omp parallel for default(none) private(layer) \
+  copyin(current_context) schedule(dynamic)
+#endif
+      for ( layer = 0; layer < CTX(number_of_layers); layer++ )
         {
           barycenterWeights( layer, BOTH );
         }
-      for ( int layer = 0; layer < number_of_layers; layer++ )
+      if ( OPTION(number_of_processors) == 1 )
+        {
+          for ( layer = 0; layer < CTX(number_of_layers); layer++ )
+            {
+              layerSort( layer );
+              updateCrossingsForLayer( layer );
+              tracePrint( layer, "static barycenter" );
+              if ( end_of_iteration() )
+                return;
+            }
+          continue;
+        }
+      // neighboring layers share channels, so crossings are updated after
+      // all layers are sorted
+#ifdef _OPENMP
+#pragma omp parallel for default(none) private(layer) \
+  copyin(current_context) schedule(dynamic)
+#endif
+      for ( layer = 0; layer < CTX(number_of_layers); layer++ )
         {
           layerSort( layer );
-          updateCrossingsForLayer( layer );
-          tracePrint( layer, "static barycenter" );
-          if ( number_of_processors == 1 && end_of_iteration() )
-            return;
         }
-      if ( number_of_processors != 1 && end_of_iteration() )
+      updateAllCrossings();
+      for ( layer = 0; layer < CTX(number_of_layers); layer++ )
+        tracePrint( layer, "static barycenter" );
+      if ( end_of_iteration() )
         return;
     }
 }
@@ -521,41 +609,22 @@ void staticBarycenter( void )
  * option.
  */
 void evenOddBarycenter( void ) {
-  int layer;
   tracePrint( -1, "*** start odd/even barycenter" );
   while ( ! terminate() ) {
       // compute weights, then sort the odd layers
-#ifdef _OPENMP
-#pragma omp parallel for default(none) private(layer) \
-  shared(number_of_layers, trace_freq, number_of_processors)
-#endif
-      for ( layer = 1; layer < number_of_layers; layer += 2 ) {
-          barycenterWeights( layer, BOTH );
-          layerSort( layer );
-          updateCrossingsForLayer( layer );
-          tracePrint( layer, "odd layers" );
-          if ( number_of_processors == 1 && end_of_iteration() )
-            return;
-      }
+      int count = alternate_layers( 1 );
+      if ( barycenter_phase( CTX(phase_layers), count, BOTH, "odd layers" ) )
+        return;
       tracePrint( -1, "--- evenOddBarycenter end of iteration" );
-      if ( number_of_processors != 1 && end_of_iteration() )
+      if ( OPTION(number_of_processors) != 1 && end_of_iteration() )
         return;
 
       // ditto for the even layers
-#ifdef _OPENMP
-#pragma omp parallel for default(none) private(layer) \
-  shared(number_of_layers, trace_freq, number_of_processors)
-#endif
-      for ( layer = 0; layer < number_of_layers; layer += 2 ) {
-          barycenterWeights( layer, BOTH );
-          layerSort( layer );
-          updateCrossingsForLayer( layer );
-          tracePrint( layer, "evenlayers" );
-          if ( number_of_processors == 1 && end_of_iteration() )
-            return;
-      }
+      count = alternate_layers( 0 );
+      if ( barycenter_phase( CTX(phase_layers), count, BOTH, "evenlayers" ) )
+        return;
       tracePrint( -1, "--- evenOddBarycenter end of iteration" );
-      if ( number_of_processors != 1 && end_of_iteration() )
+      if ( OPTION(number_of_processors) != 1 && end_of_iteration() )
         return;
     }
 }
@@ -571,32 +640,20 @@ void upDownBarycenter( void ) {
   tracePrint( -1, "*** start up/down barycenter" );
   Orientation sort_direction = DOWNWARD;
   while ( ! terminate() ) {
-      // compute weights, then sort the odd layers
-#ifdef _OPENMP
-#pragma omp parallel for default(none) private(layer) \
-  shared(number_of_layers, trace_freq, number_of_processors)
-#endif
     int start_layer = 1;          /* 1 for odd, 0 for even */
-    for ( int i = 0; i < number_of_layers; i++ ) {
-      for ( int layer = start_layer; layer < number_of_layers; layer += 2 ) {
-        barycenterWeights( layer, sort_direction );
-        layerSort( layer );
-        updateCrossingsForLayer( layer );
-        char buffer[LINE_LENGTH+1];
-        sprintf( buffer, "odd/even = %d, direction = %d",
-                 start_layer, sort_direction );
-        tracePrint( layer, buffer );
-        if ( number_of_processors == 1 && end_of_iteration() )
-          return;
-      } // end, sort either odd or even layers
+    for ( int i = 0; i < CTX(number_of_layers); i++ ) {
+      // compute weights, then sort either the odd or the even layers
+      char buffer[LINE_LENGTH+1];
+      sprintf( buffer, "odd/even = %d, direction = %d",
+               start_layer, sort_direction );
+      int count = alternate_layers( start_layer );
+      if ( barycenter_phase( CTX(phase_layers), count, sort_direction,
+                             buffer ) )
+        return;
       tracePrint( -1, "--- upDownBaryCenter, end of iteration" );
-      if ( number_of_processors != 1 && end_of_iteration() )
+      if ( OPTION(number_of_processors) != 1 && end_of_iteration() )
         return;
       start_layer = 1 - start_layer;
-#ifdef _OPENMP
-#pragma omp parallel for default(none) private(layer) \
-      shared(number_of_layers, trace_freq, number_of_processors)
-#endif
     } // end, do number_of_layers times
     if ( sort_direction == DOWNWARD ) sort_direction = UPWARD;
     else sort_direction = DOWNWARD;
@@ -604,8 +661,8 @@ void upDownBarycenter( void ) {
 } // end, upDownBarycenter
 
 /**
- * Does the parallel part of each iteration of the slabBarycenter algorithm
- * below.
+ * Does each iteration of the slabBarycenter algorithm below: sorts a layer
+ * in each slab; the layers are slab_size >= 2 apart, so this is a phase.
  * @param offset how far above the bottom of the slab each layer to be sorted is
  * @return true if this iteration is to be the last one
  */
@@ -613,30 +670,26 @@ static bool slab_bary_iteration( int offset,
                                  int slab_size,
                                  Orientation sort_direction ) {
   char buffer[LINE_LENGTH+1];
+  if ( CTX(phase_layers) == NULL )
+    CTX(phase_layers) = (int *) malloc( CTX(number_of_layers) * sizeof(int) );
+  int count = 0;
   for ( int slab_bottom = 0;
-        slab_bottom < number_of_layers - 1;
+        slab_bottom < CTX(number_of_layers) - 1;
         slab_bottom += slab_size ) {
-    int layer = (slab_bottom + offset) % number_of_layers;
+    int layer = (slab_bottom + offset) % CTX(number_of_layers);
     if ( ( sort_direction == DOWNWARD && layer == 0 )
-         || ( sort_direction == UPWARD && layer == number_of_layers - 1 )
+         || ( sort_direction == UPWARD && layer == CTX(number_of_layers) - 1 )
          ) continue;
-    barycenterWeights( layer, sort_direction );
-    layerSort( layer );
-    updateCrossingsForLayer( layer );
-    sprintf( buffer, "offset = %d, slab_bottom = %d, direction = %d",
-             offset, slab_bottom, sort_direction );
-    tracePrint( layer, buffer );
-    if ( number_of_processors == 1 && end_of_iteration() )
-      return true;
-  } // end, sort a layer in each slab
+    CTX(phase_layers)[ count++ ] = layer;
+  } // end, find a layer in each slab
+  sprintf( buffer, "offset = %d, slab_size = %d, direction = %d",
+           offset, slab_size, sort_direction );
+  if ( barycenter_phase( CTX(phase_layers), count, sort_direction, buffer ) )
+    return true;
   sprintf( buffer, "--- slabBarycenter, end of iteration, offset = %d", offset );
   tracePrint( -1, buffer );
-  if ( number_of_processors != 1 && end_of_iteration() )
+  if ( OPTION(number_of_processors) != 1 && end_of_iteration() )
     return true;
-#ifdef _OPENMP
-#pragma omp parallel for default(none) private(layer) \
-  shared(number_of_layers, trace_freq, number_of_processors)
-#endif
   return false;
 }
 
@@ -647,21 +700,17 @@ static bool slab_bary_iteration( int offset,
  * each iteration.
  */
 void slabBarycenter( void ) {
-  int slab_size = number_of_layers;
-  if ( number_of_processors > 1 ) slab_size /= number_of_processors;
+  int slab_size = CTX(number_of_layers);
+  if ( OPTION(number_of_processors) > 1 )
+    slab_size /= OPTION(number_of_processors);
   if ( slab_size < 2 ) slab_size = 2;
   char buffer[LINE_LENGTH+1];
   sprintf( buffer, "*** start slab barycenter, slab size = %d", slab_size );
   tracePrint( -1, buffer );
   while ( ! terminate() ) {
-      // compute weights, then sort the odd layers
-#ifdef _OPENMP
-#pragma omp parallel for default(none) private(layer) \
-  shared(number_of_layers, trace_freq, number_of_processors)
-#endif
     // first do an upsweep in each slab
     // use the bottom layer of the next slab up as well
-    for ( int offset = 1; offset < number_of_layers; offset++ ) {
+    for ( int offset = 1; offset < CTX(number_of_layers); offset++ ) {
       bool no_more_iterations
         = slab_bary_iteration( offset, slab_size, DOWNWARD );
       if ( no_more_iterations ) return;
@@ -688,29 +737,16 @@ void rotatingBarycenter( void ) {
   Orientation sort_direction = BOTH;
   int start_layer = 1;          /* 1 for odd, 0 for even */
   while ( ! terminate() ) {
-      // compute weights, then sort the odd layers
-#ifdef _OPENMP
-#pragma omp parallel for default(none) private(layer) \
-  shared(number_of_layers, trace_freq, number_of_processors)
-#endif
-    for ( int layer = start_layer; layer < number_of_layers; layer += 2 ) {
-      barycenterWeights( layer, sort_direction );
-      layerSort( layer );
-      updateCrossingsForLayer( layer );
-      char buffer[LINE_LENGTH+1];
-      sprintf( buffer, "odd/even = %d, direction = %d",
-        start_layer, sort_direction );
-      tracePrint( layer, buffer );
-      if ( number_of_processors == 1 && end_of_iteration() )
-        return;
-    } // end, sort either odd or even layers
+    // compute weights, then sort either the odd or the even layers
+    char buffer[LINE_LENGTH+1];
+    sprintf( buffer, "odd/even = %d, direction = %d",
+             start_layer, sort_direction );
+    int count = alternate_layers( start_layer );
+    if ( barycenter_phase( CTX(phase_layers), count, sort_direction, buffer ) )
+      return;
     tracePrint( -1, "--- upDownBaryCenter, end of iteration" );
-    if ( number_of_processors != 1 && end_of_iteration() )
+    if ( OPTION(number_of_processors) != 1 && end_of_iteration() )
       return;
-#ifdef _OPENMP
-#pragma omp parallel for default(none) private(layer) \
-    shared(number_of_layers, trace_freq, number_of_processors)
-#endif
     start_layer = 1 - start_layer;
     if ( sort_direction == DOWNWARD ) sort_direction = UPWARD;
     else if ( sort_direction == UPWARD ) sort_direction = BOTH;
@@ -726,12 +762,84 @@ static bool sift_iteration( Nodeptr node )
 {
   sift( node );
   fixNode( node );
-  sprintf( buffer, "$$$ %s, node = %s", heuristic, node->name );
+  sprintf( buffer, "$$$ %s, node = %s", OPTION(heuristic), NODE_NAME( node ) );
   tracePrint( node->layer, buffer );
   if ( end_of_iteration() ) return true;
   return false;
 }
 
+/**
+ * When sift_batch_size > 1 (option -K), sifting(), maximumCrossingsNode()
+ * and maximumCrossingsEdgeWithSifting() sift batches of up to
+ * sift_batch_size nodes concurrently, on the OpenMP threads set by -m.
+ * Sifting a node changes only the channels incident on its layer, so the
+ * nodes of a batch must be on layers at least two apart; a batch ends at
+ * the first node that does not qualify, so that nodes are still sifted in
+ * priority order. The end of a batch is the synchronization point, i.e., a
+ * batch counts as one iteration. The batches are kept in CTX(node_batch)
+ * and CTX(edge_batch).
+ */
+
+static void allocate_batches( void )
+{
+  if ( CTX(node_batch) != NULL ) return;
+  CTX(node_batch)
+    = (Nodeptr *) malloc( OPTION(sift_batch_size) * sizeof(Nodeptr) );
+  CTX(edge_batch)
+    = (Edgeptr *) malloc( OPTION(sift_batch_size) * sizeof(Edgeptr) );
+}
+
+/**
+ * @return true if the node is on a layer at least two away from those of
+ * the first batch_size nodes in node_batch
+ */
+static bool fits_node_batch( Nodeptr node, int batch_size )
+{
+  for ( int i = 0; i < batch_size; i++ )
+    if ( abs( node->layer - CTX(node_batch)[i]->layer ) < 2 ) return false;
+  return true;
+}
+
+/**
+ * Sifts the first batch_size nodes in node_batch concurrently and handles
+ * the related bookkeeping
+ * @return true if max_iterations reached
+ */
+static bool sift_batch_iteration( int batch_size )
+{
+  siftConcurrently( CTX(node_batch), batch_size );
+  for ( int i = 0; i < batch_size; i++ )
+    {
+      Nodeptr node = CTX(node_batch)[i];
+      sprintf( buffer, "$$$ %s, node = %s, position = %d",
+               OPTION(heuristic), NODE_NAME( node ), node->position );
+      tracePrint( node->layer, buffer );
+    }
+  if ( end_of_iteration() ) return true;
+  return false;
+}
+
+/**
+ * Fills node_batch with up to sift_batch_size unfixed nodes in
+ * decreasing order of crossings, stopping at the first node that cannot be
+ * sifted concurrently with the ones already chosen; the chosen nodes are
+ * fixed.
+ * @return the number of nodes in the batch, 0 if all nodes are fixed
+ */
+static int max_crossings_node_batch( void )
+{
+  allocate_batches();
+  int batch_size = 0;
+  while ( batch_size < OPTION(sift_batch_size) )
+    {
+      Nodeptr node = maxCrossingsNode();
+      if ( node == NULL || ! fits_node_batch( node, batch_size ) ) break;
+      fixNode( node );
+      CTX(node_batch)[ batch_size++ ] = node;
+    }
+  return batch_size;
+}
+
 /**
  * Handles sifting of both endpoints of an edge and all related bookkeeping
  *
@@ -745,7 +853,7 @@ static bool edge_sift_iteration( Edgeptr edge )
   // figure out which of the two nodes to sift (none, one, or both)
   bool sift_up_node = false;
   bool sift_down_node = false;
-  if ( mce_option == EDGES ) {
+  if ( OPTION(mce_option) == EDGES ) {
     sift_up_node = sift_down_node = true;
   }
   if ( ! isFixedNode( edge->up_node ) ) {
@@ -754,7 +862,7 @@ static bool edge_sift_iteration( Edgeptr edge )
   if ( ! isFixedNode( edge->down_node ) ) {
     sift_down_node = true;
   }
-  if ( mce_option == ONE_NODE ) {
+  if ( OPTION(mce_option) == ONE_NODE ) {
     // if neither node is fixed, sift only the one with the most crossings
     if ( sift_up_node && sift_down_node ) {
       if ( numberOfCrossingsNode( edge->down_node )
@@ -771,7 +879,8 @@ static bool edge_sift_iteration( Edgeptr edge )
       sift_node_for_edge_crossings( edge, edge->up_node );
       fixNode( edge->up_node );
       sprintf( buffer, "$$$ %s, node = %s, position = %d",
-               heuristic, edge->up_node->name, edge->up_node->position );
+               OPTION(heuristic), NODE_NAME( edge->up_node ),
+               edge->up_node->position );
       tracePrint( edge->up_node->layer, buffer );
       if ( end_of_iteration() )
         return true;
@@ -782,7 +891,8 @@ static bool edge_sift_iteration( Edgeptr edge )
       sift_node_for_edge_crossings( edge, edge->down_node );
       fixNode( edge->down_node );
       sprintf( buffer, "$$$ %s, node = %s, position = %d",
-               heuristic, edge->down_node->name, edge->down_node->position );
+               OPTION(heuristic), NODE_NAME( edge->down_node ),
+               edge->down_node->position );
       tracePrint( edge->down_node->layer, buffer );
       if ( end_of_iteration() )
         return true;
@@ -793,36 +903,164 @@ static bool edge_sift_iteration( Edgeptr edge )
 static bool total_stretch_sift_iteration( Nodeptr node ) {
   sift_node_for_total_stretch(node);
   fixNode(node);
-  updateAllCrossings();
+  // only the order of the node's layer has changed
+  updateCrossingsForLayer(node->layer);
   sprintf(buffer, "$$$ %s, node = %s, position = %d",
-          heuristic, node->name, node->position);
+          OPTION(heuristic), NODE_NAME( node ), node->position);
   tracePrint(node->layer, buffer);
   if (end_of_iteration())
     return true;
   return false;
 }
 
+/**
+ * One pass of mcn with sift_batch_size > 1: sifts batches of nodes until
+ * all nodes are fixed
+ * @return true if max_iterations reached
+ */
+static bool mcn_batch_pass( void )
+{
+  while ( true )
+    {
+      int batch_size = max_crossings_node_batch();
+      if ( batch_size == 0 ) return false;
+      if ( sift_batch_iteration( batch_size ) )
+        return true;
+    }
+}
+
+/**
+ * One pass of mcn, sifting one node at a time until all nodes are fixed
+ * @return true if max_iterations reached
+ */
+static bool mcn_pass( void )
+{
+  while ( true )
+    {
+      Nodeptr node = maxCrossingsNode();
+      if ( node == NULL ) return false;
+      bool last_iteration = false;
+      /* if ( sifting_style == MAX ) */
+      /*   last_iteration = edge_sift_iteration( edge, node ); */
+      /* else */
+        last_iteration = sift_iteration( node );
+      if ( last_iteration )
+        return true;
+    }
+}
+
 void maximumCrossingsNode( void )
 {
   tracePrint( -1, "*** start maximum crossings node" );
   while( ! terminate() )
     {
       clearFixedNodes();
-      while ( true )
-        // keep going until all nodes are fixed
+      // keep going until all nodes are fixed
+      bool last_iteration = OPTION(sift_batch_size) > 1
+        ? mcn_batch_pass() : mcn_pass();
+      if ( last_iteration )
+        return;
+      tracePrint( -1, "$$$ mcn, all nodes fixed" );
+    }
+}
+
+/**
+ * Fills edge_batch with up to sift_batch_size unfixed edges in
+ * decreasing order of crossings, stopping at the first edge whose upper
+ * endpoint is on a layer less than two away from that of an edge already
+ * chosen; the chosen edges are fixed and edges whose endpoints are both
+ * fixed are skipped (and fixed).
+ * @return the number of edges in the batch, 0 if the pass is over, i.e.,
+ * all edges or all nodes are fixed
+ */
+static int max_crossings_edge_batch( void )
+{
+  allocate_batches();
+  int number_of_batch_edges = 0;
+  while ( number_of_batch_edges < OPTION(sift_batch_size) )
+    {
+      Edgeptr edge = maxCrossingsEdge();
+      if ( edge == NULL || allNodesFixed() ) break;
+      if ( isFixedNode( edge->up_node ) && isFixedNode( edge->down_node ) )
         {
-          Nodeptr node = maxCrossingsNode();
-          if ( node == NULL ) break;
-          bool last_iteration = false;
-          /* if ( sifting_style == MAX ) */
-          /*   last_iteration = edge_sift_iteration( edge, node ); */
-          /* else */
-            last_iteration = sift_iteration( node );
-          if ( last_iteration )
-            return;
+          fixEdge( edge );
+          continue;
         }
-      tracePrint( -1, "$$$ mcn, all nodes fixed" );
+      for ( int i = 0; i < number_of_batch_edges; i++ )
+        if ( abs( edge->up_node->layer
+                  - CTX(edge_batch)[i]->up_node->layer ) < 2 )
+          return number_of_batch_edges;
+      sprintf( buffer, "->- mce_s, edge %s -> %s",
+               NODE_NAME( edge->down_node ), NODE_NAME( edge->up_node ) );
+      tracePrint( edge->up_node->layer, buffer );
+      fixEdge( edge );
+      CTX(edge_batch)[ number_of_batch_edges++ ] = edge;
+    }
+  return number_of_batch_edges;
+}
+
+/**
+ * Sifts the unfixed endpoints of the edges in edge_batch, first all the
+ * upper endpoints concurrently, then all the lower ones
+ * @return true if max_iterations reached
+ */
+static bool edge_sift_batch_iteration( int number_of_batch_edges )
+{
+  for ( int upper = 1; upper >= 0; upper-- )
+    {
+      int batch_size = 0;
+      for ( int i = 0; i < number_of_batch_edges; i++ )
+        {
+          Edgeptr edge = CTX(edge_batch)[i];
+          Nodeptr node = upper ? edge->up_node : edge->down_node;
+          if ( isFixedNode( node ) ) continue;
+          fixNode( node );
+          CTX(node_batch)[ batch_size++ ] = node;
+        }
+      if ( batch_size > 0 && sift_batch_iteration( batch_size ) )
+        return true;
+    }
+  return false;
+}
+
+/**
+ * One pass of mce_s with sift_batch_size > 1: sifts the endpoints of
+ * batches of edges until all edges or all nodes are fixed
+ * @return true if max_iterations reached
+ */
+static bool mce_s_batch_pass( void ) {
+  while ( true ) {
+    int number_of_batch_edges = max_crossings_edge_batch();
+    if ( number_of_batch_edges == 0 ) return false;
+    if ( edge_sift_batch_iteration( number_of_batch_edges ) ) return true;
+  }
+}
+
+/**
+ * One pass of mce_s, sifting the endpoints of one edge at a time until all
+ * edges or all nodes are fixed
+ * @return true if max_iterations reached
+ */
+static bool mce_s_pass( void ) {
+  while ( true ) {
+    Edgeptr edge = maxCrossingsEdge();
+    if ( edge == NULL || allNodesFixed() ) return false;
+    sprintf( buffer, "->- mce_s, edge %s -> %s",
+             NODE_NAME( edge->down_node ), NODE_NAME( edge->up_node ) );
+    tracePrint( edge->up_node->layer, buffer );
+    bool last_iteration = false;
+    if ( ! isFixedNode( edge->up_node ) ) {
+      last_iteration = sift_iteration( edge->up_node );
+      fixNode( edge->up_node );
+      if ( last_iteration ) return true;
+    }
+    if ( ! isFixedNode( edge->down_node ) ) {
+      last_iteration = sift_iteration( edge->down_node );
+      fixNode( edge->down_node );
+      if ( last_iteration ) return true;
     }
+    fixEdge( edge );
+  }
 }
 
 void maximumCrossingsEdgeWithSifting( void ) {
@@ -830,25 +1068,9 @@ void maximumCrossingsEdgeWithSifting( void ) {
   while( ! terminate() ) {
       clearFixedNodes();
       clearFixedEdges();
-      while ( true ) {
-        Edgeptr edge = maxCrossingsEdge();
-        if ( edge == NULL || allNodesFixed() ) break;
-        sprintf( buffer, "->- mce_s, edge %s -> %s",
-                 edge->down_node->name, edge->up_node->name );
-        tracePrint( edge->up_node->layer, buffer );
-        bool last_iteration = false;
-        if ( ! isFixedNode( edge->up_node ) ) {
-          last_iteration = sift_iteration( edge->up_node );
-          fixNode( edge->up_node );
-          if ( last_iteration ) return;
-        }
-        if ( ! isFixedNode( edge->down_node ) ) {
-          last_iteration = sift_iteration( edge->down_node );
-          fixNode( edge->down_node );
-          if ( last_iteration ) return;
-        }
-        fixEdge( edge );
-      }
+      bool last_iteration = OPTION(sift_batch_size) > 1
+        ? mce_s_batch_pass() : mce_s_pass();
+      if ( last_iteration ) return;
       tracePrint( -1, "--- mce with sifting, end pass" );
   }
 }
@@ -862,11 +1084,11 @@ void maximumCrossingsEdgeWithSifting( void ) {
 static bool end_mce_pass( Edgeptr edge )
 {
   if( edge == NULL ) return true;
-  if( mce_option == EARLY 
+  if( OPTION(mce_option) == EARLY 
       && isFixedNode( edge->up_node )
       && isFixedNode( edge->down_node )
       ) return true;
-  if( mce_option == NODES
+  if( OPTION(mce_option) == NODES
       && allNodesFixed()
       ) return true;
   return false;
@@ -888,7 +1110,7 @@ void maximumCrossingsEdge( void )
           Edgeptr edge = maxCrossingsEdge();
           if ( edge == NULL ) break;
           sprintf( buffer, "->- mce, edge %s -> %s",
-                   edge->down_node->name, edge->up_node->name );
+                   NODE_NAME( edge->down_node ), NODE_NAME( edge->up_node ) );
           tracePrint( edge->up_node->layer, buffer );
           if ( end_mce_pass( edge ) ) break;
           bool last_iteration = false;
@@ -918,7 +1140,7 @@ void maximumStretchEdge( void ) {
         Edgeptr edge = maxStretchEdge();
         if ( edge == NULL || allNodesFixed() ) break;
         sprintf( buffer, "->- mse, edge %s -> %s",
-                 edge->down_node->name, edge->up_node->name );
+                 NODE_NAME( edge->down_node ), NODE_NAME( edge->up_node ) );
         tracePrint( edge->up_node->layer, buffer );
         bool last_iteration = false;
         if ( ! isFixedNode( edge->up_node ) ) {
@@ -940,6 +1162,34 @@ void maximumStretchEdge( void ) {
 // the value used in the Matuszewski et al. paper
 #define MAX_FAILS 1
 
+/**
+ * Sifts the nodes of the array in batches of nodes that can be sifted
+ * concurrently, by decreasing or increasing position in the array; used by
+ * sift_decreasing() and sift_increasing() when sift_batch_size > 1
+ */
+static bool sift_in_batches( const Nodeptr * node_array, int num_nodes,
+                             bool decreasing, int initial_crossings )
+{
+  allocate_batches();
+  int next = 0;                 /* number of nodes put into batches so far */
+  while ( next < num_nodes )
+    {
+      int batch_size = 0;
+      while ( next < num_nodes && batch_size < OPTION(sift_batch_size) )
+        {
+          Nodeptr node
+            = node_array[ decreasing ? num_nodes - 1 - next : next ];
+          if ( ! fits_node_batch( node, batch_size ) ) break;
+          CTX(node_batch)[ batch_size++ ] = node;
+          next++;
+        }
+      if ( sift_batch_iteration( batch_size ) ) break;
+    }
+  return numberOfCrossings() < initial_crossings
+    && CTX(iteration) < OPTION(max_iterations);
+}
+
+
 /**
  * Sifts node in decreasing order as determined by the input array
  * @return false if the sift was unsuccessful, i.e., it did not improve upon
@@ -956,17 +1206,19 @@ static bool sift_decreasing( const Nodeptr * node_array,
   printf( "-> sift_decreasing, num_nodes = %d, crossings = %d\n",
           num_nodes, initial_crossings );
 #endif
+  if ( OPTION(sift_batch_size) > 1 )
+    return sift_in_batches( node_array, num_nodes, true, initial_crossings );
   // sift by decreasing 'weight' (degree in this case)
   int i;
   for( i = num_nodes - 1; i >= 0; i-- )
     {
 #ifdef DEBUG
-      printf( "  sifting i = %d, node = %s\n", i, node_array[i]->name );
+      printf( "  sifting i = %d, node = %s\n", i, NODE_NAME( node_array[i] ) );
 #endif
       sift( node_array[ i ] );
       tracePrint( node_array[ i ]->layer, "^^^ sift_increasing ^^^" );
       sprintf( buffer, " $$$ sift, node = %s, pos = %d",
-               node_array[i]->name, node_array[i]->position );
+               NODE_NAME( node_array[i] ), node_array[i]->position );
       tracePrint( node_array[ i ]->layer, buffer );
       if ( end_of_iteration() ) break;
     }
@@ -974,7 +1226,8 @@ static bool sift_decreasing( const Nodeptr * node_array,
   printf( "<- sift_decreasing, crossings = %d\n",
           numberOfCrossings() );
 #endif
-  return numberOfCrossings() < initial_crossings && iteration < max_iterations;
+  return numberOfCrossings() < initial_crossings
+    && CTX(iteration) < OPTION(max_iterations);
 }
                                        
 /**
@@ -989,6 +1242,8 @@ static bool sift_decreasing( const Nodeptr * node_array,
 static bool sift_increasing( const Nodeptr * node_array,
                              int num_nodes, int initial_crossings )
 {
+  if ( OPTION(sift_batch_size) > 1 )
+    return sift_in_batches( node_array, num_nodes, false, initial_crossings );
   // sift by increasing 'weight' (degree in this case)
   int i;
   for( i = 0; i < num_nodes; i++ )
@@ -996,22 +1251,23 @@ static bool sift_increasing( const Nodeptr * node_array,
       sift( node_array[ i ] );
       tracePrint( node_array[ i ]->layer, "^^^ sift_increasing ^^^" );
       sprintf( buffer, " $$$ sift, node = %s, pos = %d",
-               node_array[i]->name, node_array[i]->position );
+               NODE_NAME( node_array[i] ), node_array[i]->position );
       tracePrint( node_array[ i ]->layer, buffer );
       if ( end_of_iteration() ) break;
     }
-  return numberOfCrossings() < initial_crossings && iteration < max_iterations;
+  return numberOfCrossings() < initial_crossings
+    && CTX(iteration) < OPTION(max_iterations);
 }
 
 void sifting( void ) {
   // sort nodes by increasing degree (other options not implemented yet); but
   // if randomize_order is true, then the order is randomized and the node
   // list is resorted before each pass
-  sortByDegree( master_node_list, number_of_nodes );
+  sortByDegree( CTX(master_node_list), CTX(number_of_nodes) );
 #ifdef DEBUG
   printf( "  sifting: nodes after sorting -\n" );
-  for( index = 0; index < number_of_nodes; index++ )
-    printf( "    node_array[%2d] = %s\n", index, node_array[index]->name );
+  for( index = 0; index < CTX(number_of_nodes); index++ )
+    printf( "    node_array[%2d] = %s\n", index, NODE_NAME( node_array[index] ) );
 #endif
 
   /* the sifting algorithm from the Matuszewski et al. paper, except that a
@@ -1019,35 +1275,39 @@ void sifting( void ) {
    * standard stopping criterion
    */
   int fail_count = 0;
-  while( ( standard_termination && fail_count < MAX_FAILS )
+  while( ( OPTION(standard_termination) && fail_count < MAX_FAILS )
          || ! terminate() ) {
     int crossings_before = numberOfCrossings();
     bool fail = false;
-    if ( randomize_order ) {
-      genrand_permute( master_node_list, number_of_nodes, sizeof(Nodeptr) );
-      sortByDegree( master_node_list, number_of_nodes );
+    if ( OPTION(randomize_order) ) {
+      genrand_permute( CTX(master_node_list), CTX(number_of_nodes),
+                       sizeof(Nodeptr) );
+      sortByDegree( CTX(master_node_list), CTX(number_of_nodes) );
     }
-    fail = ! sift_decreasing( master_node_list, number_of_nodes, crossings_before );
-    if ( iteration >= max_iterations )
+    fail = ! sift_decreasing( CTX(master_node_list), CTX(number_of_nodes),
+                              crossings_before );
+    if ( CTX(iteration) >= OPTION(max_iterations) )
       break;
     tracePrint( -1, "--- end of sifting pass" );
     if( fail ) {
       fail_count++;
-      if ( randomize_order ) {
-        genrand_permute( master_node_list, number_of_nodes, sizeof(Nodeptr) );
-        sortByDegree( master_node_list, number_of_nodes );
+      if ( OPTION(randomize_order) ) {
+        genrand_permute( CTX(master_node_list), CTX(number_of_nodes),
+                         sizeof(Nodeptr) );
+        sortByDegree( CTX(master_node_list), CTX(number_of_nodes) );
       }
-      fail = ! sift_increasing( master_node_list, number_of_nodes,
+      fail = ! sift_increasing( CTX(master_node_list), CTX(number_of_nodes),
                                 crossings_before );
       if ( end_of_iteration() )
         break;
     }
     else {
-      if ( randomize_order ) {
-        genrand_permute( master_node_list, number_of_nodes, sizeof(Nodeptr) );
-        sortByDegree( master_node_list, number_of_nodes );
+      if ( OPTION(randomize_order) ) {
+        genrand_permute( CTX(master_node_list), CTX(number_of_nodes),
+                         sizeof(Nodeptr) );
+        sortByDegree( CTX(master_node_list), CTX(number_of_nodes) );
       }
-      fail = ! sift_decreasing( master_node_list, number_of_nodes,
+      fail = ! sift_decreasing( CTX(master_node_list), CTX(number_of_nodes),
                                 crossings_before );
       if ( end_of_iteration() )
         break;
@@ -1071,7 +1331,7 @@ void depthFirstSearch( void )
 {
   assignDfsWeights();
   int layer = 0;
-  for( ; layer < number_of_layers; layer++ )
+  for( ; layer < CTX(number_of_layers); layer++ )
     layerSort( layer );
 }
 
@@ -1082,12 +1342,12 @@ void depthFirstSearch( void )
  */
 static void weight_first_to_middle( int layer )
 {
-  int n = layers[ layer ]->number_of_nodes;
+  int n = CTX(layers)[ layer ]->node_count;
   int position = 0;
   for( ; position < n; position++ )
     {
       int position_from_last = n - position - 1;
-      Nodeptr node = layers[ layer ]->nodes[ position ];
+      Nodeptr node = CTX(layers)[ layer ]->nodes[ position ];
       node->weight
         = ( position_from_last % 2 == 0 )
         ? n / 2 - position_from_last
@@ -1097,9 +1357,9 @@ static void weight_first_to_middle( int layer )
 
 void middleDegreeSort( void )
 {
-  for ( int layer = 0; layer < number_of_layers; layer++ )
+  for ( int layer = 0; layer < CTX(number_of_layers); layer++ )
     {
-      sortByDegree( layers[layer]->nodes, layers[layer]->number_of_nodes );
+      sortByDegree( CTX(layers)[layer]->nodes, CTX(layers)[layer]->node_count );
       weight_first_to_middle( layer );
       layerQuicksort( layer );
     }
@@ -1116,9 +1376,9 @@ void middleDegreeSort( void )
 /*   int layer = node->layer; */
 /* #ifdef DEBUG */
 /*   printf( "-> middleDegreeSort: node = %s, layer = %d\n", */
-/*           node->name, layer ); */
+/*           NODE_NAME( node ), layer ); */
 /* #endif */
-/*   sortByDegree( layers[layer]->nodes, layers[layer]->number_of_nodes ); */
+/*   sortByDegree( layers[layer]->nodes, layers[layer]->node_count ); */
 /*   weight_first_to_middle( layer ); */
 /*   layerSort( layer ); */
 
@@ -1143,6 +1403,7 @@ static void swap_nodes( Nodeptr * node_array, int i, int j )
   Nodeptr temp = node_array[i];
   node_array[i] = node_array[j];
   node_array[j] = temp;
+  layerOrderChanged( temp->layer );
 }
 
 /**
@@ -1159,10 +1420,10 @@ static int swapping_iteration( int crossings, int odd_even )
   printf( "-> swapping_iteration, crossings = %d, odd = %d\n",
           crossings, odd_even );
 #endif  
-  for ( int layer = odd_even; layer < number_of_layers; layer += 2 )
+  for ( int layer = odd_even; layer < CTX(number_of_layers); layer += 2 )
     {
-      Layerptr layer_ptr = layers[ layer ];
-      for ( int i = odd_even; i <  layer_ptr->number_of_nodes - 1; i += 2 )
+      Layerptr layer_ptr = CTX(layers)[ layer ];
+      for ( int i = odd_even; i <  layer_ptr->node_count - 1; i += 2 )
         {
           Nodeptr * nodes = layer_ptr->nodes;
           int crossings_before_swap = node_crossings( nodes[i], nodes[i+1] );
@@ -1178,6 +1439,8 @@ static int swapping_iteration( int crossings, int odd_even )
                   layer, i, diff, crossings );
 #endif
         }
+      // the swaps change crossing numbers of pairs on neighboring layers
+      invalidatePairCrossings( layer );
       tracePrint( layer, "<-> swapping" );
     }
 #ifdef DEBUG
@@ -1195,12 +1458,13 @@ static int swapping_iteration( int crossings, int odd_even )
 void swapping( void )
 {
   bool improved = true;
-  post_processing_crossings = numberOfCrossings();
-  int previous_best_crossings = post_processing_crossings;
-  post_processing_iteration = 0;
+  CTX(post_processing_crossings) = numberOfCrossings();
+  int previous_best_crossings = CTX(post_processing_crossings);
+  CTX(post_processing_iteration) = 0;
 
 #ifdef DEBUG
-  printf( "-> swapping, post_processing_crossings = %d\n", post_processing_crossings );
+  printf( "-> swapping, post_processing_crossings = %d\n",
+          CTX(post_processing_crossings) );
 #endif
 
   tracePrint( -1, "*** start swapping ***" );
@@ -1208,40 +1472,134 @@ void swapping( void )
     {
       // look for improvements by swapping nodes i, i+1 on layers L, L+1,
       // where i and L are even
-      post_processing_crossings = swapping_iteration( post_processing_crossings, 0 );
-      post_processing_iteration++;
-      if ( post_processing_crossings < previous_best_crossings )
+      CTX(post_processing_crossings)
+        = swapping_iteration( CTX(post_processing_crossings), 0 );
+      CTX(post_processing_iteration)++;
+      if ( CTX(post_processing_crossings) < previous_best_crossings )
         {
           improved = true;
-          save_order( best_crossings_order );
-          previous_best_crossings = post_processing_crossings;
+          save_order( CTX(best_crossings_order) );
+          previous_best_crossings = CTX(post_processing_crossings);
+          updateAllObjectives();
           update_best_all();
         }
       else improved = false;
-      post_processing_iteration++;
+      CTX(post_processing_iteration)++;
 
       // look for improvements by swapping nodes i, i+1 on layers L, L+1,
       // where i and L are odd
-      post_processing_crossings = swapping_iteration( post_processing_crossings, 1 );
-      if ( post_processing_crossings < previous_best_crossings )
+      CTX(post_processing_crossings)
+        = swapping_iteration( CTX(post_processing_crossings), 1 );
+      if ( CTX(post_processing_crossings) < previous_best_crossings )
         {
           improved = true;
-          save_order( best_crossings_order );
-          previous_best_crossings = post_processing_crossings;
+          save_order( CTX(best_crossings_order) );
+          previous_best_crossings = CTX(post_processing_crossings);
+          updateAllObjectives();
           update_best_all();
         }
       // don't set improved to false here -- there may have been improvement
       // during the even iteration
-      post_processing_iteration++;
+      CTX(post_processing_iteration)++;
       tracePrint( -1, "-- end of swapping pass" );
     } // while improved
 
 #ifdef DEBUG
-  printf( "<- swapping, post_processing_crossings = %d\n", post_processing_crossings );
+  printf( "<- swapping, post_processing_crossings = %d\n",
+          CTX(post_processing_crossings) );
 #endif
   
 }
 
+// ******** Running the preprocessor and heuristic given by the options
+
+bool runPreprocessor( void )
+{
+  printf( "--- Running preprocessor %s\n", OPTION(preprocessor) );
+  if( strcmp( OPTION(preprocessor), "" ) == 0 )
+    ;                           /* do nothing */
+  else if( strcmp( OPTION(preprocessor), "bfs" ) == 0 )
+    breadthFirstSearch();
+  else if( strcmp( OPTION(preprocessor), "dfs" ) == 0 )
+    depthFirstSearch();
+  else if( strcmp( OPTION(preprocessor), "mds" ) == 0 )
+    middleDegreeSort();
+  else
+    return false;
+  return true;
+}
+
+/**
+ * @todo It would be nice to have a way to run two heuristics, one after the
+ * other. Not really needed - can always use the output file of one as input
+ * to the other
+ */
+bool runHeuristic( void )
+{
+  printf( "=== Running heuristic %s\n", OPTION(heuristic) );
+  if( strcmp( OPTION(heuristic), "" ) == 0 )
+    ;                           /* do nothing */
+  else if( strcmp( OPTION(heuristic), "median" ) == 0 )
+    median();
+  else if( strcmp( OPTION(heuristic), "bary" ) == 0 )
+    barycenter();
+  else if( strcmp( OPTION(heuristic), "mod_bary" ) == 0 )
+    modifiedBarycenter();
+  else if( strcmp( OPTION(heuristic), "static_bary" ) == 0 ) {
+    OPTION(number_of_processors) = 0;
+    OPTION(adjust_weights) = AVG;
+    OPTION(balanced_weight) = true;
+    staticBarycenter();
+  }
+  else if( strcmp( OPTION(heuristic), "alt_bary" ) == 0 ) {
+    OPTION(number_of_processors) = 0;
+    OPTION(adjust_weights) = AVG;
+    OPTION(balanced_weight) = true;
+    evenOddBarycenter();
+  }
+  else if( strcmp( OPTION(heuristic), "up_down_bary" ) == 0 ) {
+    OPTION(number_of_processors) = 0;
+    OPTION(adjust_weights) = AVG;
+    upDownBarycenter();
+  }
+  else if( strcmp( OPTION(heuristic), "slab_bary" ) == 0 ) {
+    // number_of_processors determines size of slab, must be > 0
+    OPTION(adjust_weights) = AVG;
+    slabBarycenter();
+  }
+  else if( strcmp( OPTION(heuristic), "rotate_bary" ) == 0 ) {
+    OPTION(number_of_processors) = 0;
+    OPTION(adjust_weights) = AVG;
+    OPTION(balanced_weight) = true;
+    rotatingBarycenter();
+  }
+  else if ( strcmp( OPTION(heuristic), "mcn" ) == 0 )
+    maximumCrossingsNode();
+  else if ( strcmp( OPTION(heuristic), "mce_s" ) == 0 )
+    maximumCrossingsEdgeWithSifting();
+  else if ( strcmp( OPTION(heuristic), "sifting" ) == 0 )
+    sifting();
+  else if( strcmp( OPTION(heuristic), "mce" ) == 0 ) {
+    maximumCrossingsEdge();
+  }
+  else if( strcmp( OPTION(heuristic), "mse" ) == 0 ) {
+    maximumStretchEdge();
+  }
+  else
+    return false;
+  return true;
+}
+
+void freeHeuristics( void )
+{
+  free( CTX(phase_layers) );
+  free( CTX(node_batch) );
+  free( CTX(edge_batch) );
+  CTX(phase_layers) = NULL;
+  CTX(node_batch) = NULL;
+  CTX(edge_batch) = NULL;
+}
+
 #endif // ! defined(TEST)
 
-/*  [Last modified: 2016 06 10 at 13:11:47 GMT] */
+/*  [Last modified: 2026 10 16 at 19:05:16 GMT] */
@@ -18,22 +18,24 @@
 #include"order.h"
 
 /**
+ * The following are part of the run context - see context.h
+ *
  * The current iteration, or, the number of iterations up to this point.
- */
-extern int iteration;
-
-/**
+ *
+ *   int iteration;
+ *
  * The minimum total number of crossings during post processing
- */
-extern int post_processing_crossings;
-
-/**
+ *
+ *   int post_processing_crossings;
+ *
  * The current iteration during post processing
+ *
+ *   int post_processing_iteration;
  */
-extern int post_processing_iteration;
 
 /**
- * Creates an ord file name from the graph name, preprocessor and heuristic.
+ * Creates an ord file name from the graph name, preprocessor and heuristic;
+ * the extension is .sgf instead if the graph format is SGF.
  * @param output_file_name a buffer for the file name to be created, assumed
  * to be big enough
  * @param appendix a string that is attached just before the .ord extension
@@ -191,6 +193,27 @@ void middleDegreeSort( void );
  */
 void swapping( void );
 
+// ******** Running the preprocessor and heuristic given by the options
+
+/**
+ * Runs the preprocessor given by the preprocessor option, if any
+ * @return false if there is no preprocessor by that name
+ */
+bool runPreprocessor( void );
+
+/**
+ * Runs the heuristic given by the heuristic option, if any; the parallel
+ * barycenter versions adjust some of the other options first
+ * @return false if there is no heuristic by that name
+ */
+bool runHeuristic( void );
+
+/**
+ * Deallocates the scratch space that the heuristics have allocated for the
+ * current graph
+ */
+void freeHeuristics( void );
+
 #endif
 
-/*  [Last modified: 2016 05 19 at 15:19:35 GMT] */
+/*  [Last modified: 2026 10 16 at 16:51:03 GMT] */
@@ -0,0 +1,139 @@
+/**
+ * @file mapped_input.c
+ * @brief Mapping of input files - see mapped_input.h
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+// mmap() and friends are POSIX, not C99
+#define _POSIX_C_SOURCE 200112L
+
+#include"mapped_input.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdarg.h>
+#include<sys/types.h>
+#include<sys/stat.h>
+#include<sys/mman.h>
+#include<fcntl.h>
+#include<unistd.h>
+
+/**
+ * Reads the whole stream into an allocated buffer; used when the file
+ * cannot be mapped, e.g., if it is a pipe. The buffer doubles as it fills,
+ * so it takes up to twice the size of the input.
+ * @return the buffer, or NULL if reading fails or the buffer cannot grow
+ */
+static char * read_all( FILE * stream, size_t * size )
+{
+  size_t capacity = 1 << 16;
+  size_t length = 0;
+  char * buffer = (char *) malloc( capacity );
+  if ( buffer == NULL ) return NULL;
+  size_t count;
+  while ( ( count = fread( buffer + length, 1, capacity - length,
+                           stream ) ) > 0 )
+    {
+      length += count;
+      if ( length == capacity )
+        {
+          char * larger = (char *) realloc( buffer, 2 * capacity );
+          if ( larger == NULL )
+            {
+              fprintf( stderr, "read_all: unable to allocate %zu bytes\n",
+                       2 * capacity );
+              free( buffer );
+              return NULL;
+            }
+          buffer = larger;
+          capacity *= 2;
+        }
+    }
+  if ( ferror( stream ) )
+    {
+      free( buffer );
+      return NULL;
+    }
+  * size = length;
+  return buffer;
+}
+
+/**
+ * @return a new input, positioned before the first character, whose
+ * text has yet to be filled in
+ */
+static MappedInputptr newMappedInput( const char * file_name )
+{
+  MappedInputptr in
+    = (MappedInputptr) calloc( 1, sizeof(struct mapped_input_struct) );
+  in->file_name = file_name;
+  in->line_number = 1;
+  in->first_comment = true;
+  return in;
+}
+
+MappedInputptr openMappedInput( const char * file_name )
+{
+  int descriptor = open( file_name, O_RDONLY );
+  if ( descriptor < 0 ) return NULL;
+
+  struct stat file_status;
+  if ( fstat( descriptor, & file_status ) == 0
+       && S_ISREG( file_status.st_mode ) && file_status.st_size > 0 )
+    {
+      void * text = mmap( NULL, file_status.st_size, PROT_READ, MAP_PRIVATE,
+                          descriptor, 0 );
+      if ( text != MAP_FAILED )
+        {
+          close( descriptor );
+          posix_madvise( text, file_status.st_size, POSIX_MADV_SEQUENTIAL );
+          MappedInputptr in = newMappedInput( file_name );
+          in->text = (const char *) text;
+          in->size = file_status.st_size;
+          in->is_mapped = true;
+          in->position = in->text;
+          in->end = in->text + in->size;
+          return in;
+        }
+    }
+  FILE * stream = fdopen( descriptor, "r" );
+  MappedInputptr in = readMappedStream( stream, file_name );
+  fclose( stream );
+  return in;
+}
+
+MappedInputptr readMappedStream( FILE * stream, const char * name )
+{
+  size_t size;
+  char * text = read_all( stream, & size );
+  if ( text == NULL ) return NULL;
+  MappedInputptr in = newMappedInput( name );
+  in->text = text;
+  in->size = size;
+  in->position = in->text;
+  in->end = in->text + in->size;
+  return in;
+}
+
+void closeMappedInput( MappedInputptr in )
+{
+  if ( in->is_mapped )
+    munmap( (void *) in->text, in->size );
+  else
+    free( (void *) in->text );
+  free( in );
+}
+
+void inputError( MappedInputptr in, const char * format, ... )
+{
+  fprintf( stderr, "%s, line %d: ", in->file_name, in->line_number );
+  va_list arguments;
+  va_start( arguments, format );
+  vfprintf( stderr, format, arguments );
+  va_end( arguments );
+  fprintf( stderr, "\n" );
+}
+
+/*  [Last modified: 2026 10 16 at 19:06:21 GMT] */
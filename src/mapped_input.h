@@ -0,0 +1,86 @@
+/**
+ * @file mapped_input.h
+ * @brief Input files that are scanned in place: the file is memory-mapped
+ * (or, if that is not possible, read into memory in one piece) and the
+ * readers in dot.c and ord.c hand out names as slices of it, i.e., a
+ * pointer and a length, without copying them.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+#ifndef MAPPED_INPUT_H
+#define MAPPED_INPUT_H
+
+#include<stdbool.h>
+#include<stddef.h>
+#include<stdio.h>
+
+/**
+ * A name in the input; it is not terminated by '\0'
+ */
+typedef struct name_slice {
+  const char * start;
+  int length;
+} NameSlice;
+
+typedef struct mapped_input_struct {
+  const char * file_name;
+  /**
+   * the text of the file is text[0], ..., text[size - 1] and the next
+   * character to be scanned is *position, unless position == end
+   */
+  const char * text;
+  const char * position;
+  const char * end;
+  size_t size;
+  /**
+   * true if text is a memory mapping, false if it was allocated
+   */
+  bool is_mapped;
+  /**
+   * line of the next character to be scanned; the readers update it when
+   * they skip a newline
+   */
+  int line_number;
+
+  // state of the ord reader - see ord.c
+
+  int ord_state;
+  int current_layer;
+  bool first_comment;
+  bool valid_name;
+  NameSlice name_of_graph;
+} * MappedInputptr;
+
+/**
+ * @return the contents of the file with the given name, ready to be
+ * scanned from the beginning, or NULL if the file cannot be opened
+ */
+MappedInputptr openMappedInput( const char * file_name );
+
+/**
+ * Same as openMappedInput(), but the contents are whatever can be read from
+ * the stream, e.g., standard input, up to end of file; it is read once and
+ * kept in memory, in a buffer of up to twice its size. The stream is not
+ * closed.
+ * @param name the name of the stream used in error messages
+ * @return NULL if reading fails or there is not enough memory
+ */
+MappedInputptr readMappedStream( FILE * stream, const char * name );
+
+/**
+ * Unmaps (or deallocates) the contents of the file; slices of it become
+ * invalid
+ */
+void closeMappedInput( MappedInputptr in );
+
+/**
+ * Prints the message, formatted as by printf, on stderr, preceded by the
+ * file name and the current line number
+ */
+void inputError( MappedInputptr in, const char * format, ... );
+
+#endif
+
+/*  [Last modified: 2026 10 16 at 19:06:21 GMT] */
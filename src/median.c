@@ -9,16 +9,93 @@
 #include<stdio.h>
 #include<stdlib.h>
 #include<assert.h>
+#include<stdbool.h>
 
 #include"defs.h"
 #include"min_crossings.h"
 #include"median.h"
 #include"graph.h"
+#include"graph_core.h"
 #include"sorting.h"
 #include"crossings.h"
 #include"graph_io.h"
 #include"heuristics.h"
 
+/**
+ * Degree up to which neighbor positions are collected in a local array
+ * rather than an allocated one
+ */
+#define SMALL_DEGREE 64
+
+static void swap_positions( int * positions, int i, int j )
+{
+  int tmp = positions[i];
+  positions[i] = positions[j];
+  positions[j] = tmp;
+}
+
+/**
+ * Rearranges positions[0], ..., positions[n-1] so that positions[k] is the
+ * k-th smallest (starting at 0) by quickselect with median-of-three pivots;
+ * expected linear time.
+ * @return the k-th smallest position
+ */
+static int select_position( int * positions, int n, int k )
+{
+  int low = 0;
+  int high = n - 1;
+  while ( low < high )
+    {
+      // put the median of the first, middle and last positions in the middle
+      int middle = low + ( high - low ) / 2;
+      if ( positions[middle] < positions[low] )
+        swap_positions( positions, low, middle );
+      if ( positions[high] < positions[low] )
+        swap_positions( positions, low, high );
+      if ( positions[high] < positions[middle] )
+        swap_positions( positions, middle, high );
+      int pivot = positions[middle];
+      int i = low;
+      int j = high;
+      while ( i <= j )
+        {
+          while ( positions[i] < pivot ) i++;
+          while ( positions[j] > pivot ) j--;
+          if ( i <= j )
+            {
+              swap_positions( positions, i, j );
+              i++;
+              j--;
+            }
+        }
+      // positions[low..j] <= pivot <= positions[i..high], and everything in
+      // between equals pivot
+      if ( k <= j ) high = j;
+      else if ( k >= i ) low = i;
+      else return positions[k];
+    }
+  return positions[k];
+}
+
+/**
+ * @return the median position of the given neighbors (the lower of the two
+ * middle positions if the degree is even); the positions are those in
+ * graph_core. Uses selection on a compact array of positions, so the
+ * adjacency list is not reordered.
+ */
+static int median_position( const int32_t * neighbors, int degree )
+{
+  const int32_t * position = CTX(graph_core)->position;
+  int small_positions[ SMALL_DEGREE ];
+  int * positions = degree <= SMALL_DEGREE
+    ? small_positions : (int *) malloc( degree * sizeof(int) );
+  for ( int i = 0; i < degree; i++ )
+    positions[i] = position[ neighbors[i] ];
+  int median = select_position( positions, degree, (degree - 1) / 2 );
+  if ( positions != small_positions ) free( positions );
+  return median;
+}
+
 /**
  * @return the median position of the nodes adjacent to 'node' on the layer
  * above 'node' 
@@ -27,10 +104,9 @@ static double upper_median( Nodeptr node )
 {
   // -1 indicates no up edges -- see the adjust_weights functions below
   if ( node->up_degree == 0 ) return -1;
-  sortByUpNodePosition( node->up_edges, node->up_degree );
-  int median_position = (node->up_degree - 1) / 2;
-  Edgeptr median_edge = node->up_edges[ median_position ];
-  return median_edge->up_node->position; 
+  return median_position( CTX(graph_core)->up_neighbor
+                          + CTX(graph_core)->up_start[ node->id ],
+                          node->up_degree );
 }
 
 /**
@@ -41,10 +117,9 @@ static double lower_median( Nodeptr node )
 {
   // -1 indicates no down edges -- see the adjust_weights functions below
   if ( node->down_degree == 0 ) return -1;
-  sortByDownNodePosition( node->down_edges, node->down_degree );
-  int median_position = (node->down_degree - 1) / 2;
-  Edgeptr median_edge = node->down_edges[ median_position ];
-  return median_edge->down_node->position; 
+  return median_position( CTX(graph_core)->down_neighbor
+                          + CTX(graph_core)->down_start[ node->id ],
+                          node->down_degree );
 }
 
 /**
@@ -54,7 +129,7 @@ static double lower_median( Nodeptr node )
 static void node_weight( Nodeptr node, Orientation orientation )
 {
 #ifdef DEBUG
-  printf("-> (median) node_weight, node = %s, orientation = %d\n", node->name, orientation );
+  printf("-> (median) node_weight, node = %s, orientation = %d\n", NODE_NAME( node ), orientation );
 #endif  
   assert( orientation != BOTH );
   if( orientation == UPWARD )
@@ -66,7 +141,7 @@ static void node_weight( Nodeptr node, Orientation orientation )
       node->weight = lower_median( node );
     }
 #ifdef DEBUG
-  printf("<- (median) node_weight, node = %s, weight = %f\n", node->name, node->weight );
+  printf("<- (median) node_weight, node = %s, weight = %f\n", NODE_NAME( node ), node->weight );
 #endif  
 }
 
@@ -89,9 +164,9 @@ static void two_layer_node_weight( Nodeptr node )
  */
 static void adjust_weights_left( int layer )
 {
-  Layerptr layerptr = layers[ layer ];
+  Layerptr layerptr = CTX(layers)[ layer ];
   int i = 0;
-  for( ; i < layerptr->number_of_nodes; i++ )
+  for( ; i < layerptr->node_count; i++ )
     {
       Nodeptr node = layerptr->nodes[i];
       if( node->weight == -1 )
@@ -100,7 +175,7 @@ static void adjust_weights_left( int layer )
           else node->weight = layerptr->nodes[i-1]->weight;
 #ifdef DEBUG
           printf("  adjust_weight (left), node = %s, weight = %f\n",
-                 node->name, node->weight );
+                 NODE_NAME( node ), node->weight );
 #endif  
         }
     }
@@ -114,9 +189,9 @@ static void adjust_weights_left( int layer )
  */
 static void adjust_weights_avg( int layer )
 {
-  Layerptr layerptr = layers[ layer ];
+  Layerptr layerptr = CTX(layers)[ layer ];
   int i = 0;
-  for( ; i < layerptr->number_of_nodes; i++ )
+  for( ; i < layerptr->node_count; i++ )
     {
       Nodeptr node = layerptr->nodes[i];
       if( node->weight == -1 )
@@ -128,7 +203,7 @@ static void adjust_weights_avg( int layer )
               number_of_weights++;
               total_weight += layerptr->nodes[i-1]->weight;
             }
-          if( i < layerptr->number_of_nodes - 1
+          if( i < layerptr->node_count - 1
               && layerptr->nodes[i+1]->weight >= 0 )
             {
               number_of_weights++;
@@ -142,7 +217,7 @@ static void adjust_weights_avg( int layer )
             node->weight = 0;
 #ifdef DEBUG
           printf("  adjust_weight (avg), node = %s, weight = %f\n",
-                 node->name, node->weight );
+                 NODE_NAME( node ), node->weight );
 #endif  
         }
     }
@@ -158,14 +233,17 @@ void medianWeights( int layer, Orientation orientation )
   printf("-> medianWeights, layer = %d, orientation = %d\n",
          layer, orientation );
 #endif  
-  Layerptr layerptr = layers[ layer ];
+  // the weights depend on the positions of the neighboring layers in
+  // graph_core
+  if ( layer > 0 ) refreshLayerPositions( layer - 1 );
+  if ( layer < CTX(number_of_layers) - 1 ) refreshLayerPositions( layer + 1 );
+  Layerptr layerptr = CTX(layers)[ layer ];
   int i = 0;
-  int num_nodes = layerptr->number_of_nodes;
+  int num_nodes = layerptr->node_count;
 /*
 #ifdef _OPENMP
 #pragma omp parallel for default(none) private(i) \
-  shared(num_nodes, orientation, balanced_weight, \
-  layerptr, trace_freq, number_of_processors)
+  shared(num_nodes, orientation, layerptr) copyin(current_context)
 #endif
 */
   for(i = 0 ; i < num_nodes; i++ )
@@ -175,9 +253,9 @@ void medianWeights( int layer, Orientation orientation )
       else
         node_weight( layerptr->nodes[i], orientation );
     }
-  if( adjust_weights == LEFT )
+  if( OPTION(adjust_weights) == LEFT )
     adjust_weights_left( layer );
-  else if( adjust_weights == AVG )
+  else if( OPTION(adjust_weights) == AVG )
     adjust_weights_avg( layer );
 #ifdef DEBUG
   printf( "<- medianWeights\n" );
@@ -187,7 +265,7 @@ void medianWeights( int layer, Orientation orientation )
 bool medianUpSweep( int starting_layer )
 {
   int layer = starting_layer;
-  for( ; layer < number_of_layers; layer++ )
+  for( ; layer < CTX(number_of_layers); layer++ )
     {
       medianWeights( layer, DOWNWARD );
       layerSort( layer );
@@ -218,4 +296,4 @@ bool medianDownSweep( int starting_layer )
   return false;
 }
 
-/*  [Last modified: 2014 09 09 at 15:54:14 GMT] */
+/*  [Last modified: 2026 10 16 at 16:03:56 GMT] */
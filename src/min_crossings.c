@@ -33,46 +33,27 @@
 #include"priority_edges.h"
 #include"timing.h"
 #include"random.h"
+#include"output_buffer.h"
+#include"batch.h"
 
-// definition of command-line options with default values
-
-char * heuristic = "";
-char * preprocessor = "";
-int max_iterations = INT_MAX;
-double runtime = 0;
-double max_runtime = DBL_MAX;
-double start_time = 0;
-int number_of_processors = 1;
-bool standard_termination = true;
-enum adjust_weights_enum adjust_weights = LEFT;
-enum sift_option_enum sift_option = DEGREE;
-enum mce_option_enum mce_option = NODES;
-enum sifting_style_enum sifting_style = DEFAULT;
-enum pareto_objective_enum pareto_objective = NO_PARETO;
-int capture_iteration = INT_MIN; /* because -1 is a possible iteration */
-bool favored_edges = false;
-bool randomize_order = false;
-/**
- * @todo not clear which value of this option works best; stay tuned ...
- */
-bool balanced_weight = false;
-bool produce_output = false;
-char * output_base_name = NULL;
-
-bool verbose = false;
-int trace_freq = -1;
-
-// definition of order saving structures
-Orderptr best_crossings_order = NULL;
-Orderptr best_edge_crossings_order = NULL;
-Orderptr best_total_stretch_order = NULL;
-Orderptr best_bottleneck_stretch_order = NULL;
-Orderptr best_favored_crossings_order = NULL;
+// The command-line options, with their default values, and the order
+// saving structures are part of the run context - see context.h; the
+// options are set in the default context of the main thread
 
 /** buffer to be used for all output file names */
 static char output_file_name[MAX_NAME_LENGTH];
 
-static bool do_post_processing = false;
+// options that concern the main program rather than the run itself
+static const char * snapshot_file_name = NULL;
+static const char * start_order = NULL;
+static bool background_output = false;
+static const char * manifest_file_name = NULL;
+
+/**
+ * Options that are not allowed in a batch configuration, because they
+ * write files or concern the main program
+ */
+#define MAIN_ONLY_OPTIONS "BcfmOoSWX"
 
 /**
  * prints usage message
@@ -82,7 +63,13 @@ static bool do_post_processing = false;
  */
 static void printUsage( void )
 {
-  printf( "Usage: min_crossings [opts] file.dot file.ord\n" );
+  printf( "Usage: min_crossings [opts] file.dot file.ord\n"
+          "       min_crossings [opts] file.sgf\n"
+          "       min_crossings [opts] file.snap\n"
+         "       min_crossings [opts] -   (sgf, or dot followed by ord, on standard input;\n"
+         "                                 it is read into memory first, which takes\n"
+         "                                 up to twice the size of the input)\n"
+          "       min_crossings [opts] -X MANIFEST\n" );
   printf( " where opts is one or more of the following\n" );
   printf(
          "  -h (median | bary | mod_bary | mcn | sifting | mce | mce_s | mse\n"
@@ -99,7 +86,22 @@ static void printUsage( void )
          "  -P PARETO_OBJECTIVES (b_t | s_t | b_s) pair of objectives for Pareto optima\n"
          "      b = bottleneck, t = total, s = stretch (default = none)\n"
          "  -o BASE produce file(s) with name(s) BASE-h.ord, where h is the heuristic used\n"
-         "     -o _ (underscore) means use the base name of the dot file\n"
+         "     (BASE-h.sgf if the input is an sgf file)\n"
+         "     -o _ (underscore) means use the base name of the dot (or sgf) file\n"
+         "     (the graph name if the input is standard input)\n"
+         "  -S the input is a single sgf file, whatever its name\n"
+         "     [default: sgf if there is one file name and it ends in .sgf]\n"
+         "  -W FILE write a snapshot of the graph to FILE at the end of the run; it\n"
+         "     includes the best orderings for Crossings, EdgeCrossings, Stretch\n"
+         "     and BottleneckStretch and can be read much faster than the text formats\n"
+         "  -B write output files (-o, -c, -f) from a separate thread; they are still\n"
+         "     formatted by the run, only the writing overlaps it. The runtime is then\n"
+         "     the user time of the main thread (not that of any OpenMP threads)\n"
+         "  -X MANIFEST run all configurations listed in MANIFEST on all instances\n"
+         "     listed there, on a pool of threads, and write one table of results\n"
+         "     (see batch.h); the other options are defaults for the configurations\n"
+         "  -O NAME start from the ordering NAME saved in the snapshot (see -W) that\n"
+         "     is the input [default: the order in which the graph was first read]\n"
          "  -w (none | avg | left) [adjust weights in barycenter, default left, but avg in parallel versions]\n"
          "  -b average the averages of the two neighboring layers when computing barycenter weights\n"
          "     [this is the default for parallel versions]\n"
@@ -113,7 +115,18 @@ static void printUsage( void )
          "  -f create a special .dot file of 'favored' edges; used for visualizing\n"
          "  -k NUMBER_OF_PROCESSORS (for simulation); currently supports 0 or 1\n"
          "      [0 means unlimited and is default for parallel barycenter versions]\n"
+         "  -K BATCH_SIZE sift batches of up to BATCH_SIZE nodes on layers at least\n"
+         "     two apart concurrently in sifting, mcn and mce_s, using the threads\n"
+         "     given by -m; a batch counts as one iteration\n"
+         "     [default: 1, i.e., one node at a time, each an iteration]\n"
          "  -m number of OpenMP threads [default: 1]\n"
+         "  -C (insertion | tree) how crossings between adjacent layers are counted\n"
+         "     [default: tree (accumulator tree); both give the same counts]\n"
+         "  -M cache crossing numbers for pairs of nodes on the same layer\n"
+         "     (speeds up sifting and swapping; memory is quadratic in layer size)\n"
+         "  -u (recount | delta | check) how crossings are updated after a node is sifted\n"
+         "     [default: recount; delta changes only what the node passed over,\n"
+         "      check does delta and verifies it with a recount]\n"
          );
 }
 
@@ -137,147 +150,68 @@ static char * base_name( char * buffer )
   return without_directory;
 }
 
-static void runPreprocessor( void )
-{
-  printf( "--- Running preprocessor %s\n", preprocessor );
-  if( strcmp( preprocessor, "" ) == 0 )
-    ;                           /* do nothing */
-  else if( strcmp( preprocessor, "bfs" ) == 0 )
-    breadthFirstSearch();
-  else if( strcmp( preprocessor, "dfs" ) == 0 )
-    depthFirstSearch();
-  else if( strcmp( preprocessor, "mds" ) == 0 )
-    middleDegreeSort();
-  else
-    {
-      printf( "Bad preprocessor '%s'\n", preprocessor );
-      printUsage();
-      exit( EXIT_FAILURE );
-    }
-}
-
 /**
- * @todo It would be nice to have a way to run two heuristics, one after the
- * other. Not really needed - can always use the output file of one as input
- * to the other
- */
-static void runHeuristic( void )
-{
-  printf( "=== Running heuristic %s\n", heuristic );
-  if( strcmp( heuristic, "" ) == 0 )
-    ;                           /* do nothing */
-  else if( strcmp( heuristic, "median" ) == 0 )
-    median();
-  else if( strcmp( heuristic, "bary" ) == 0 )
-    barycenter();
-  else if( strcmp( heuristic, "mod_bary" ) == 0 )
-    modifiedBarycenter();
-  else if( strcmp( heuristic, "static_bary" ) == 0 ) {
-    number_of_processors = 0;
-    adjust_weights = AVG;
-    balanced_weight = true;
-    staticBarycenter();
-  }
-  else if( strcmp( heuristic, "alt_bary" ) == 0 ) {
-    number_of_processors = 0;
-    adjust_weights = AVG;
-    balanced_weight = true;
-    evenOddBarycenter();
-  }
-  else if( strcmp( heuristic, "up_down_bary" ) == 0 ) {
-    number_of_processors = 0;
-    adjust_weights = AVG;
-    upDownBarycenter();
-  }
-  else if( strcmp( heuristic, "slab_bary" ) == 0 ) {
-    // number_of_processors determines size of slab, must be > 0
-    adjust_weights = AVG;
-    slabBarycenter();
-  }
-  else if( strcmp( heuristic, "rotate_bary" ) == 0 ) {
-    number_of_processors = 0;
-    adjust_weights = AVG;
-    balanced_weight = true;
-    rotatingBarycenter();
-  }
-  else if ( strcmp( heuristic, "mcn" ) == 0 )
-    maximumCrossingsNode();
-  else if ( strcmp( heuristic, "mce_s" ) == 0 )
-    maximumCrossingsEdgeWithSifting();
-  else if ( strcmp( heuristic, "sifting" ) == 0 )
-    sifting();
-  else if( strcmp( heuristic, "mce" ) == 0 ) {
-    maximumCrossingsEdge();
-  }
-  else if( strcmp( heuristic, "mse" ) == 0 ) {
-    maximumStretchEdge();
-  }
-  else {
-      printf( "Bad heuristic '%s'\n", heuristic );
-      printUsage();
-      exit( EXIT_FAILURE );
-  }
-}
-
-/**
- * As of now, the main program does the following seqence of events -
- * -# Read the DOT file
- * -# Read the ORD file
- * -# Display the attributes of the graph
- * -# Count the number of crossings.
- * -# Apply a preprocess and a heuristic (both optional) on the graph
- * -# Optionally apply a post-processor that repeatedly swaps neighboring
- * nodes until there's no more improvement
- * -# Count the number of crossings after each phase (and save the ORD files
- * for the minimum number of crossings in each phase)
+ * Sets the options of the current context from the arguments argv[1], ...,
+ * argv[argc - 1]; a bad option or option value is fatal
+ * @param batch_configuration true if the arguments are those of a
+ * configuration of a batch (see batch.h); argv[0] is then the name of the
+ * configuration and options that are not about the run itself, listed in
+ * MAIN_ONLY_OPTIONS, are not allowed
+ * @return the index of the first argument that is not an option
  */
-int main( int argc, char * argv[] )
+static int parseOptions( int argc, char * argv[], bool batch_configuration )
 {
-  printf("################################################################\n");
-  printf("########### min_crossings, release 1.1, 2016/05/23 #############\n");
-
-  int seed = 0;
   int ch = -1;
-  number_of_processors = 1;
+  // so that getopt() starts over with every configuration of a batch
+  optind = 1;
 
   // process command-line options; these must come before the file arguments
   // note: options that have an arg are followed by : but others are not
-  while ( (ch = getopt(argc, argv, "bc:e:fgh:i:k:o:p:P:R:r:s:t:vw:zm:")) != -1)
+  while ( (ch = getopt(argc, argv, "BbC:c:e:fgh:i:K:k:Mo:O:p:P:R:r:Ss:t:u:vw:W:X:zm:")) != -1)
     {
+      if ( batch_configuration && strchr( MAIN_ONLY_OPTIONS, ch ) != NULL )
+        {
+          printf( "Option -%c is not allowed in batch configuration %s\n",
+                  ch, argv[0] );
+          exit( EXIT_FAILURE );
+        }
       switch(ch)
         {
         case 'h':
-          heuristic = optarg;
+          OPTION(heuristic) = optarg;
           break;
 
         case 'p':
-          preprocessor = optarg;
+          OPTION(preprocessor) = optarg;
           break;
 
         case 'z':
-          do_post_processing = true;
+          OPTION(do_post_processing) = true;
           break; 
 
         case 'i':
-          max_iterations = atoi( optarg );
-          standard_termination = false;
+          OPTION(max_iterations) = atoi( optarg );
+          OPTION(standard_termination) = false;
           break;
 
         case 'R':
-          seed = atoi( optarg );
-          init_genrand( seed );
-          randomize_order = true;
+          OPTION(random_seed) = atoi( optarg );
+          init_genrand( OPTION(random_seed) );
+          OPTION(randomize_order) = true;
           break;
 
         case 'r':
-          max_runtime = atof( optarg );
-          standard_termination = false;
+          OPTION(max_runtime) = atof( optarg );
+          OPTION(standard_termination) = false;
           break;
 
         case 'P':
-          if ( strcmp( optarg, "b_t" ) == 0 ) pareto_objective = BOTTLENECK_TOTAL;
-          else if ( strcmp( optarg, "s_t" ) == 0 ) pareto_objective = STRETCH_TOTAL; 
-          else if ( strcmp( optarg, "b_s" ) == 0 ) pareto_objective = BOTTLENECK_STRETCH; 
+          if ( strcmp( optarg, "b_t" ) == 0 )
+            OPTION(pareto_objective) = BOTTLENECK_TOTAL;
+          else if ( strcmp( optarg, "s_t" ) == 0 )
+            OPTION(pareto_objective) = STRETCH_TOTAL;
+          else if ( strcmp( optarg, "b_s" ) == 0 )
+            OPTION(pareto_objective) = BOTTLENECK_STRETCH;
           else {
             printf( "Bad value '%s' for option -P\n", optarg );
             printUsage();
@@ -286,13 +220,26 @@ int main( int argc, char * argv[] )
           break;
 
         case 'c':
-          capture_iteration = atoi( optarg );
+          OPTION(capture_iteration) = atoi( optarg );
+          break;
+
+        case 'C':
+          if ( strcmp( optarg, "insertion" ) == 0 )
+            OPTION(crossing_counter) = INSERTION_SORT;
+          else if ( strcmp( optarg, "tree" ) == 0 )
+            OPTION(crossing_counter) = ACCUMULATOR_TREE;
+          else {
+            printf( "Bad value '%s' for option -C\n", optarg );
+            printUsage();
+            exit( EXIT_FAILURE );
+          }
           break;
 
         case 'w':
-          if( strcmp( optarg, "none" ) == 0 ) adjust_weights = NONE;
-          else if( strcmp( optarg, "avg" ) == 0 ) adjust_weights = AVG; 
-          else if( strcmp( optarg, "left" ) == 0 ) adjust_weights = LEFT;
+          if( strcmp( optarg, "none" ) == 0 ) OPTION(adjust_weights) = NONE;
+          else if( strcmp( optarg, "avg" ) == 0 ) OPTION(adjust_weights) = AVG; 
+          else if( strcmp( optarg, "left" ) == 0 )
+            OPTION(adjust_weights) = LEFT;
           else
             {
               printf( "Bad value '%s' for option -w\n", optarg );
@@ -301,12 +248,14 @@ int main( int argc, char * argv[] )
             }
           break;
         case 'b':
-          balanced_weight = true;
+          OPTION(balanced_weight) = true;
           break;
         case 's':
-          if( strcmp( optarg, "layer" ) == 0 ) sift_option = LAYER;
-          else if( strcmp( optarg, "degree" ) == 0 ) sift_option = DEGREE; 
-          else if( strcmp( optarg, "random" ) == 0 ) sift_option = RANDOM;
+          if( strcmp( optarg, "layer" ) == 0 ) OPTION(sift_option) = LAYER;
+          else if( strcmp( optarg, "degree" ) == 0 )
+            OPTION(sift_option) = DEGREE;
+          else if( strcmp( optarg, "random" ) == 0 )
+            OPTION(sift_option) = RANDOM;
           else
             {
               printf( "Bad value '%s' for option -s\n", optarg );
@@ -315,10 +264,11 @@ int main( int argc, char * argv[] )
             }
           break;
         case 'e':
-          if( strcmp( optarg, "nodes" ) == 0 ) mce_option = NODES;
-          else if( strcmp( optarg, "edges" ) == 0 ) mce_option = EDGES; 
-          else if( strcmp( optarg, "early" ) == 0 ) mce_option = EARLY;
-          else if( strcmp( optarg, "one_node" ) == 0 ) mce_option = ONE_NODE;
+          if( strcmp( optarg, "nodes" ) == 0 ) OPTION(mce_option) = NODES;
+          else if( strcmp( optarg, "edges" ) == 0 ) OPTION(mce_option) = EDGES; 
+          else if( strcmp( optarg, "early" ) == 0 ) OPTION(mce_option) = EARLY;
+          else if( strcmp( optarg, "one_node" ) == 0 )
+            OPTION(mce_option) = ONE_NODE;
           else
             {
               printf( "Bad value '%s' for option -e\n", optarg );
@@ -327,8 +277,8 @@ int main( int argc, char * argv[] )
             }
           break;
         case 'g':
-          if( strcmp( optarg, "total" ) == 0 ) sifting_style = TOTAL;
-          else if( strcmp( optarg, "max" ) == 0 ) sifting_style = MAX; 
+          if( strcmp( optarg, "total" ) == 0 ) OPTION(sifting_style) = TOTAL;
+          else if( strcmp( optarg, "max" ) == 0 ) OPTION(sifting_style) = MAX; 
           else {
             printf( "Bad value '%s' for option -g\n", optarg );
             printUsage();
@@ -336,26 +286,67 @@ int main( int argc, char * argv[] )
           }
           break;
         case 'k':
-          number_of_processors = atoi( optarg );
+          OPTION(number_of_processors) = atoi( optarg );
+          break;
+        case 'K':
+          OPTION(sift_batch_size) = atoi( optarg );
+          if ( OPTION(sift_batch_size) < 1 )
+            {
+              printf( "Bad value '%s' for option -K\n", optarg );
+              printUsage();
+              exit( EXIT_FAILURE );
+            }
+          break;
+        case 'M':
+          OPTION(cache_pair_crossings) = true;
+          break;
+        case 'u':
+          if ( strcmp( optarg, "recount" ) == 0 ) OPTION(sift_update) = RECOUNT;
+          else if ( strcmp( optarg, "delta" ) == 0 )
+            OPTION(sift_update) = DELTA;
+          else if ( strcmp( optarg, "check" ) == 0 )
+            OPTION(sift_update) = CHECKED_DELTA;
+          else {
+            printf( "Bad value '%s' for option -u\n", optarg );
+            printUsage();
+            exit( EXIT_FAILURE );
+          }
           break;
         case 'f':
-          favored_edges = true;
+          OPTION(favored_edges) = true;
           break;
         case 'o':
-          produce_output = true;
-          output_base_name = calloc( strlen(optarg) + 1, sizeof(char) );
-          strcpy( output_base_name, optarg );
+          OPTION(produce_output) = true;
+          OPTION(output_base_name) = calloc( strlen(optarg) + 1, sizeof(char) );
+          strcpy( OPTION(output_base_name), optarg );
+          break;
+        case 'S':
+          OPTION(graph_format) = SGF;
+          break;
+        case 'W':
+          snapshot_file_name = optarg;
+          break;
+        case 'O':
+          start_order = optarg;
+          break;
+        case 'B':
+          background_output = true;
+          // the output thread's CPU time is not to be counted in RUNTIME
+          OPTION(thread_clock) = true;
+          break;
+        case 'X':
+          manifest_file_name = optarg;
           break;
         case 'v':
-          verbose = true;
+          OPTION(verbose) = true;
           break;
         case 't':
-          trace_freq = atoi( optarg );
+          OPTION(trace_freq) = atoi( optarg );
           break;
         case 'm':
-          number_of_processors = atoi(optarg);
+          OPTION(number_of_processors) = atoi(optarg);
 #ifdef _OPENMP
-          assert(number_of_processors <= omp_get_num_procs());
+          assert(OPTION(number_of_processors) <= omp_get_num_procs());
 #endif
           break;
         default:
@@ -365,58 +356,130 @@ int main( int argc, char * argv[] )
 
         }  /* end of switch */
     }  /* end of while */
+  return optind;
+}
+
+static void parseConfiguration( int argc, char * argv[] )
+{
+  if ( parseOptions( argc, argv, true ) != argc )
+    {
+      printf( "Batch configuration %s has extra arguments, starting with '%s'\n",
+              argv[0], argv[ optind ] );
+      exit( EXIT_FAILURE );
+    }
+}
+
+/**
+ * As of now, the main program does the following seqence of events -
+ * -# Read the DOT file
+ * -# Read the ORD file
+ * -# Display the attributes of the graph
+ * -# Count the number of crossings.
+ * -# Apply a preprocess and a heuristic (both optional) on the graph
+ * -# Optionally apply a post-processor that repeatedly swaps neighboring
+ * nodes until there's no more improvement
+ * -# Count the number of crossings after each phase (and save the ORD files
+ * for the minimum number of crossings in each phase)
+ */
+int main( int argc, char * argv[] )
+{
+  printf("################################################################\n");
+  printf("########### min_crossings, release 1.1, 2016/05/23 #############\n");
+
+  OPTION(number_of_processors) = 1;
+  int first_file = parseOptions( argc, argv, false );
+
+  if ( manifest_file_name != NULL )
+    {
+      if ( first_file != argc )
+        {
+          printf( "No file names are allowed with -X\n" );
+          printUsage();
+          exit( EXIT_FAILURE );
+        }
+      runBatch( manifest_file_name, parseConfiguration );
+      return EXIT_SUCCESS;
+    }
 
 #ifdef _OPENMP
   // set number of OpenMP threads
-  omp_set_num_threads(number_of_processors);
+  omp_set_num_threads(OPTION(number_of_processors));
 #endif
 
-  // start command line at first index after the options and get the two file
-  // names: dot and ord, respectively
-  argc -= optind;
-  argv += optind;
-  if( argc != 2 )
+  // start command line at first index after the options and get the file
+  // names: dot and ord, respectively, or a single sgf or snapshot file
+  argc -= first_file;
+  argv += first_file;
+  bool from_stdin = ( argc == 1 && strcmp( argv[0], "-" ) == 0 );
+  if( ! from_stdin && argc == 1 && OPTION(graph_format) == DOT_AND_ORD )
+    {
+      const char * extension = strrchr( argv[0], '.' );
+      if ( extension != NULL && strcmp( extension, ".sgf" ) == 0 )
+        OPTION(graph_format) = SGF;
+      else if ( extension != NULL && strcmp( extension, ".snap" ) == 0 )
+        OPTION(graph_format) = SNAPSHOT;
+    }
+  if( ! from_stdin && argc != ( OPTION(graph_format) == DOT_AND_ORD ? 2 : 1 ) )
     {
       printf( "Wrong number of filenames (%d)\n", argc );
       printUsage();
       exit( EXIT_FAILURE );
     }
+  if( start_order != NULL && OPTION(graph_format) != SNAPSHOT )
+    {
+      printf( "Option -O requires a snapshot file as input\n" );
+      printUsage();
+      exit( EXIT_FAILURE );
+    }
+  // for sgf or snapshot input, dot_file_name is the input file and there is
+  // no ord file; for standard input ("-"), it is "-" and the stream itself
+  // says whether it is sgf or dot followed by ord
   const char * dot_file_name = argv[0];
   const char * ord_file_name = argv[1];
 
+  if ( background_output ) startBackgroundOutput();
+
+  // initialize graph
+  if ( from_stdin )
+    OPTION(graph_format) = readGraphStream( stdin, "standard input" );
+  else if ( OPTION(graph_format) == SGF )
+    readSgf( dot_file_name );
+  else if ( OPTION(graph_format) == SNAPSHOT )
+    readSnapshot( dot_file_name, start_order );
+  else
+    readGraph( dot_file_name, ord_file_name );
+
   // handle special case where user specified an empty (_) base name for output
-  if ( produce_output
-       && strlen(output_base_name) == 1
-       && * output_base_name == '_' )
+  if ( OPTION(produce_output)
+       && strlen(OPTION(output_base_name)) == 1
+       && * OPTION(output_base_name) == '_' )
     {
-      free( output_base_name );
+      free( OPTION(output_base_name) );
       char buffer[MAX_NAME_LENGTH];
-      strcpy( buffer, dot_file_name );
+      // there is no file name if the graph came from standard input
+      strcpy( buffer, from_stdin ? CTX(graph_name) : dot_file_name );
 #ifdef DEBUG
       printf( "output special case: buffer = %s, dot_file_name = %s\n",
               buffer, dot_file_name );
 #endif
-      char * base_name_ptr = base_name( buffer );
+      char * base_name_ptr = from_stdin ? buffer : base_name( buffer );
 #ifdef DEBUG
       printf( "output special case: buffer = %s, base = %s\n",
               buffer, base_name_ptr );
 #endif
-      output_base_name
+      OPTION(output_base_name)
         = (char *) calloc( strlen(base_name_ptr) + 1, sizeof(char) );
-      strcpy( output_base_name, base_name_ptr ); 
+      strcpy( OPTION(output_base_name), base_name_ptr ); 
     }
 
-  // initialize graph
-  readGraph( dot_file_name, ord_file_name );
-
   // create list of favored edges if appropriate
   // do the allocations unconditionally to avoid having to check for
   // 'favored_edges' everywhere
   initPriorityEdges();
-  if ( favored_edges )
+  if ( OPTION(favored_edges) )
     {
-      Layerptr middle_layer = layers[ number_of_layers / 2 ];
-      int middle_node_position = middle_layer->number_of_nodes / 2;
+      Layerptr middle_layer = CTX(layers)[ CTX(number_of_layers) / 2 ];
+      int middle_node_position = middle_layer->node_count / 2;
       Nodeptr middle_node = middle_layer->nodes[ middle_node_position ];
       createFanoutList( middle_node );
       // create an actual file name and graph name here when the test version
@@ -443,32 +506,38 @@ int main( int argc, char * argv[] )
 
   // set up structures for saving layer orders of best solutions so far
   // (these are updated as appropriate in heuristics.c)
-  best_crossings_order = (Orderptr) calloc( 1, sizeof(struct order_struct) ); 
-  init_order( best_crossings_order );
+  CTX(best_crossings_order)
+    = (Orderptr) calloc( 1, sizeof(struct order_struct) );
+  init_order( CTX(best_crossings_order) );
 
-  best_edge_crossings_order
+  CTX(best_edge_crossings_order)
     = (Orderptr) calloc( 1, sizeof(struct order_struct) ); 
-  init_order( best_edge_crossings_order );
+  init_order( CTX(best_edge_crossings_order) );
 
-  best_total_stretch_order
+  CTX(best_total_stretch_order)
     = (Orderptr) calloc( 1, sizeof(struct order_struct) ); 
-  init_order( best_total_stretch_order );
+  init_order( CTX(best_total_stretch_order) );
 
-  best_bottleneck_stretch_order
+  CTX(best_bottleneck_stretch_order)
     = (Orderptr) calloc( 1, sizeof(struct order_struct) ); 
-  init_order( best_bottleneck_stretch_order );
+  init_order( CTX(best_bottleneck_stretch_order) );
 
-  best_favored_crossings_order
+  CTX(best_favored_crossings_order)
     = (Orderptr) calloc( 1, sizeof(struct order_struct) ); 
-  init_order( best_favored_crossings_order );
+  init_order( CTX(best_favored_crossings_order) );
 
   // start the clock
-  start_time = getUserSeconds();
+  CTX(start_time) = USER_SECONDS;
 #ifdef DEBUG
-  printf( "start_time = %f\n", start_time );
+  printf( "start_time = %f\n", CTX(start_time) );
 #endif
 
-  runPreprocessor();
+  if ( ! runPreprocessor() )
+    {
+      printf( "Bad preprocessor '%s'\n", OPTION(preprocessor) );
+      printUsage();
+      exit( EXIT_FAILURE );
+    }
   updateAllCrossings();
   capture_preprocessing_stats();
 #ifdef DEBUG
@@ -477,28 +546,33 @@ int main( int argc, char * argv[] )
 
   // end of "iteration 0"
   end_of_iteration();
-  runHeuristic();
+  if ( ! runHeuristic() )
+    {
+      printf( "Bad heuristic '%s'\n", OPTION(heuristic) );
+      printUsage();
+      exit( EXIT_FAILURE );
+    }
   capture_heuristic_stats();
 #ifdef DEBUG
   printf( "after heuristic, runtime = %f\n", RUNTIME );
 #endif
 
-  if ( produce_output ) {
+  if ( OPTION(produce_output) ) {
     // write ordering after heuristic, before post-processing
-    restore_order( best_crossings_order );
+    restore_order( CTX(best_crossings_order) );
     createOrdFileName( output_file_name, "" );
-    writeOrd( output_file_name );
+    writeOrdering( output_file_name );
   }
 
-  if ( do_post_processing ) {
-    restore_order( best_crossings_order );
+  if ( OPTION(do_post_processing) ) {
+    restore_order( CTX(best_crossings_order) );
     updateAllCrossings();
     swapping();
 
-    if ( produce_output ) {
+    if ( OPTION(produce_output) ) {
       // write file with best total crossings order after post-processing
       createOrdFileName( output_file_name, "-post" );
-      writeOrd( output_file_name );
+      writeOrdering( output_file_name );
     }
   }
 
@@ -510,57 +584,73 @@ int main( int argc, char * argv[] )
 #endif
 
   // write file with best order for edge crossings
-  if ( produce_output ) {
+  if ( OPTION(produce_output) ) {
       // write file with best max edge order after overall
-      restore_order( best_edge_crossings_order );
+      restore_order( CTX(best_edge_crossings_order) );
       createOrdFileName( output_file_name, "-edge" );
-      writeOrd( output_file_name );
+      writeOrdering( output_file_name );
   }
 
-  if ( produce_output ) {
+  if ( OPTION(produce_output) ) {
       // write file with best stretch order overall
-      restore_order( best_total_stretch_order );
+      restore_order( CTX(best_total_stretch_order) );
       createOrdFileName( output_file_name, "-stretch" );
-      writeOrd( output_file_name );
+      writeOrdering( output_file_name );
   }
 
-  if ( produce_output ) {
+  if ( OPTION(produce_output) ) {
       // write file with best stretch order overall
-      restore_order( best_bottleneck_stretch_order );
+      restore_order( CTX(best_bottleneck_stretch_order) );
       createOrdFileName( output_file_name, "-bs" );
-      writeOrd( output_file_name );
+      writeOrdering( output_file_name );
   }
 
 #ifdef FAVORED
   // write file with best order for favored edge crossings
-  restore_order( best_favored_crossings_order );
+  restore_order( CTX(best_favored_crossings_order) );
   createOrdFileName( output_file_name, "-favored" );
-  writeOrd( output_file_name );
+  writeOrdering( output_file_name );
 #endif
 
+  if ( snapshot_file_name != NULL ) {
+    const struct order_struct * best_orders[] = {
+      CTX(best_crossings_order), CTX(best_edge_crossings_order),
+      CTX(best_total_stretch_order), CTX(best_bottleneck_stretch_order)
+    };
+    const char * order_names[] = {
+      CTX(total_crossings).name, CTX(max_edge_crossings).name,
+      CTX(total_stretch).name, CTX(bottleneck_stretch).name
+    };
+    writeSnapshot( snapshot_file_name, 4, best_orders, order_names );
+  }
+
   print_run_statistics( stdout );
+  // wait for the output files still being written
+  finishBackgroundOutput();
 
   // deallocate all order structures
-  cleanup_order( best_crossings_order );
-  free( best_crossings_order );
-  cleanup_order( best_edge_crossings_order );
-  free( best_edge_crossings_order );
-  cleanup_order( best_total_stretch_order );
-  free( best_total_stretch_order );
-  cleanup_order( best_bottleneck_stretch_order );
-  free( best_bottleneck_stretch_order );
-#ifdef FAVORED
-  cleanup_order( best_favored_crossings_order );
-  free( best_favored_crossings_order );
-#endif
-
-  /**
-   * @todo Need functions to deallocate everything (in the appropriate modules)
-   */
+  cleanup_order( CTX(best_crossings_order) );
+  free( CTX(best_crossings_order) );
+  cleanup_order( CTX(best_edge_crossings_order) );
+  free( CTX(best_edge_crossings_order) );
+  cleanup_order( CTX(best_total_stretch_order) );
+  free( CTX(best_total_stretch_order) );
+  cleanup_order( CTX(best_bottleneck_stretch_order) );
+  free( CTX(best_bottleneck_stretch_order) );
+  cleanup_order( CTX(best_favored_crossings_order) );
+  free( CTX(best_favored_crossings_order) );
+  cleanup_versions();
+
+  freeHeuristics();
+  cleanup_crossing_stats();
+  freePriorityEdges();
+  freeChannels();
+  freeCrossings();
+  freeGraph();
   return EXIT_SUCCESS;
 }
 
-/*  [Last modified: 2016 05 24 at 13:39:27 GMT] */
+/*  [Last modified: 2026 10 16 at 19:06:21 GMT] */
 
 /* the line below is to ensure that this file gets benignly modified via
    'make version' */
@@ -46,96 +46,123 @@ const char END_OF_LINE = '\n';
 const char OPEN_LIST = '{';
 const char CLOSE_LIST = '}';
 
-static char name_buffer[MAX_NAME_LENGTH]; // used to report graph name
-static bool valid_name = false;        // true if an actual name was found
+// The state of the reader is kept in the input (see mapped_input.h) and that
+// of the writer is thread-local, so that different threads can read and
+// write ord files at the same time
 
-static bool eatSpaceAndComments( FILE * in )
+enum { OUTSIDE_LAYER, LAYER_NUMBER, INSIDE_LAYER };
+
+/**
+ * Saves the last word of the first comment line, which begins at
+ * in->position, as the name of the graph
+ */
+static void saveGraphName( MappedInputptr in )
+{
+  const char * word = in->position;
+  const char * position = in->position;
+  while ( position < in->end && END_OF_LINE != * position ) {
+    if ( BLANK_CHAR == * position ) word = position + 1;
+    position++;
+  }
+  if ( position == in->end ) return;  // first comment is not a whole line
+  in->name_of_graph.start = word;
+  in->name_of_graph.length = position - word;
+  if ( in->name_of_graph.length > 0 ) in->valid_name = true;
+}
+
+static bool eatSpaceAndComments( MappedInputptr in )
   // POST: 'in' is at the first non-blank character after its initial
   //       position (with comments excluded);
   //       retval == true iff there is another non-blank character before
   //                 the end of file 
 {
-  static bool first_comment = true; // name appears at the end of first comment
-  enum { NOT_IN_COMMENT, IN_COMMENT } local_state = NOT_IN_COMMENT;
-  int ch;
-  int index = 0;
-  while ( (ch = getc( in )) != EOF ) {
-    switch ( local_state ) {
-    case NOT_IN_COMMENT:
-      if ( COMMENT_CHAR == ch ) local_state = IN_COMMENT;
-      else if ( ! isspace( ch ) ) {
-        ungetc( ch, in );
-        return true;
+  const char * position = in->position;
+  const char * end = in->end;
+  while ( position < end ) {
+    char ch = * position;
+    if ( COMMENT_CHAR == ch ) {
+      // name appears at the end of first comment
+      if ( in->first_comment ) {
+        in->position = position + 1;
+        saveGraphName( in );
+        in->first_comment = false;
       }
-      break;
-    case IN_COMMENT:
-      if ( END_OF_LINE == ch ) local_state = NOT_IN_COMMENT;
-      // if this is the first comment line, save the last "word" -- it's
-      // the name of the graph.
-      if( first_comment ) {
-        if ( END_OF_LINE == ch ) {
-          name_buffer[index] = NULL_CHAR;
-          if( index > 0 ) {
-            valid_name = true;
-          }
-          first_comment = false;
-        }
-        else if ( BLANK_CHAR == ch ) {
-          index = 0;
-        }
-        else {
-          name_buffer[index++] = ch;
-        }
-      } // if this is the first comment
-      break;
-    default: assert( "bad local state" && false );
+      while ( position < end && END_OF_LINE != * position ) position++;
+    }
+    else if ( isspace( (unsigned char) ch ) ) {
+      if ( END_OF_LINE == ch ) in->line_number++;
+      position++;
+    }
+    else {
+      in->position = position;
+      return true;
     }
   }
+  in->position = end;
   return false;
 }
 
-bool getGraphName( FILE * in, char * buffer ) {
+bool getGraphName( MappedInputptr in, char * buffer ) {
   eatSpaceAndComments( in );
-  if( valid_name ) {
-    strcpy( buffer, name_buffer );
+  if( in->valid_name ) {
+    int length = in->name_of_graph.length < MAX_NAME_LENGTH
+      ? in->name_of_graph.length : MAX_NAME_LENGTH - 1;
+    memcpy( buffer, in->name_of_graph.start, length );
+    buffer[ length ] = NULL_CHAR;
     return true;
   }
   return false;
 }
 
-static enum { OUTSIDE_LAYER,
-              LAYER_NUMBER,
-              INSIDE_LAYER } state = OUTSIDE_LAYER;
-
-static int hold_layer = -1;     // most recent layer number encountered
+/**
+ * Reads a layer number, i.e., a sequence of digits, possibly preceded by a
+ * sign
+ */
+static int readLayerNumber( MappedInputptr in )
+{
+  const char * position = in->position;
+  bool negative = false;
+  if ( '-' == * position || '+' == * position ) {
+    negative = '-' == * position;
+    position++;
+  }
+  if ( position == in->end || ! isdigit( (unsigned char) * position ) ) {
+    inputError( in, "Read error in .ord file: layer number expected" );
+    abort();
+  }
+  int number = 0;
+  while ( position < in->end && isdigit( (unsigned char) * position ) )
+    number = 10 * number + ( * position++ - '0' );
+  in->position = position;
+  return negative ? - number : number;
+}
 
-bool nextLayer( FILE * in, int * layer )
+bool nextLayer( MappedInputptr in, int * layer )
 {
   * layer = -1;
-  int ch;
-  while ( eatSpaceAndComments( in ) && (ch = getc( in )) != EOF ) {
-    switch ( state ) {
+  while ( eatSpaceAndComments( in ) ) {
+    switch ( in->ord_state ) {
     case OUTSIDE_LAYER:
-      ungetc( ch, in );         // put back first digit of expected int
-      fscanf( in, "%d", layer );
-      hold_layer = * layer;
-      state = LAYER_NUMBER;
+      * layer = readLayerNumber( in );
+      in->current_layer = * layer;
+      in->ord_state = LAYER_NUMBER;
       break;
     case LAYER_NUMBER:
-      if ( OPEN_LIST == ch ) {
-        state = INSIDE_LAYER;
+      if ( OPEN_LIST == * in->position++ ) {
+        in->ord_state = INSIDE_LAYER;
         assert( * layer >= 0 );
         return true;
       }
       else {
-        fprintf( stderr, "\nRead error in .ord file: %d"
-                 " expected, reading %c instead.", OPEN_LIST, ch );
+        inputError( in, "Read error in .ord file: '%c'"
+                    " expected, reading '%c' instead.",
+                    OPEN_LIST, in->position[-1] );
         abort();
       }
       break;
     case INSIDE_LAYER:
-      if ( CLOSE_LIST == ch )
-        state = OUTSIDE_LAYER; 
+      if ( CLOSE_LIST == * in->position++ )
+        in->ord_state = OUTSIDE_LAYER; 
       break;
     default: assert( "bad state" && false );
     }
@@ -143,80 +170,79 @@ bool nextLayer( FILE * in, int * layer )
   return false;
 }
 
-bool nextNode( FILE * in, char * node_buffer )
+bool nextNode( MappedInputptr in, NameSlice * node )
 {
-  assert( INSIDE_LAYER == state );
+  assert( INSIDE_LAYER == in->ord_state );
   if ( ! eatSpaceAndComments( in ) ) {
-    fprintf( stderr, "Read error in .ord file: unexpected end of file\n"
-             "while reading nodes in layer %d\n", hold_layer );
+    inputError( in, "Read error in .ord file: unexpected end of file"
+                " while reading nodes in layer %d", in->current_layer );
     abort();
   }
-  int index = 0;
-  int ch;
-  while ( (ch = getc( in )) != EOF ) {
-    if ( CLOSE_LIST == ch || COMMENT_CHAR == ch || isspace( ch ) ) {
-      ungetc( ch, in );
-      if ( 0 == index )
-        return false;
-      node_buffer[ index ] = '\0';
+  const char * start = in->position;
+  const char * position = start;
+  while ( position < in->end
+          && CLOSE_LIST != * position && COMMENT_CHAR != * position
+          && ! isspace( (unsigned char) * position ) )
+    position++;
+  in->position = position;
+  if ( position == start )
+    return false;
+  node->start = start;
+  node->length = position - start;
 #ifdef DEBUG
-      printf( "<- nextNode: %s\n", node_buffer );
+  printf( "<- nextNode: %.*s\n", node->length, node->start );
 #endif
-      return true;
-    }
-    else {
-      node_buffer[ index++ ] = ch;
-    }
-  }
-  // should never get here
-  assert( false && "Unexpected end of file while reading layer\n" );
-  return false;
+  return true;
 }
 
-static int current_column = 0;  // keeps track of column while printing
-static int number_of_nodes = 0; // number of nodes on current line
-static int output_layer = -1;   // current layer during output
+static __thread int current_column = 0;  // keeps track of column while printing
+static __thread int number_of_nodes = 0; // number of nodes on current line
+static __thread int output_layer = -1;   // current layer during output
 
-void ordPreamble( FILE * out, const char * graph_name,
+void ordPreamble( OutputBufferptr out, const char * name_of_graph,
                    const char * generation_method )
 {
-  fprintf( out, "# Ordering for graph %s\n", graph_name );
-  fprintf( out, "# %s\n\n", generation_method );
+  appendFormatted( out, "# Ordering for graph %s\n", name_of_graph );
+  appendFormatted( out, "# %s\n\n", generation_method );
 }
 
-void beginLayer( FILE * out, int layer, const char * type )
+void beginLayer( OutputBufferptr out, int layer, const char * type )
 {
-  fprintf( out, "# Order for layer %d: %s\n", layer, type );
-  fprintf( out, "%d {\n ", layer );
+  appendFormatted( out, "# Order for layer %d: %s\n", layer, type );
+  appendInt( out, layer );
+  appendString( out, " {\n " );
   output_layer = layer;
   current_column = 0;
   number_of_nodes = 0;
 }
 
-void endLayer( FILE * out )
+void endLayer( OutputBufferptr out )
 {
   assert( 0 <= output_layer );
-  if ( 0 < number_of_nodes ) fprintf( out, "\n" );
-  fprintf( out, "} # end of layer %d\n\n", output_layer );
+  if ( 0 < number_of_nodes ) appendChar( out, '\n' );
+  appendString( out, "} # end of layer " );
+  appendInt( out, output_layer );
+  appendString( out, "\n\n" );
   output_layer = -1;
 }
 
-void outputNode( FILE * out, const char * node )
+void outputNode( OutputBufferptr out, const char * node )
 {
   assert( 0 <= output_layer );
+  int length = strlen( node );
   if ( 0 < number_of_nodes
-       && LINE_LENGTH <= current_column + (int) strlen( node ) ) {
-    fprintf( out, "\n" );
+       && LINE_LENGTH <= current_column + length ) {
+    appendChar( out, '\n' );
     current_column = 0;
     number_of_nodes = 0;
   }
   if ( 0 < number_of_nodes ) {
-    fprintf( out, " " );
+    appendChar( out, ' ' );
     ++current_column;
   }
-  fprintf( out, "%s", node );
-  current_column += strlen( node );
+  appendText( out, node, length );
+  current_column += length;
   ++number_of_nodes;
 }
 
-//  [Last modified: 2014 09 10 at 14:15:06 GMT]
+//  [Last modified: 2026 10 16 at 16:36:44 GMT]
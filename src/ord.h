@@ -44,17 +44,20 @@
 //
 // where there are k+1 layers numbered 0 through k
 //
-// To read a .ord file via the stream 'in', do the following:
+// To read a .ord file with name 'file_name', do the following:
+//   MappedInputptr in = openMappedInput( file_name );
 //   int layer;
-//   char name_buf[MAX_NAME_LENGTH];
+//   NameSlice node;
 //   while ( nextLayer( in, & layer ) )
 //     {
 //       // initialize the layer
-//       while ( nextNode( in, name_buf ) )
+//       while ( nextNode( in, & node ) )
 //         {
-//           // do something with the node whose name is on name_buf
+//           // do something with the node whose name is node.start[0],
+//           // ..., node.start[node.length - 1]
 //         }
 //     }
+//   closeMappedInput( in );
 
 #ifndef ORD_H
 #define ORD_H
@@ -62,9 +65,11 @@
 #include<stdio.h>
 #include<stdbool.h>
 #include"defs.h"
+#include"mapped_input.h"
+#include"output_buffer.h"
 
-bool getGraphName( FILE * in, char * buffer );
-// PRE: 'in' is a valid istream for a .ord file
+bool getGraphName( MappedInputptr in, char * buffer );
+// PRE: 'in' is a valid input for a .ord file
 //      'buffer' is large enough to hold a graph name
 // POST: 'in' is beyond the initial comments and white space
 //       'buffer' contains the name of the graph, if any (last word of the
@@ -72,45 +77,45 @@ bool getGraphName( FILE * in, char * buffer );
 //       retval == true iff there was a nonblank comment before there was
 //                 any meaningful input 
 
-bool nextLayer( FILE * in, int * layer );
-// PRE: 'in' is a valid istream for a .ord file
+bool nextLayer( MappedInputptr in, int * layer );
+// PRE: 'in' is a valid input for a .ord file
 // POST: 'in' is at the first node of the next layer (if any)
 //       'layer' == the number of the next layer (if any)
 //       retval == true iff there is another layer
 
-bool nextNode( FILE * in, char * node_buffer );
-// PRE: 'in' is a valid istream for a .ord file and is positioned somewhere
+bool nextNode( MappedInputptr in, NameSlice * node );
+// PRE: 'in' is a valid input for a .ord file and is positioned somewhere
 //      inside the list of nodes for a layer
 // POST: 'in' is beyond the next node (if any)
-//       node_buffer has the string representing the next node in it
+//       'node' is the slice of the input holding the next node's name
 //       retval == true iff there is another node on the current layer
 
 // output functions
 
-void ordPreamble( FILE * out, const char * graph_name,
+void ordPreamble( OutputBufferptr out, const char * name_of_graph,
                    const char * generation_method );
-// PRE: 'out' is a valid ostream
+// PRE: 'out' is a valid output buffer
 // POST: comments identifying the graph and the way it was generated have
 // been written on 'out'
 
 /**
  * Writes text needed for the beginning of a layer
- * @param out output stream
+ * @param out output buffer
  * @param layer layer number
  * @param type additional information, e.g., whether the ordering was
  * randomized, natural (based on dot file), or on a heuristic
  */
-void beginLayer( FILE * out, int layer, const char * type );
+void beginLayer( OutputBufferptr out, int layer, const char * type );
 
-void endLayer( FILE * out );
-// PRE: 'out' is a valid ostream
+void endLayer( OutputBufferptr out );
+// PRE: 'out' is a valid output buffer
 // POST: the encoding for the end of the current layer has been written on
 //       'out' 
 
-void outputNode( FILE * out, const char * node );
-// PRE: 'out' is a valid ostream
+void outputNode( OutputBufferptr out, const char * node );
+// PRE: 'out' is a valid output buffer
 // POST: the 'node' is listed next for the current layer on 'out' 
 
 #endif
 
-/*  [Last modified: 2008 12 29 at 19:01:52 GMT] */
+/*  [Last modified: 2026 10 16 at 16:36:44 GMT] */
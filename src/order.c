@@ -9,6 +9,7 @@
 
 #include"order.h"
 #include"graph.h"
+#include"graph_core.h"
 
 #ifdef DEBUG
 #include"crossings.h"
@@ -18,19 +19,83 @@
 #include<stdlib.h>
 #include<assert.h>
 
-void init_order( Orderptr ord_info )
+/**
+ * CTX(layer_version)[i] identifies the current order of layer i; a new
+ * version number is drawn from CTX(version_counter) whenever the order
+ * changes, so the same version is never used for two different orders of a
+ * layer
+ */
+
+/**
+ * CTX(latest_image)[i] is the most recently created image of layer i, if
+ * it still exists; used to share images among saved orders
+ */
+
+static void init_versions( void )
+{
+  CTX(layer_version)
+    = (unsigned long *) calloc( CTX(number_of_layers), sizeof(unsigned long) );
+  CTX(latest_image)
+    = (LayerImageptr *) calloc( CTX(number_of_layers), sizeof(LayerImageptr) );
+  for ( int i = 0; i < CTX(number_of_layers); i++ )
+    CTX(layer_version)[i] = ++CTX(version_counter);
+}
+
+void layerOrderChanged( int layer )
+{
+  layerPositionsChanged( layer );
+  // versions are only relevant once an order has been saved
+  if ( CTX(layer_version) == NULL ) return;
+  // layers at least two apart may be sifted concurrently
+  unsigned long version;
+#ifdef _OPENMP
+#pragma omp atomic capture
+#endif
+  version = ++CTX(version_counter);
+  CTX(layer_version)[ layer ] = version;
+}
+
+static LayerImageptr new_image( int layer )
+{
+  LayerImageptr image
+    = (LayerImageptr) malloc( sizeof(struct layer_image_struct) );
+  image->layer = layer;
+  image->version = 0;
+  image->references = 1;
+  image->nodes
+    = (Nodeptr *) malloc( CTX(layers)[layer]->node_count * sizeof(Nodeptr) );
+  return image;
+}
+
+static void release_image( LayerImageptr image )
 {
-  ord_info->num_layers = number_of_layers;
-  ord_info->num_nodes_on_layer
-    = (int *) calloc( number_of_layers, sizeof(int) );
-  ord_info->node_ptr_on_layer
-    = (Nodeptr * *) calloc( number_of_layers, sizeof(Nodeptr *) );
-  for ( int i = 0; i < number_of_layers; i++ )
+  if ( --image->references > 0 ) return;
+  if ( CTX(latest_image)[ image->layer ] == image )
+    CTX(latest_image)[ image->layer ] = NULL;
+  free( image->nodes );
+  free( image );
+}
+
+/**
+ * Copies the current order of the layer into the image
+ */
+static void copy_layer( LayerImageptr image )
+{
+  int layer = image->layer;
+  for( int j = 0; j < CTX(layers)[layer]->node_count; j++ )
     {
-      ord_info->num_nodes_on_layer[i] = layers[i]->number_of_nodes;
-      ord_info->node_ptr_on_layer[i]
-        = (Nodeptr *) calloc( layers[i]->number_of_nodes, sizeof(Nodeptr) );
+      image->nodes[j] = CTX(layers)[layer]->nodes[j];
     }
+  image->version = CTX(layer_version)[ layer ];
+  CTX(latest_image)[ layer ] = image;
+}
+
+void init_order( Orderptr ord_info )
+{
+  if ( CTX(layer_version) == NULL ) init_versions();
+  ord_info->num_layers = CTX(number_of_layers);
+  ord_info->layer_image
+    = (LayerImageptr *) calloc( CTX(number_of_layers), sizeof(LayerImageptr) );
   save_order( ord_info );
 }
 
@@ -39,21 +104,44 @@ void cleanup_order( Orderptr ord_info )
   if ( ord_info->num_layers == 0 ) return;
   for ( int i = 0; i < ord_info->num_layers; i++ )
     {
-      free( ord_info->node_ptr_on_layer[i] );
+      if ( ord_info->layer_image[i] != NULL )
+        release_image( ord_info->layer_image[i] );
     }
-  free( ord_info->node_ptr_on_layer );
-  free( ord_info->num_nodes_on_layer );
+  free( ord_info->layer_image );
+}
+
+void cleanup_versions( void )
+{
+  free( CTX(layer_version) );
+  free( CTX(latest_image) );
+  CTX(layer_version) = NULL;
+  CTX(latest_image) = NULL;
 }
 
 void save_order( Orderptr ord_info )
 {
-  ord_info->num_layers = number_of_layers;
-  for ( int i = 0; i < number_of_layers; i++ )
+  ord_info->num_layers = CTX(number_of_layers);
+  for ( int i = 0; i < CTX(number_of_layers); i++ )
     {
-      for( int j = 0; j < layers[i]->number_of_nodes; j++ )
+      LayerImageptr image = ord_info->layer_image[i];
+      if ( image != NULL && image->version == CTX(layer_version)[i] ) continue;
+      LayerImageptr latest = CTX(latest_image)[i];
+      if ( latest != NULL && latest->version == CTX(layer_version)[i] )
+        {
+          // another saved order already has this version of the layer
+          if ( image != NULL ) release_image( image );
+          latest->references++;
+          ord_info->layer_image[i] = latest;
+        }
+      else if ( image != NULL && image->references == 1 )
+        {
+          copy_layer( image );
+        }
+      else
         {
-          Nodeptr node = layers[i]->nodes[j];
-          ord_info->node_ptr_on_layer[i][j] = node; 
+          if ( image != NULL ) release_image( image );
+          ord_info->layer_image[i] = new_image( i );
+          copy_layer( ord_info->layer_image[i] );
         }
     }
 }
@@ -67,16 +155,19 @@ void restore_order( Orderptr ord_info )
   // reorder each layer according to the information stored in ord_info
   for ( int i = 0; i < ord_info->num_layers; i++ )
     {
-      for( int j = 0; j < ord_info->num_nodes_on_layer[i]; j++ )
+      LayerImageptr image = ord_info->layer_image[i];
+      for( int j = 0; j < CTX(layers)[i]->node_count; j++ )
         {
-          Nodeptr node = ord_info->node_ptr_on_layer[i][j];
-          layers[i]->nodes[j] = node;
+          Nodeptr node = image->nodes[j];
+          CTX(layers)[i]->nodes[j] = node;
           node->position = j;
         }
+      CTX(layer_version)[i] = image->version;
+      layerPositionsChanged( i );
 #ifdef DEBUG
       updateAllCrossings();
       printf( " - restore_order, i = %d, num_nodes = %d, crossings = %d\n",
-              i, ord_info->num_nodes_on_layer[i], numberOfCrossings() );
+              i, CTX(layers)[i]->node_count, numberOfCrossings() );
 #endif
     }
 #ifdef DEBUG
@@ -85,4 +176,4 @@ void restore_order( Orderptr ord_info )
 #endif
 }
 
-/*  [Last modified: 2011 05 23 at 21:09:34 GMT] */
+/*  [Last modified: 2026 10 16 at 16:51:03 GMT] */
@@ -12,14 +12,30 @@
 
 #include"graph.h"
 
+/**
+ * The order of one layer at some point in time, possibly shared among
+ * several saved orders. The version identifies the order: two images with
+ * the same version have the same content.
+ */
+typedef struct layer_image_struct {
+  int layer;
+  unsigned long version;
+  int references;
+  Nodeptr * nodes;
+} * LayerImageptr;
+
 /**
  * Keeps track of order information for each layer; used to save the state
  * for orderings that give minimum crossings or edge crossings.
  */
 typedef struct order_struct {
   int num_layers;
-  int * num_nodes_on_layer;
-  Nodeptr * * node_ptr_on_layer;
+  /**
+   * layer_image[i] is the saved order of layer i; saving copies only layers
+   * whose order has changed since they were last saved and shares layers
+   * that are identical to those saved by another order_struct
+   */
+  LayerImageptr * layer_image;
 } * Orderptr;
 
 /**
@@ -34,9 +50,22 @@ void init_order( Orderptr ord_info );
  */
 void cleanup_order( Orderptr ord_info );
 
+/**
+ * Deallocates the version information shared by all orders of the current
+ * graph; to be called after all of them have been cleaned up
+ */
+void cleanup_versions( void );
+
+/**
+ * Must be called whenever the order of nodes on the given layer may have
+ * changed; any function that changes node positions should do so.
+ */
+void layerOrderChanged( int layer );
+
 /**
  * Copies information from the current graph configuration into the
- * order_struct referenced by ord_info.
+ * order_struct referenced by ord_info. Only layers that have changed since
+ * ord_info was last saved are copied.
  */
 void save_order( Orderptr ord_info );
 
@@ -48,4 +77,4 @@ void restore_order( Orderptr ord_info );
 
 #endif
 
-/*  [Last modified: 2011 05 23 at 16:11:40 GMT] */
+/*  [Last modified: 2026 10 16 at 16:51:03 GMT] */
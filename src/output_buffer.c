@@ -0,0 +1,219 @@
+/**
+ * @file output_buffer.c
+ * @brief Buffered output files and the background output thread - see
+ * output_buffer.h
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+// pthreads are POSIX, not C99
+#define _POSIX_C_SOURCE 200112L
+
+#include"output_buffer.h"
+
+#include<stdlib.h>
+#include<string.h>
+#include<stdarg.h>
+#include<pthread.h>
+
+/**
+ * Initial capacity of a buffer; it doubles whenever it is full
+ */
+#define MIN_BUFFER_CAPACITY ( 1 << 16 )
+
+struct output_buffer_struct {
+  char * text;
+  size_t length;
+  size_t capacity;
+  FILE * stream;
+  bool close_when_written;
+  /** next buffer in the queue of the output thread */
+  struct output_buffer_struct * next;
+};
+
+/**
+ * The output thread and its queue of buffers, oldest first; shared by all
+ * threads that write output, so everything below is protected by
+ * queue_lock.
+ */
+static pthread_t output_thread;
+static bool background_output = false;
+static bool output_finished = false;
+static OutputBufferptr queue_head = NULL;
+static OutputBufferptr queue_tail = NULL;
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_not_empty = PTHREAD_COND_INITIALIZER;
+
+OutputBufferptr createOutputBuffer( FILE * stream, bool close_when_written )
+{
+  OutputBufferptr buffer
+    = (OutputBufferptr) malloc( sizeof(struct output_buffer_struct) );
+  if ( buffer != NULL )
+    buffer->text = (char *) malloc( MIN_BUFFER_CAPACITY );
+  if ( buffer == NULL || buffer->text == NULL )
+    {
+      fprintf( stderr, "FATAL: createOutputBuffer, unable to allocate %d bytes\n",
+               MIN_BUFFER_CAPACITY );
+      abort();
+    }
+  buffer->length = 0;
+  buffer->capacity = MIN_BUFFER_CAPACITY;
+  buffer->stream = stream;
+  buffer->close_when_written = close_when_written;
+  buffer->next = NULL;
+  return buffer;
+}
+
+/**
+ * Makes sure that at least the given number of bytes can be appended
+ */
+static void reserve( OutputBufferptr buffer, size_t additional )
+{
+  if ( buffer->length + additional <= buffer->capacity ) return;
+  size_t capacity = buffer->capacity;
+  while ( capacity < buffer->length + additional ) capacity *= 2;
+  buffer->text = (char *) realloc( buffer->text, capacity );
+  if ( buffer->text == NULL )
+    {
+      fprintf( stderr, "FATAL: output buffer, unable to allocate %zu bytes\n",
+               capacity );
+      abort();
+    }
+  buffer->capacity = capacity;
+}
+
+void appendText( OutputBufferptr buffer, const char * text, size_t length )
+{
+  reserve( buffer, length );
+  memcpy( buffer->text + buffer->length, text, length );
+  buffer->length += length;
+}
+
+void appendString( OutputBufferptr buffer, const char * string )
+{
+  appendText( buffer, string, strlen( string ) );
+}
+
+void appendChar( OutputBufferptr buffer, char ch )
+{
+  reserve( buffer, 1 );
+  buffer->text[ buffer->length++ ] = ch;
+}
+
+void appendInt( OutputBufferptr buffer, int number )
+{
+  // digits are produced in reverse, least significant first
+  char digits[12];
+  int count = 0;
+  unsigned int magnitude = number < 0 ? - (unsigned int) number : number;
+  do {
+    digits[ count++ ] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while ( magnitude > 0 );
+  reserve( buffer, count + 1 );
+  if ( number < 0 ) buffer->text[ buffer->length++ ] = '-';
+  while ( count > 0 ) buffer->text[ buffer->length++ ] = digits[ --count ];
+}
+
+void appendFormatted( OutputBufferptr buffer, const char * format, ... )
+{
+  va_list arguments;
+  va_start( arguments, format );
+  int length = vsnprintf( NULL, 0, format, arguments );
+  va_end( arguments );
+  // room for the '\0' that vsnprintf() insists on writing
+  reserve( buffer, length + 1 );
+  va_start( arguments, format );
+  vsnprintf( buffer->text + buffer->length, length + 1, format, arguments );
+  va_end( arguments );
+  buffer->length += length;
+}
+
+/**
+ * Does the actual writing and deallocates the buffer
+ */
+static void writeNow( OutputBufferptr buffer )
+{
+  bool ok = fwrite( buffer->text, 1, buffer->length, buffer->stream )
+    == buffer->length;
+  if ( buffer->close_when_written )
+    ok = fclose( buffer->stream ) == 0 && ok;
+  else
+    ok = fflush( buffer->stream ) == 0 && ok;
+  if ( ! ok )
+    {
+      fprintf( stderr, "FATAL: unable to write %zu bytes of output\n",
+               buffer->length );
+      exit( EXIT_FAILURE );
+    }
+  free( buffer->text );
+  free( buffer );
+}
+
+/**
+ * Body of the output thread: writes queued buffers until the queue is
+ * empty and finishBackgroundOutput() has been called
+ */
+static void * outputLoop( void * unused )
+{
+  pthread_mutex_lock( & queue_lock );
+  for ( ; ; )
+    {
+      while ( queue_head == NULL && ! output_finished )
+        pthread_cond_wait( & queue_not_empty, & queue_lock );
+      if ( queue_head == NULL ) break;
+      OutputBufferptr buffer = queue_head;
+      queue_head = buffer->next;
+      if ( queue_head == NULL ) queue_tail = NULL;
+      pthread_mutex_unlock( & queue_lock );
+      writeNow( buffer );
+      pthread_mutex_lock( & queue_lock );
+    }
+  pthread_mutex_unlock( & queue_lock );
+  return NULL;
+}
+
+void writeOutputBuffer( OutputBufferptr buffer )
+{
+  pthread_mutex_lock( & queue_lock );
+  if ( ! background_output || output_finished )
+    {
+      pthread_mutex_unlock( & queue_lock );
+      writeNow( buffer );
+      return;
+    }
+  if ( queue_tail == NULL ) queue_head = buffer;
+  else queue_tail->next = buffer;
+  queue_tail = buffer;
+  pthread_cond_signal( & queue_not_empty );
+  pthread_mutex_unlock( & queue_lock );
+}
+
+void startBackgroundOutput( void )
+{
+  if ( background_output ) return;
+  output_finished = false;
+  if ( pthread_create( & output_thread, NULL, outputLoop, NULL ) != 0 )
+    {
+      // not fatal: output is simply written right away
+      fprintf( stderr, "Warning: unable to start output thread\n" );
+      return;
+    }
+  background_output = true;
+}
+
+void finishBackgroundOutput( void )
+{
+  if ( ! background_output ) return;
+  pthread_mutex_lock( & queue_lock );
+  output_finished = true;
+  pthread_cond_signal( & queue_not_empty );
+  pthread_mutex_unlock( & queue_lock );
+  pthread_join( output_thread, NULL );
+  pthread_mutex_lock( & queue_lock );
+  background_output = false;
+  pthread_mutex_unlock( & queue_lock );
+}
+
+/*  [Last modified: 2026 10 16 at 16:36:44 GMT] */
@@ -0,0 +1,75 @@
+/**
+ * @file output_buffer.h
+ * @brief Output files that are formatted in memory and written in one
+ * piece: the writers in dot.c, ord.c and sgf.c append to a buffer, which is
+ * then written with a single fwrite(), either right away or, if background
+ * output has been started, by a separate thread while the caller goes on.
+ * Only the writing is offloaded; the formatting is done by the caller.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+#ifndef OUTPUT_BUFFER_H
+#define OUTPUT_BUFFER_H
+
+#include<stdio.h>
+#include<stdbool.h>
+#include<stddef.h>
+
+typedef struct output_buffer_struct * OutputBufferptr;
+
+/**
+ * @return a new, empty buffer for the given stream
+ * @param close_when_written true if the stream is to be closed after the
+ * buffer has been written, e.g., if it was opened only for this purpose
+ */
+OutputBufferptr createOutputBuffer( FILE * stream, bool close_when_written );
+
+/**
+ * Appends text[0], ..., text[length - 1] to the buffer
+ */
+void appendText( OutputBufferptr buffer, const char * text, size_t length );
+
+/**
+ * Appends a '\0'-terminated string to the buffer
+ */
+void appendString( OutputBufferptr buffer, const char * string );
+
+void appendChar( OutputBufferptr buffer, char ch );
+
+/**
+ * Appends the decimal representation of the number
+ */
+void appendInt( OutputBufferptr buffer, int number );
+
+/**
+ * Appends text formatted as by printf(); meant for headers and comments,
+ * the functions above are faster for the bulk of a file
+ */
+void appendFormatted( OutputBufferptr buffer, const char * format, ... );
+
+/**
+ * Writes the contents of the buffer on its stream and deallocates the
+ * buffer; if background output has been started, the writing is done by
+ * the output thread and this function returns right away. A write error is
+ * fatal in either case.
+ */
+void writeOutputBuffer( OutputBufferptr buffer );
+
+/**
+ * Starts the output thread; from now on writeOutputBuffer() only queues
+ * buffers for it
+ */
+void startBackgroundOutput( void );
+
+/**
+ * Waits until all queued buffers have been written and stops the output
+ * thread; writeOutputBuffer() writes right away again afterwards. Does
+ * nothing if background output was not started.
+ */
+void finishBackgroundOutput( void );
+
+#endif
+
+/*  [Last modified: 2026 10 16 at 16:36:44 GMT] */
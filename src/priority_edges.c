@@ -20,50 +20,108 @@
 #include<assert.h>
 #include<string.h>
 
-static Edgeptr * priority_edge_list;
-static int number_of_priority_edges;
-static int priority_edge_list_capacity;
+/**
+ * The priority edges are CTX(priority_edge_list)[0], ...,
+ * CTX(priority_edge_list)[CTX(number_of_priority_edges) - 1]. They are also
+ * grouped by channel: those of channel i are
+ * edges_by_channel[channel_start[i]],...,edges_by_channel[channel_start[i+1]-1];
+ * channel_crossings[i] is their number of crossings as of the most recent
+ * update of channel i. The grouping is redone when the list changes, i.e.,
+ * when CTX(grouping_is_current) is false.
+ */
 
 void initPriorityEdges( void )
 {
-  priority_edge_list = (Edgeptr *) malloc( CAPACITY_INCREMENT * sizeof(Edgeptr) );
-  number_of_priority_edges = 0;
-  priority_edge_list_capacity = CAPACITY_INCREMENT;
+  CTX(priority_edge_list)
+    = (Edgeptr *) malloc( CAPACITY_INCREMENT * sizeof(Edgeptr) );
+  CTX(number_of_priority_edges) = 0;
+  CTX(priority_edge_list_capacity) = CAPACITY_INCREMENT;
+  CTX(grouping_is_current) = false;
 }
 
 void freePriorityEdges( void )
 {
-  free( priority_edge_list );
-  priority_edge_list = NULL;
-  number_of_priority_edges = 0;
+  free( CTX(priority_edge_list) );
+  CTX(priority_edge_list) = NULL;
+  CTX(number_of_priority_edges) = 0;
+  free( CTX(edges_by_channel) );
+  free( CTX(channel_start) );
+  free( CTX(channel_crossings) );
+  CTX(edges_by_channel) = NULL;
+  CTX(channel_start) = CTX(channel_crossings) = NULL;
+  CTX(grouping_is_current) = false;
 }
 
 void addToPriorityEdges( Edgeptr edge )
 {
-  if ( number_of_priority_edges >= priority_edge_list_capacity ) {
-    priority_edge_list_capacity += CAPACITY_INCREMENT;
-    priority_edge_list = realloc( priority_edge_list,
-                                  priority_edge_list_capacity * sizeof(Edgeptr) );
+  if ( CTX(number_of_priority_edges) >= CTX(priority_edge_list_capacity) ) {
+    CTX(priority_edge_list_capacity) += CAPACITY_INCREMENT;
+    CTX(priority_edge_list)
+      = realloc( CTX(priority_edge_list),
+                 CTX(priority_edge_list_capacity) * sizeof(Edgeptr) );
   }
-  priority_edge_list[ number_of_priority_edges++ ] = edge;
+  CTX(priority_edge_list)[ CTX(number_of_priority_edges)++ ] = edge;
+  CTX(grouping_is_current) = false;
 } 
 
 int numberOfFavoredEdges( void )
 {
-  return number_of_priority_edges;
+  return CTX(number_of_priority_edges);
 }
 
 const Edgeptr * favoredEdges( void )
 {
-  return priority_edge_list;
+  return CTX(priority_edge_list);
+}
+
+/**
+ * Distributes the priority edges among channels (a counting sort by the
+ * layer of the upper endpoint) and computes the crossings for each channel.
+ */
+static void group_by_channel( void )
+{
+  free( CTX(edges_by_channel) );
+  free( CTX(channel_start) );
+  free( CTX(channel_crossings) );
+  CTX(edges_by_channel)
+    = (Edgeptr *) malloc( (CTX(number_of_priority_edges) + 1)
+                          * sizeof(Edgeptr) );
+  CTX(channel_start) = (int *) calloc( CTX(number_of_layers) + 1, sizeof(int) );
+  CTX(channel_crossings) = (int *) calloc( CTX(number_of_layers), sizeof(int) );
+  for ( int i = 0; i < CTX(number_of_priority_edges); i++ )
+    CTX(channel_start)[ CTX(priority_edge_list)[i]->up_node->layer + 1 ]++;
+  for ( int channel = 1; channel <= CTX(number_of_layers); channel++ )
+    CTX(channel_start)[channel] += CTX(channel_start)[channel - 1];
+  int * next = (int *) malloc( CTX(number_of_layers) * sizeof(int) );
+  for ( int channel = 0; channel < CTX(number_of_layers); channel++ )
+    next[channel] = CTX(channel_start)[channel];
+  for ( int i = 0; i < CTX(number_of_priority_edges); i++ ) {
+    Edgeptr edge = CTX(priority_edge_list)[i];
+    CTX(edges_by_channel)[ next[ edge->up_node->layer ]++ ] = edge;
+  }
+  free( next );
+  CTX(grouping_is_current) = true;
+  for ( int channel = 1; channel < CTX(number_of_layers); channel++ )
+    updatePriorityEdgeCrossings( channel );
+}
+
+void updatePriorityEdgeCrossings( int channel )
+{
+  if ( ! CTX(grouping_is_current) ) return;
+  int crossings = 0;
+  for ( int i = CTX(channel_start)[channel];
+        i < CTX(channel_start)[channel + 1]; i++ )
+    crossings += CTX(edges_by_channel)[i]->crossings;
+  CTX(channel_crossings)[channel] = crossings;
 }
 
 int priorityEdgeCrossings( void )
 {
-  int total_crossings = 0;
-  for ( int i = 0; i < number_of_priority_edges; i++ )
-    total_crossings += priority_edge_list[ i ]->crossings;
-  return total_crossings;
+  if ( ! CTX(grouping_is_current) ) group_by_channel();
+  int crossings = 0;
+  for ( int channel = 1; channel < CTX(number_of_layers); channel++ )
+    crossings += CTX(channel_crossings)[channel];
+  return crossings;
 }
 
 /**
@@ -116,7 +174,7 @@ void createFavoredEdgeInfo(
                             )
 {
   createDotFileName( file_name_buffer, "favored_edges" );
-  strcpy( graph_name_buffer, graph_name );
+  strcpy( graph_name_buffer, CTX(graph_name) );
   strcat( graph_name_buffer, "_" );
   /**
    * @todo put more information into the graph name and/or comments; also,
@@ -129,4 +187,4 @@ void createFavoredEdgeInfo(
           "ancestors and descendants of a central node" );
 }
 
-/*  [Last modified: 2011 04 29 at 19:39:15 GMT] */
+/*  [Last modified: 2026 10 16 at 16:03:56 GMT] */
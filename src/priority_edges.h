@@ -38,10 +38,18 @@ int numberOfFavoredEdges( void );
 const Edgeptr * favoredEdges( void );
 
 /**
- * @return the number of crossings involving priority edges
+ * @return the number of crossings involving priority edges, as of the most
+ * recent update of each channel
  */
 int priorityEdgeCrossings( void );
 
+/**
+ * Brings the crossings of priority edges in the given channel (between
+ * layers channel - 1 and channel) up to date; called by the crossings
+ * module whenever the channel is recounted.
+ */
+void updatePriorityEdgeCrossings( int channel );
+
 /**
  * @brief Takes all the edges that are accessible via a path from the node
  * and adds them to the priority list.
@@ -61,4 +69,4 @@ void createFavoredEdgeInfo(
 
 #endif
 
-/*  [Last modified: 2011 04 27 at 20:44:09 GMT] */
+/*  [Last modified: 2026 10 16 at 15:06:47 GMT] */
@@ -0,0 +1,143 @@
+/**
+ * @file priority_queue.c
+ * @brief Implementation of an indexed max-heap with integer keys and
+ * secondary keys for breaking ties.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+#include"priority_queue.h"
+
+#include<stdlib.h>
+#include<assert.h>
+
+/**
+ * @return true if item_one should be closer to the root than item_two
+ */
+static bool precedes( PriorityQueueptr pq, int item_one, int item_two )
+{
+  if ( pq->key[item_one] != pq->key[item_two] )
+    return pq->key[item_one] > pq->key[item_two];
+  return pq->tie[item_one] > pq->tie[item_two];
+}
+
+static void place( PriorityQueueptr pq, int index, int item )
+{
+  pq->heap[index] = item;
+  pq->position[item] = index;
+}
+
+static void sift_up( PriorityQueueptr pq, int index )
+{
+  int item = pq->heap[index];
+  while ( index > 0 ) {
+    int parent = ( index - 1 ) / 2;
+    if ( ! precedes( pq, item, pq->heap[parent] ) ) break;
+    place( pq, index, pq->heap[parent] );
+    index = parent;
+  }
+  place( pq, index, item );
+}
+
+static void sift_down( PriorityQueueptr pq, int index )
+{
+  int item = pq->heap[index];
+  while ( true ) {
+    int child = 2 * index + 1;
+    if ( child >= pq->size ) break;
+    if ( child + 1 < pq->size
+         && precedes( pq, pq->heap[child + 1], pq->heap[child] ) )
+      child++;
+    if ( ! precedes( pq, pq->heap[child], item ) ) break;
+    place( pq, index, pq->heap[child] );
+    index = child;
+  }
+  place( pq, index, item );
+}
+
+PriorityQueueptr pq_create( int capacity )
+{
+  PriorityQueueptr pq
+    = (PriorityQueueptr) malloc( sizeof(struct priority_queue_struct) );
+  pq->capacity = capacity;
+  pq->size = 0;
+  pq->heap = (int *) malloc( capacity * sizeof(int) );
+  pq->position = (int *) malloc( capacity * sizeof(int) );
+  pq->key = (int *) calloc( capacity, sizeof(int) );
+  pq->tie = (unsigned long *) calloc( capacity, sizeof(unsigned long) );
+  for ( int item = 0; item < capacity; item++ )
+    pq->position[item] = -1;
+  return pq;
+}
+
+void pq_free( PriorityQueueptr pq )
+{
+  free( pq->heap );
+  free( pq->position );
+  free( pq->key );
+  free( pq->tie );
+  free( pq );
+}
+
+void pq_clear( PriorityQueueptr pq )
+{
+  for ( int index = 0; index < pq->size; index++ )
+    pq->position[ pq->heap[index] ] = -1;
+  pq->size = 0;
+}
+
+void pq_append( PriorityQueueptr pq, int item, int key, unsigned long tie )
+{
+  assert( item >= 0 && item < pq->capacity );
+  assert( pq->position[item] == -1 );
+  pq->key[item] = key;
+  pq->tie[item] = tie;
+  place( pq, pq->size++, item );
+}
+
+void pq_heapify( PriorityQueueptr pq )
+{
+  for ( int index = pq->size / 2 - 1; index >= 0; index-- )
+    sift_down( pq, index );
+}
+
+void pq_update( PriorityQueueptr pq, int item, int key )
+{
+  int old_key = pq->key[item];
+  pq->key[item] = key;
+  int index = pq->position[item];
+  if ( index < 0 || key == old_key ) return;
+  if ( key > old_key )
+    sift_up( pq, index );
+  else
+    sift_down( pq, index );
+}
+
+void pq_remove( PriorityQueueptr pq, int item )
+{
+  int index = pq->position[item];
+  if ( index < 0 ) return;
+  pq->position[item] = -1;
+  pq->size--;
+  if ( index == pq->size ) return;
+  int last = pq->heap[ pq->size ];
+  place( pq, index, last );
+  if ( index > 0 && precedes( pq, last, pq->heap[ (index - 1) / 2 ] ) )
+    sift_up( pq, index );
+  else
+    sift_down( pq, index );
+}
+
+int pq_max( PriorityQueueptr pq )
+{
+  if ( pq->size == 0 ) return -1;
+  return pq->heap[0];
+}
+
+bool pq_contains( PriorityQueueptr pq, int item )
+{
+  return pq->position[item] >= 0;
+}
+
+/*  [Last modified: 2026 10 16 at 15:03:46 GMT] */
@@ -0,0 +1,83 @@
+/**
+ * @file priority_queue.h
+ * @brief Definition of an indexed max-heap whose items are the integers
+ * 0,...,capacity-1 (typically node or edge id's). Each item has a primary
+ * key and a secondary key that breaks ties; the key of an item can be
+ * changed in O(log n) time whether or not the item is currently in the
+ * heap.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+#include<stdbool.h>
+
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H
+
+typedef struct priority_queue_struct {
+  int capacity;
+  int size;
+  /**
+   * heap[0] is the item with the largest key; heap[i] has children
+   * heap[2i+1] and heap[2i+2]
+   */
+  int * heap;
+  /**
+   * position[item] is the index of the item in heap, or -1 if the item is
+   * not in the heap
+   */
+  int * position;
+  int * key;
+  /**
+   * secondary keys: the larger one wins when primary keys are equal
+   */
+  unsigned long * tie;
+} * PriorityQueueptr;
+
+/**
+ * @return a new, empty priority queue for items 0,...,capacity-1
+ */
+PriorityQueueptr pq_create( int capacity );
+
+void pq_free( PriorityQueueptr pq );
+
+/**
+ * Removes all items from the queue; their keys are retained.
+ */
+void pq_clear( PriorityQueueptr pq );
+
+/**
+ * Adds item to the queue without restoring the heap property; the item must
+ * not already be in the queue. A call to pq_heapify() is required before
+ * any other operation.
+ */
+void pq_append( PriorityQueueptr pq, int item, int key, unsigned long tie );
+
+/**
+ * Restores the heap property in linear time after a sequence of
+ * pq_append() calls.
+ */
+void pq_heapify( PriorityQueueptr pq );
+
+/**
+ * Changes the primary key of item. If the item is in the queue, its
+ * position is adjusted accordingly.
+ */
+void pq_update( PriorityQueueptr pq, int item, int key );
+
+/**
+ * Removes item from the queue if it is there.
+ */
+void pq_remove( PriorityQueueptr pq, int item );
+
+/**
+ * @return the item with the largest key, or -1 if the queue is empty
+ */
+int pq_max( PriorityQueueptr pq );
+
+bool pq_contains( PriorityQueueptr pq, int item );
+
+#endif
+
+/*  [Last modified: 2026 10 16 at 15:03:46 GMT] */
@@ -45,8 +45,9 @@
 #define LOWER_MASK 0x7fffffffUL /* least significant r bits */
 
 
-static unsigned long mt[N]; /* the array for the state vector  */
-static int mti=N+1; /* mti==N+1 means mt[N] is not initialized */
+/* each thread has its own generator */
+static __thread unsigned long mt[N]; /* the array for the state vector  */
+static __thread int mti=N+1; /* mti==N+1 means mt[N] is not initialized */
 
 
 /* initializes mt[N] with a seed */
@@ -224,4 +225,4 @@ int * genrand_permutation( void * A, int length, int element_size ) {
   return retval;
 }
 
-/*  [Last modified: 2014 09 09 at 16:31:29 GMT] */
+/*  [Last modified: 2026 10 16 at 16:03:56 GMT] */
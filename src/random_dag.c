@@ -30,23 +30,24 @@ static void add_edge( Nodeptr upper_node, Nodeptr lower_node )
 {
 #ifdef DEBUG
   printf( "-> add_edge: upper_node = (%s,%d,%d), lower_node = (%s,%d,%d)\n",
-          upper_node->name, upper_node->layer, upper_node->position,
-          lower_node->name, lower_node->layer, lower_node->position );
+          NODE_NAME( upper_node ), upper_node->layer, upper_node->position,
+          NODE_NAME( lower_node ), lower_node->layer, lower_node->position );
 #endif
   assert( upper_node->layer == lower_node->layer + 1 );
   Edgeptr new_edge = (Edgeptr) calloc( 1, sizeof(struct edge_struct) );
   new_edge->up_node = upper_node;
   new_edge->down_node = lower_node;
-  new_edge->fixed = false;
+  new_edge->id = CTX(number_of_edges);
 
   // add new edge to master edge list, making room if necessary
-  if ( number_of_edges % CAPACITY_INCREMENT == 0 )
+  if ( CTX(number_of_edges) % CAPACITY_INCREMENT == 0 )
     {
-      master_edge_list
-        = (Edgeptr *) realloc( master_edge_list,
-                               (number_of_edges + CAPACITY_INCREMENT) * sizeof(Edgeptr) );
+      CTX(master_edge_list)
+        = (Edgeptr *) realloc( CTX(master_edge_list),
+                               (CTX(number_of_edges) + CAPACITY_INCREMENT)
+                               * sizeof(Edgeptr) );
     }
-  master_edge_list[ number_of_edges++ ] = new_edge;
+  CTX(master_edge_list)[ CTX(number_of_edges)++ ] = new_edge;
 
   // add new edge to lower edge list of upper node, making room if necessary
   if ( upper_node->down_degree % CAPACITY_INCREMENT == 0 )
@@ -67,7 +68,7 @@ static void add_edge( Nodeptr upper_node, Nodeptr lower_node )
 
 #ifdef DEBUG
   printf( "<- add_edge: edge = %s -> %s\n",
-          new_edge->up_node->name, new_edge->down_node->name );
+          NODE_NAME( new_edge->up_node ), NODE_NAME( new_edge->down_node ) );
 #endif
 }
 
@@ -78,9 +79,9 @@ static void add_edge( Nodeptr upper_node, Nodeptr lower_node )
  */
 static void make_all_current_edges_exist( void )
 {
-  for ( int i = 0; i < number_of_edges; i++ )
+  for ( int i = 0; i < CTX(number_of_edges); i++ )
     {
-      Edgeptr edge = master_edge_list[i];
+      Edgeptr edge = CTX(master_edge_list)[i];
       int up_node_id = edge->up_node->id;
       int down_node_id = edge->down_node->id;
       pair_already_exists( up_node_id, down_node_id );
@@ -95,7 +96,8 @@ void create_random_dag( int num_nodes,
 #ifdef DEBUG
   printf( "-> create_random_dag: nodes = %d, edges = %d, layers = %d, branching = %d\n"
           "  number_of_nodes = %d, number_of_edges = %d\n",
-          num_nodes, desired_num_edges, num_layers, branching_factor, number_of_nodes, number_of_edges );
+          num_nodes, desired_num_edges, num_layers, branching_factor,
+          CTX(number_of_nodes), CTX(number_of_edges) );
 #endif
 
   assert( num_nodes > 0
@@ -106,34 +108,34 @@ void create_random_dag( int num_nodes,
   create_random_tree( num_nodes, num_layers, branching_factor );
 #ifdef DEBUG
   printf( " After create_random_tree: number_of_nodes = %d, number_of_edges = %d, desired = %d\n",
-          number_of_nodes, number_of_edges, desired_num_edges );
+          CTX(number_of_nodes), CTX(number_of_edges), desired_num_edges );
 #endif
 
   create_hash_table_for_pairs( desired_num_edges );
 
   make_all_current_edges_exist();
 
-  while ( desired_num_edges > number_of_edges )
+  while ( desired_num_edges > CTX(number_of_edges) )
     {
       // pick two random nodes that are on adjacent layers
       // if there's not already an edge between them, add one
 
       // pick a node that's not on layer 0
-      int first_node_index = random() % number_of_nodes;
-      Nodeptr first_node = master_node_list[ first_node_index ];
+      int first_node_index = random() % CTX(number_of_nodes);
+      Nodeptr first_node = CTX(master_node_list)[ first_node_index ];
       int first_node_layer_number = first_node->layer;
 #ifdef DEBUG
       printf( " Loop iteration: number_of_edges = %d, desired = %d\n"
               "   first_node = %d [%d]\n",
-              number_of_edges, desired_num_edges,
+              CTX(number_of_edges), desired_num_edges,
               first_node_index, first_node_layer_number );
 #endif
       if ( first_node_layer_number == 0 ) continue;
 
       // pick another node on the layer below that of the first node
       int second_node_layer_number = first_node_layer_number - 1;
-      Layerptr second_node_layer = layers[ second_node_layer_number ];
-      int second_node_layer_position = random() % second_node_layer->number_of_nodes;
+      Layerptr second_node_layer = CTX(layers)[ second_node_layer_number ];
+      int second_node_layer_position = random() % second_node_layer->node_count;
       Nodeptr second_node = second_node_layer->nodes[ second_node_layer_position ];
       int second_node_index = second_node->id;
 
@@ -152,4 +154,4 @@ void create_random_dag( int num_nodes,
   destroy_hash_table_for_pairs();
 }
 
-/*  [Last modified: 2011 07 07 at 16:12:28 GMT] */
+/*  [Last modified: 2026 10 16 at 16:03:56 GMT] */
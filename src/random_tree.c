@@ -60,15 +60,14 @@ static Nodeptr create_node( int node_number )
   // give the node a name based on its position in the master list
   char name_buffer[ MAX_NAME_LENGTH ];
   sprintf( name_buffer, "n_%d", node_number );
-  new_node->name = (char *) malloc( strlen(name_buffer) + 1 );
-  strcpy( new_node->name, name_buffer );
+  CTX(node_names)[ node_number ] = (char *) malloc( strlen(name_buffer) + 1 );
+  strcpy( CTX(node_names)[ node_number ], name_buffer );
 
   new_node->layer = new_node->position = -1; /* to indicate "uninitialized" */
   new_node->up_degree = new_node->down_degree = 0;
   new_node->up_edges = new_node->down_edges = NULL;
   new_node->up_crossings = new_node->down_crossings = 0;
-  new_node->marked = new_node->fixed = false;
-  new_node->preorder_number = -1;
+  new_node->fixed = false;
   return new_node;
 }
 
@@ -77,60 +76,61 @@ static Nodeptr create_node( int node_number )
  */
 static void create_master_node_list( int num_nodes )
 {
-  master_node_list = (Nodeptr *) calloc( num_nodes, sizeof( Nodeptr ) );
+  CTX(master_node_list) = (Nodeptr *) calloc( num_nodes, sizeof( Nodeptr ) );
+  CTX(node_names) = (char **) calloc( num_nodes, sizeof( char * ) );
   for ( int i = 0; i < num_nodes; i++ )
     {
-      master_node_list[i] = create_node( i );
+      CTX(master_node_list)[i] = create_node( i );
     }
 }
 
 static void init_layers( int num_layers )
 {
-  layers = (Layerptr *) calloc( num_layers, sizeof( Layerptr ) );
+  CTX(layers) = (Layerptr *) calloc( num_layers, sizeof( Layerptr ) );
   for ( int i = 0; i < num_layers; i++ )
     {
-      layers[i] = calloc( 1, sizeof( struct layer_struct ) );
-      layers[i]->number_of_nodes = 0;
-      layers[i]->nodes = NULL;
-      layers[i]->fixed = false;
+      CTX(layers)[i] = calloc( 1, sizeof( struct layer_struct ) );
+      CTX(layers)[i]->node_count = 0;
+      CTX(layers)[i]->nodes = NULL;
+      CTX(layers)[i]->fixed = false;
     }
 }
 
 static void add_node_to_list( Nodeptr node )
 {
-  master_node_list[ number_of_tree_nodes++ ] = node;
+  CTX(master_node_list)[ number_of_tree_nodes++ ] = node;
 }
 
 static void add_node_to_layer( Nodeptr node, int layer )
 {
 #ifdef DEBUG
-  printf( "-> add_node_to_layer: node = %s, layer = %d\n", node->name, layer );
+  printf( "-> add_node_to_layer: node = %s, layer = %d\n", NODE_NAME( node ), layer );
 #endif
-  Layerptr layer_ptr = layers[layer];
+  Layerptr layer_ptr = CTX(layers)[layer];
 
   // First node on this layer means fewer layers remain
-  if ( layer_ptr->number_of_nodes == 0 )
+  if ( layer_ptr->node_count == 0 )
     layers_remaining--;
 
-  if ( layer_ptr->number_of_nodes % CAPACITY_INCREMENT == 0 )
+  if ( layer_ptr->node_count % CAPACITY_INCREMENT == 0 )
     {
       layer_ptr->nodes
         = (Nodeptr *) realloc( layer_ptr->nodes,
-                               (layer_ptr->number_of_nodes + CAPACITY_INCREMENT) * sizeof(Nodeptr) );
+                               (layer_ptr->node_count + CAPACITY_INCREMENT) * sizeof(Nodeptr) );
     }
   node->layer = layer;
-  node->position = layer_ptr->number_of_nodes;
-  layer_ptr->nodes[ layer_ptr->number_of_nodes++ ] = node;
+  node->position = layer_ptr->node_count;
+  layer_ptr->nodes[ layer_ptr->node_count++ ] = node;
 #ifdef DEBUG
   printf( "<- add_node_to_layer: position = %d, number_of_nodes = %d\n",
-          node->position, layer_ptr->number_of_nodes );
+          node->position, layer_ptr->node_count );
 #endif
 }
 
 static void assign_child_layer_and_direction( int parent, int child )
 {
-  Nodeptr parent_node = master_node_list[ parent ];
-  Nodeptr child_node =  master_node_list[ child ];
+  Nodeptr parent_node = CTX(master_node_list)[ parent ];
+  Nodeptr child_node =  CTX(master_node_list)[ child ];
   int parent_layer = parent_node->layer;
 #ifdef DEBUG
   printf( "-> assign_child_layer_and_direction: parent = %d, child = %d\n"
@@ -140,7 +140,7 @@ static void assign_child_layer_and_direction( int parent, int child )
 
   going_up[child] = going_up[parent];
   // handle cases where the path needs to turn around
-  if ( going_up[parent] && parent_layer == number_of_layers - 1 )
+  if ( going_up[parent] && parent_layer == CTX(number_of_layers) - 1 )
     going_up[child] = false;
   else if ( ! going_up[parent] && parent_layer == 0 )
     going_up[child] = true;
@@ -164,23 +164,23 @@ static void add_edge( Nodeptr upper_node, Nodeptr lower_node )
 {
 #ifdef DEBUG
   printf( "-> add_edge: upper_node = (%s,%d,%d), lower_node = (%s,%d,%d)\n",
-          upper_node->name, upper_node->layer, upper_node->position,
-          lower_node->name, lower_node->layer, lower_node->position );
+          NODE_NAME( upper_node ), upper_node->layer, upper_node->position,
+          NODE_NAME( lower_node ), lower_node->layer, lower_node->position );
 #endif
   assert( upper_node->layer == lower_node->layer + 1 );
   Edgeptr new_edge = (Edgeptr) calloc( 1, sizeof(struct edge_struct) );
   new_edge->up_node = upper_node;
   new_edge->down_node = lower_node;
-  new_edge->fixed = false;
 
   // add new edge to master edge list, making room if necessary
-  if ( number_of_edges % CAPACITY_INCREMENT == 0 )
+  if ( CTX(number_of_edges) % CAPACITY_INCREMENT == 0 )
     {
-      master_edge_list
-        = (Edgeptr *) realloc( master_edge_list,
-                               (number_of_edges + CAPACITY_INCREMENT) * sizeof(Edgeptr) );
+      CTX(master_edge_list)
+        = (Edgeptr *) realloc( CTX(master_edge_list),
+                               (CTX(number_of_edges) + CAPACITY_INCREMENT)
+                               * sizeof(Edgeptr) );
     }
-  master_edge_list[ number_of_edges++ ] = new_edge;
+  CTX(master_edge_list)[ CTX(number_of_edges)++ ] = new_edge;
 
   // add new edge to lower edge list of upper node, making room if necessary
   if ( upper_node->down_degree % CAPACITY_INCREMENT == 0 )
@@ -201,7 +201,7 @@ static void add_edge( Nodeptr upper_node, Nodeptr lower_node )
 
 #ifdef DEBUG
   printf( "<- add_edge: edge = %s -> %s\n",
-          new_edge->up_node->name, new_edge->down_node->name );
+          NODE_NAME( new_edge->up_node ), NODE_NAME( new_edge->down_node ) );
 #endif
 }
 
@@ -213,19 +213,19 @@ void create_random_tree( int num_nodes,
           && num_layers > 1
           && branching_factor > 0 );
 
-  number_of_nodes = num_nodes;
+  CTX(number_of_nodes) = num_nodes;
   create_master_node_list( num_nodes );
-  number_of_layers = num_layers;
+  CTX(number_of_layers) = num_layers;
   layers_remaining = num_layers;
-  number_of_edges = 0;
-  master_edge_list = NULL;
+  CTX(number_of_edges) = 0;
+  CTX(master_edge_list) = NULL;
 
   init_layers( num_layers );
   init_node_directions( num_nodes );
 
   // create node 0, put it on layer 0, and make it the current node
   int current_node_id = 0;
-  Nodeptr current_node = master_node_list[ current_node_id ];
+  Nodeptr current_node = CTX(master_node_list)[ current_node_id ];
   add_node_to_layer( current_node, 0 );
   add_node_to_list( current_node );
 
@@ -234,13 +234,13 @@ void create_random_tree( int num_nodes,
   // - choose a degree d in the range [1 .. branching_factor]
   // - put d new nodes at the rear of the list, assign them to the
   // appropriate layer and add the appropriate edges
-  while( number_of_tree_nodes < number_of_nodes )
+  while( number_of_tree_nodes < CTX(number_of_nodes) )
     {
       // Need to make sure that there are enough nodes left to ensure that
       // every layer has nodes: layers_remaining may be 1 even if so; this
       // ensures that the number of children does not exceed the number of
       // nodes remaining
-      int nodes_remaining = number_of_nodes - number_of_tree_nodes;
+      int nodes_remaining = CTX(number_of_nodes) - number_of_tree_nodes;
       int path_length_to_highest_layer = num_layers - 1 - current_node->layer;
       int branch_limit = branching_factor;
       // need to leave enough nodes for next node to have access to the top
@@ -253,7 +253,7 @@ void create_random_tree( int num_nodes,
       if ( branch_limit > nodes_remaining )
         branch_limit = nodes_remaining;
       // finally, smooth out the number of nodes in each layer
-      if ( layers[current_node->layer]->number_of_nodes
+      if ( CTX(layers)[current_node->layer]->node_count
            > num_nodes / num_layers )
         branch_limit = 1;
 
@@ -282,7 +282,7 @@ void create_random_tree( int num_nodes,
       for ( int i = 0; i < out_degree; i++ )
         {
           int child_node_id = number_of_tree_nodes;
-          Nodeptr child_node = master_node_list[ child_node_id ];
+          Nodeptr child_node = CTX(master_node_list)[ child_node_id ];
           add_node_to_list( child_node );
 
           assign_child_layer_and_direction( current_node_id, child_node_id );
@@ -294,21 +294,22 @@ void create_random_tree( int num_nodes,
         }
 
       current_node_id++;
-      current_node = master_node_list[ current_node_id ];
+      current_node = CTX(master_node_list)[ current_node_id ];
 
 #ifdef OMITTED
       printf( " __ iteration %d: master_node_list, number_of_nodes = %d\n", current_node_id, number_of_tree_nodes );
       for ( int i = 0; i < number_of_tree_nodes; i++ )
         printf( " %d(%d,%d)",
-                master_node_list[i]->id,
-                master_node_list[i]->layer,
-                master_node_list[i]->position );
+                CTX(master_node_list)[i]->id,
+                CTX(master_node_list)[i]->layer,
+                CTX(master_node_list)[i]->position );
       printf( "\n" );
-      printf( " master_edge_list, number_of_edges = %d\n", number_of_edges );
-      for ( int i = 0; i < number_of_edges; i++ )
+      printf( " master_edge_list, number_of_edges = %d\n",
+              CTX(number_of_edges) );
+      for ( int i = 0; i < CTX(number_of_edges); i++ )
         printf( " %d->%d",
-                master_edge_list[i]->up_node->id,
-                master_edge_list[i]->down_node->id
+                CTX(master_edge_list)[i]->up_node->id,
+                CTX(master_edge_list)[i]->down_node->id
                 );
       printf( "\n" );
 #endif      
@@ -333,8 +334,8 @@ int main( int argc, char * argv[] )
   writeDot( "test.dot",
             "test_graph",
              "",
-             master_edge_list,
-             number_of_edges
+             CTX(master_edge_list),
+             CTX(number_of_edges)
             );
 
   writeOrd( "test.ord" );
@@ -343,4 +344,4 @@ int main( int argc, char * argv[] )
 }
 #endif
 
-/*  [Last modified: 2011 06 03 at 19:01:11 GMT] */
+/*  [Last modified: 2026 10 16 at 16:03:56 GMT] */
@@ -0,0 +1,231 @@
+/**
+ * @file sgf.c
+ * @brief Module for reading and writing files in .sgf format - see sgf.h
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+#include<stdlib.h>
+#include<stdio.h>
+#include<string.h>
+#include<ctype.h>
+
+#include"sgf.h"
+
+/* -----------  UTILITY FUNCTIONS -------------- */
+
+static bool is_blank( char ch )
+{
+  return ch == ' ' || ch == '\t' || ch == '\r';
+}
+
+/**
+ * Skips blank lines and comment lines
+ * @return the first character of the next line that has a node, an edge or
+ * a title, or EOF; the input is positioned at that character
+ */
+static int skip_to_item( MappedInputptr in )
+{
+  const char * position = in->position;
+  const char * end = in->end;
+  while ( position < end )
+    {
+      if ( * position == '\n' )
+        {
+          in->line_number++;
+          position++;
+        }
+      else if ( is_blank( * position ) )
+        position++;
+      else if ( * position == 'c'
+                && ( position + 1 == end
+                     || isspace( (unsigned char) position[1] ) ) )
+        {
+          // comment; the newline that ends it is counted above
+          while ( position < end && * position != '\n' ) position++;
+        }
+      else
+        break;
+    }
+  in->position = position;
+  return ( position < end ) ? (unsigned char) * position : EOF;
+}
+
+/**
+ * @return the next sequence of non-blank characters on the current line;
+ * its length is 0 if there are none
+ */
+static NameSlice next_token( MappedInputptr in )
+{
+  const char * position = in->position;
+  while ( position < in->end && is_blank( * position ) ) position++;
+  const char * start = position;
+  while ( position < in->end && ! isspace( (unsigned char) * position ) )
+    position++;
+  in->position = position;
+  NameSlice token = { start, (int) ( position - start ) };
+  return token;
+}
+
+/**
+ * Reads the next token on the current line as an integer
+ * @return false if there is no token; a fatal error occurs if the token is
+ * not an integer
+ */
+static bool next_integer( MappedInputptr in, const char * what, int * value )
+{
+  NameSlice token = next_token( in );
+  if ( token.length == 0 ) return false;
+  const char * digit = token.start;
+  const char * end = token.start + token.length;
+  bool negative = ( * digit == '-' );
+  if ( negative || * digit == '+' ) digit++;
+  if ( digit == end )
+    {
+      inputError( in, "%s expected, got '%.*s'",
+                  what, token.length, token.start );
+      exit( EXIT_FAILURE );
+    }
+  int number = 0;
+  for ( ; digit < end; digit++ )
+    {
+      if ( ! isdigit( (unsigned char) * digit ) )
+        {
+          inputError( in, "%s expected, got '%.*s'",
+                      what, token.length, token.start );
+          exit( EXIT_FAILURE );
+        }
+      number = 10 * number + ( * digit - '0' );
+    }
+  * value = negative ? - number : number;
+  return true;
+}
+
+/**
+ * @return the next token on the current line; a fatal error occurs if
+ * there is none
+ */
+static NameSlice required_token( MappedInputptr in, const char * what )
+{
+  NameSlice token = next_token( in );
+  if ( token.length == 0 )
+    {
+      inputError( in, "%s expected", what );
+      exit( EXIT_FAILURE );
+    }
+  return token;
+}
+
+static void required_integer( MappedInputptr in, const char * what,
+                              int * value )
+{
+  if ( ! next_integer( in, what, value ) )
+    {
+      inputError( in, "%s expected", what );
+      exit( EXIT_FAILURE );
+    }
+}
+
+/**
+ * Skips whatever is left on the current line, up to the newline
+ */
+static void skip_rest_of_line( MappedInputptr in )
+{
+  const char * position = in->position;
+  while ( position < in->end && * position != '\n' ) position++;
+  in->position = position;
+}
+
+static bool is_line_type( NameSlice token, char type )
+{
+  return token.length == 1 && * token.start == type;
+}
+
+/* -----------  INPUT FUNCTIONS -------------- */
+
+void readSgfTitle( MappedInputptr in, NameSlice * name,
+                   int * node_count, int * edge_count, int * layer_count )
+{
+  skip_to_item( in );
+  NameSlice type = next_token( in );
+  if ( ! is_line_type( type, 't' ) )
+    {
+      inputError( in, "expected title line 't graph_name ...', got '%.*s'",
+                  type.length, type.start );
+      exit( EXIT_FAILURE );
+    }
+  * name = required_token( in, "graph name" );
+  * node_count = * edge_count = * layer_count = -1;
+  if ( next_integer( in, "number of nodes", node_count )
+       && next_integer( in, "number of edges", edge_count ) )
+    next_integer( in, "number of layers", layer_count );
+  skip_rest_of_line( in );
+}
+
+bool nextSgfItem( MappedInputptr in, SgfItem * item )
+{
+  if ( skip_to_item( in ) == EOF ) return false;
+  NameSlice type = next_token( in );
+  if ( is_line_type( type, 'n' ) )
+    {
+      item->type = 'n';
+      item->node = required_token( in, "node id" );
+      required_integer( in, "layer", & item->layer );
+      required_integer( in, "position", & item->position );
+    }
+  else if ( is_line_type( type, 'e' ) )
+    {
+      item->type = 'e';
+      item->source = required_token( in, "source id" );
+      item->target = required_token( in, "target id" );
+    }
+  else
+    {
+      inputError( in, "expected a node ('n') or an edge ('e'), got '%.*s'",
+                  type.length, type.start );
+      exit( EXIT_FAILURE );
+    }
+  skip_rest_of_line( in );
+  return true;
+}
+
+/* -----------  OUTPUT FUNCTIONS -------------- */
+
+void outputSgfComment( OutputBufferptr out, const char * comment )
+{
+  appendString( out, "c " );
+  appendString( out, comment );
+  appendChar( out, '\n' );
+}
+
+void outputSgfTitle( OutputBufferptr out, const char * name_of_graph,
+                     int node_count, int edge_count, int layer_count )
+{
+  appendFormatted( out, "t %s %d %d %d\n",
+                   name_of_graph, node_count, edge_count, layer_count );
+}
+
+void outputSgfNode( OutputBufferptr out, const char * node,
+                    int layer, int position )
+{
+  appendString( out, "n " );
+  appendString( out, node );
+  appendChar( out, ' ' );
+  appendInt( out, layer );
+  appendChar( out, ' ' );
+  appendInt( out, position );
+  appendChar( out, '\n' );
+}
+
+void outputSgfEdge( OutputBufferptr out, const char * source,
+                    const char * target )
+{
+  appendString( out, "e " );
+  appendString( out, source );
+  appendChar( out, ' ' );
+  appendString( out, target );
+  appendChar( out, '\n' );
+}
+
+/*  [Last modified: 2026 10 16 at 16:36:44 GMT] */
@@ -0,0 +1,111 @@
+/**
+ * @file sgf.h
+ * @brief Module for reading and writing files in .sgf format, which
+ * describes a layered graph, including the order of the nodes on each layer,
+ * in a single file.
+ *
+ * sgf format is as follows (blank lines are ignored):
+ *    c comment line 1
+ *    ...
+ *    c comment line k
+ *
+ *    t graph_name nodes edges layers
+ *
+ *    n id_1 layer_1 position_1
+ *    ...
+ *    n id_n layer_n position_n
+ *
+ *    e source_1 target_1
+ *    ...
+ *    e source_m target_m
+ *
+ * The node id's are names, usually numbers. The counts on the 't' line are
+ * optional. Comment lines may appear anywhere and anything after the target
+ * of an edge is ignored. The 'n' line of a node must come before any edge
+ * that is incident on it.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+#ifndef SGF_H
+#define SGF_H
+
+#include<stdio.h>
+#include<stdbool.h>
+#include"mapped_input.h"
+#include"output_buffer.h"
+
+/* -----------  INPUT FUNCTIONS -------------- */
+
+/**
+ * A node or an edge read from an sgf file; the names are slices of the
+ * input, valid until it is closed
+ */
+typedef struct sgf_item {
+  /** 'n' for a node, 'e' for an edge */
+  char type;
+  /** node id and its layer and position, if type is 'n' */
+  NameSlice node;
+  int layer;
+  int position;
+  /** endpoints, if type is 'e' */
+  NameSlice source;
+  NameSlice target;
+} SgfItem;
+
+/**
+ * Reads the title line, skipping any comments before it; a missing count is
+ * reported as -1. A fatal error occurs if there is no title line.
+ */
+void readSgfTitle( MappedInputptr in, NameSlice * name,
+                   int * node_count, int * edge_count, int * layer_count );
+
+/**
+ * Reads the next node or edge, skipping comments and blank lines
+ * @return true if there was another node or edge
+ */
+bool nextSgfItem( MappedInputptr in, SgfItem * item );
+
+// The typical way to read an sgf file with name 'file_name' is ...
+//
+//     MappedInputptr in = openMappedInput( file_name );
+//     NameSlice name;
+//     int node_count, edge_count, layer_count;
+//     readSgfTitle( in, & name, & node_count, & edge_count, & layer_count );
+//     SgfItem item;
+//     while ( nextSgfItem( in, & item ) )
+//       {
+//         if ( item.type == 'n' ) // do something with the node
+//         else                    // do something with the edge
+//       }
+//     closeMappedInput( in );
+
+/* -----------  OUTPUT FUNCTIONS -------------- */
+
+/**
+ * Writes a comment line
+ */
+void outputSgfComment( OutputBufferptr out, const char * comment );
+
+/**
+ * Writes the title line
+ */
+void outputSgfTitle( OutputBufferptr out, const char * name_of_graph,
+                     int node_count, int edge_count, int layer_count );
+
+/**
+ * Writes a node line
+ */
+void outputSgfNode( OutputBufferptr out, const char * node,
+                    int layer, int position );
+
+/**
+ * Writes an edge line
+ */
+void outputSgfEdge( OutputBufferptr out, const char * source,
+                    const char * target );
+
+#endif
+
+/*  [Last modified: 2026 10 16 at 16:36:44 GMT] */
@@ -10,6 +10,7 @@
  */
 
 #include"graph.h"
+#include"graph_core.h"
 #include"defs.h"
 #include"crossings.h"
 #include"crossing_utilities.h"
@@ -17,6 +18,9 @@
 #include"swap.h"
 #include"sorting.h"
 #include"channel.h"
+#include"order.h"
+#include"min_crossings.h"
+#include"stretch.h"
 
 #include<stdio.h>
 #include<stdlib.h>
@@ -35,6 +39,81 @@
 static void reposition_node( Nodeptr node, Nodeptr * nodes,
                              int after_position );
 
+/**
+ * @return cr(left_node, right_node) - cr(right_node, left_node), where cr is
+ * as defined for sift() below; without the cache each channel is merged
+ * once rather than twice, as in a difference of two calls to
+ * node_crossings()
+ */
+static int pair_difference( Nodeptr left_node, Nodeptr right_node )
+{
+  if ( OPTION(cache_pair_crossings) )
+    return pairCrossings( left_node, right_node )
+      - pairCrossings( right_node, left_node );
+  int layer = left_node->layer;
+  int difference = 0;
+  int reverse = 0;
+  if ( layer > 0 )
+    {
+      difference += pair_crossings( left_node, right_node, true, &reverse );
+      difference -= reverse;
+    }
+  if ( layer < CTX(number_of_layers) - 1 )
+    {
+      difference += pair_crossings( left_node, right_node, false, &reverse );
+      difference -= reverse;
+    }
+  return difference;
+}
+
+/**
+ * Moves the node as reposition_node() does and adjusts crossings of edges,
+ * nodes, and channels for the nodes it passes over, instead of recounting
+ * the channels incident on its layer; see sift_update in context.h
+ */
+static void reposition_and_adjust( Nodeptr node, Nodeptr * nodes,
+                                   int after_position )
+{
+  int layer = node->layer;
+  int old_position = node->position;
+  int first_passed = old_position + 1;
+  int last_passed = after_position;
+  bool moving_left = after_position < old_position - 1;
+  if ( moving_left )
+    {
+      first_passed = after_position + 1;
+      last_passed = old_position - 1;
+    }
+  int down_change = 0;
+  int up_change = 0;
+  for ( int i = first_passed; i <= last_passed; i++ )
+    {
+      Nodeptr before = moving_left ? nodes[i] : node;
+      Nodeptr after = moving_left ? node : nodes[i];
+      // 'before' is to the left of 'after' now, the reverse after the move
+      if ( layer > 0 )
+        {
+          down_change -= change_pair_crossings( before, after, true, -1 );
+          down_change += change_pair_crossings( after, before, true, +1 );
+        }
+      if ( layer < CTX(number_of_layers) - 1 )
+        {
+          up_change -= change_pair_crossings( before, after, false, -1 );
+          up_change += change_pair_crossings( after, before, false, +1 );
+        }
+    }
+  reposition_node( node, nodes, after_position );
+  adjustCrossingsForLayer( layer, old_position, node->position,
+                           down_change, up_change );
+  if ( OPTION(sift_update) == CHECKED_DELTA
+       && ! checkCrossingsForLayer( layer ) )
+    {
+      fprintf( stderr, "FATAL: inconsistent crossings after sifting %s\n",
+               NODE_NAME( node ) );
+      abort();
+    }
+}
+
 /**
  * @brief puts the node in a position that minimizes the number of crossings.
  *
@@ -58,21 +137,24 @@ void sift( Nodeptr node )
 {
 #ifdef DEBUG
   printf( "-> sift, node = %s, layer = %d, position = %d\n",
-          node->name, node->layer, node->position );
+          NODE_NAME( node ), node->layer, node->position );
 #endif
   // create an array containing diff( node, y_i ) for each y_i on the same
   // layer as 'node', assuming y_i is the node in position i of the layer
-  int layer_size =  layers[node->layer]->number_of_nodes;
-  Nodeptr * nodes = layers[node->layer]->nodes;
+  int layer_size =  CTX(layers)[node->layer]->node_count;
+  Nodeptr * nodes = CTX(layers)[node->layer]->nodes;
   int * diff = (int *) calloc( layer_size, sizeof(int) );
   int i = 0;
   for( i = 0; i < layer_size; i++ ) {
-      if ( nodes[i] != node ) {
+      if ( nodes[i] == node ) {
+          diff[i] = 0;
+      }
+      else if ( OPTION(sift_update) == RECOUNT ) {
           diff[i] = node_crossings( nodes[ i ], node )
             - node_crossings( node, nodes[ i ] );
       }
       else {
-          diff[i] = 0;
+          diff[i] = pair_difference( nodes[ i ], node );
       }
 #ifdef DEBUG
       printf( "  sift loop: diff[%d] = %d\n", i, diff[i] );
@@ -108,16 +190,42 @@ void sift( Nodeptr node )
           min_prefix_sum, node->position, min_position );
 #endif
 
-  reposition_node( node, nodes, min_position ); 
+  if ( OPTION(sift_update) != RECOUNT ) {
+    reposition_and_adjust( node, nodes, min_position );
+  }
+  else {
+    reposition_node( node, nodes, min_position ); 
 
-  // recompute crossings with respect to this layer
-  updateCrossingsForLayer( node->layer );
+    // recompute crossings with respect to this layer
+    updateCrossingsForLayer( node->layer );
+  }
 #ifdef DEBUG
   printf( "<- sift, node = %s, layer = %d, position = %d\n",
-          node->name, node->layer, node->position );
+          NODE_NAME( node ), node->layer, node->position );
 #endif
 }
 
+void siftConcurrently( Nodeptr * batch, int batch_size )
+{
+  for ( int i = 0; i < batch_size; i++ )
+    for ( int j = i + 1; j < batch_size; j++ )
+      assert( abs( batch[i]->layer - batch[j]->layer ) >= 2 );
+  // the queues for maxCrossingsNode() and maxCrossingsEdge() are shared,
+  // and so are the positions of the layers between those of the batch
+  suspendQueueUpdates();
+  refreshAllPositions();
+  int i;
+#ifdef _OPENMP
+#pragma omp parallel for default(none) private(i) \
+  shared(batch, batch_size) copyin(current_context) schedule(dynamic)
+#endif
+  for ( i = 0; i < batch_size; i++ )
+    {
+      sift( batch[i] );
+    }
+  resumeQueueUpdates();
+}
+
 static void reposition_node( Nodeptr node, Nodeptr * nodes,
                              int after_position )
 {
@@ -148,6 +256,7 @@ static void reposition_node( Nodeptr node, Nodeptr * nodes,
       nodes[ after_position ] = node;
       node->position = after_position;
     }
+  layerOrderChanged( node->layer );
 }
 
 /**
@@ -173,11 +282,11 @@ void sift_node_for_edge_crossings( Edgeptr edge, Nodeptr node ) {
   assert( node == edge->up_node || node == edge->down_node );
 #ifdef DEBUG
   printf( "-> sift_node_for_edge_crossings: %s -> %s, %s\n",
-          edge->down_node->name, edge->up_node->name, node->name );
+          NODE_NAME( edge->down_node ), NODE_NAME( edge->up_node ), NODE_NAME( node ) );
 #endif
   int layer = node->layer;
-  int layer_size = layers[ layer ]->number_of_nodes;
-  Nodeptr * nodes_on_layer = layers[ layer ]->nodes;
+  int layer_size = CTX(layers)[ layer ]->node_count;
+  Nodeptr * nodes_on_layer = CTX(layers)[ layer ]->nodes;
 
   // find the position where the maximum edge crossing count achieves its
   // minimum; bias the decision in favor of maximum distance from the current
@@ -246,42 +355,165 @@ void sift_node_for_edge_crossings( Edgeptr edge, Nodeptr node ) {
  */
 static void swap_nodes(int layer, int i, int j) {
   assert(i >= 0 && j >= 0);
-  assert(i < layers[layer]->number_of_nodes && i < layers[layer]->number_of_nodes);
-  Nodeptr * nodes_on_layer = layers[layer]->nodes;
+  assert(i < CTX(layers)[layer]->node_count
+         && i < CTX(layers)[layer]->node_count);
+  Nodeptr * nodes_on_layer = CTX(layers)[layer]->nodes;
   Nodeptr tmp = nodes_on_layer[i];
   nodes_on_layer[i] = nodes_on_layer[j];
   nodes_on_layer[j] = tmp;
   nodes_on_layer[i]->position = i;
   nodes_on_layer[j]->position = j;
+  layerOrderChanged(layer);
 } 
 
+/**
+ * Units in which sift_node_for_total_stretch() measures stretch: the
+ * stretch of an edge is multiplied by the product of the scales of the
+ * sifted node's layer and its two neighboring layers (see layerScale()),
+ * which makes it an integer, so sums of it can be updated incrementally
+ * without rounding error, as in channel.c.
+ */
+typedef struct stretch_units {
+  long node_scale;              /* scale of the node's layer */
+  long down_scale;              /* of the layer below (1 if there is none) */
+  long up_scale;                /* of the layer above (1 if there is none) */
+} * StretchUnitsptr;
+
+/**
+ * Sets the units for sifting a node on the given layer
+ */
+static void set_stretch_units(StretchUnitsptr units, int layer) {
+  units->node_scale = layerScale(layer);
+  units->down_scale = layer > 0 ? layerScale(layer - 1) : 1;
+  units->up_scale
+    = layer < CTX(number_of_layers) - 1 ? layerScale(layer + 1) : 1;
+}
+
+/**
+ * @return true if the stretch of the edges incident on the layer, in the
+ * given units, can be tracked as a long long without any risk of overflow.
+ * An edge contributes at most the product of the three scales, and the
+ * tracked difference and the terms added to and subtracted from it are
+ * each bounded by that times the number of edges.
+ */
+static bool exact_layer_stretch(int layer, StretchUnitsptr units) {
+  int edge_count = 0;
+  if ( layer > 0 ) edge_count += CTX(channels)[layer]->edge_count;
+  if ( layer < CTX(number_of_layers) - 1 )
+    edge_count += CTX(channels)[layer + 1]->edge_count;
+  double scale_product
+    = (double) units->node_scale * units->down_scale * units->up_scale;
+  return scale_product <= (double) LLONG_MAX / 4 / (edge_count + 1);
+}
+
+/**
+ * @return the total stretch of the edges incident on node, in the given
+ * units
+ */
+static long long scaled_node_stretch(Nodeptr node, StretchUnitsptr units) {
+  long node_scale = units->node_scale;
+  long down_scale = units->down_scale;
+  long up_scale = units->up_scale;
+  long long down_stretch = 0;
+  for ( int i = 0; i < node->down_degree; i++ ) {
+    Nodeptr other = node->down_edges[i]->down_node;
+    down_stretch += llabs( (long long) node->position * down_scale
+                           - (long long) other->position * node_scale );
+  }
+  long long up_stretch = 0;
+  for ( int i = 0; i < node->up_degree; i++ ) {
+    Nodeptr other = node->up_edges[i]->up_node;
+    up_stretch += llabs( (long long) node->position * up_scale
+                         - (long long) other->position * node_scale );
+  }
+  return down_stretch * up_scale + up_stretch * down_scale;
+}
+
+/**
+ * Stretch of the edges incident on a layer as the nodes on it are swapped
+ * during a sift: if it can be tracked exactly (see exact_layer_stretch()),
+ * scaled is kept relative to the original order, in the given units;
+ * otherwise total is recomputed with totalLayerStretch() after each swap.
+ */
+typedef struct layer_stretch {
+  int layer;
+  bool exact;
+  struct stretch_units units;
+  long long scaled;
+  double total;
+} * LayerStretchptr;
+
+static void init_layer_stretch(LayerStretchptr tracked, int layer) {
+  tracked->layer = layer;
+  set_stretch_units(&tracked->units, layer);
+  tracked->exact = exact_layer_stretch(layer, &tracked->units);
+  tracked->scaled = 0;
+  tracked->total = tracked->exact ? 0.0 : totalLayerStretch(layer);
+}
+
+/**
+ * Swaps the nodes at positions i and i+1 and updates the tracked stretch
+ */
+static void swap_tracking_stretch(LayerStretchptr tracked, int i) {
+  int layer = tracked->layer;
+  if ( ! tracked->exact ) {
+    swap_nodes(layer, i, i+1);
+    tracked->total = totalLayerStretch(layer);
+    return;
+  }
+  Nodeptr left = CTX(layers)[layer]->nodes[i];
+  Nodeptr right = CTX(layers)[layer]->nodes[i+1];
+  tracked->scaled
+    -= scaled_node_stretch(left, &tracked->units)
+    + scaled_node_stretch(right, &tracked->units);
+  swap_nodes(layer, i, i+1);
+  tracked->scaled
+    += scaled_node_stretch(left, &tracked->units)
+    + scaled_node_stretch(right, &tracked->units);
+}
+
+/**
+ * @return -1, 0 or 1 as the tracked stretch is less than, equal to or
+ * greater than the minimum so far
+ */
+static int compare_to_min(LayerStretchptr tracked, LayerStretchptr min) {
+  if ( tracked->exact ) {
+    return ( tracked->scaled > min->scaled )
+      - ( tracked->scaled < min->scaled );
+  }
+  return ( tracked->total > min->total )
+    - ( tracked->total < min->total );
+}
+
 void sift_node_for_total_stretch(Nodeptr node) {
   int layer = node->layer;
-  int layer_size = layers[layer]->number_of_nodes;
+  int layer_size = CTX(layers)[layer]->node_count;
 
   if ( layer_size == 1 ) return;
 
-  // resorting to the (possibly inefficient) naive algorithm here, i.e.,
-  // recomputing stretch after each move
-  double min_stretch = totalLayerStretch(layer);
+  // Layer sizes do not change during a sift, so a swap of two adjacent
+  // nodes changes only the stretch of their own edges.
+  struct layer_stretch current;
+  init_layer_stretch(&current, layer);
+  struct layer_stretch min = current;
   int min_position = node->position;
   int original_position = node->position;
 
   // begin with a sweep to the left of the current node position, keeping
   // track of minimum stretch, or maximum distance as a tie breaker
   for ( int i = original_position - 1; i >= 0; i-- ) {
-    swap_nodes(layer, i, i+1);
-    double current_stretch = totalLayerStretch(layer);
-    if ( current_stretch < min_stretch
+    swap_tracking_stretch(&current, i);
+    int comparison = compare_to_min(&current, &min);
+    if ( comparison < 0
          ||
-         (current_stretch == min_stretch
+         (comparison == 0
           && original_position - i > original_position - min_position) ) {
-      min_stretch = current_stretch;
+      min = current;
       min_position = i;
     }
 #ifdef DEBUG
-    printf( " mse left sweep: pos = %2d, min_pos = %2d, stretch = %6.1f\n",
-            i, min_position, current_stretch );
+    printf( " mse left sweep: pos = %2d, min_pos = %2d, stretch = %lld, %f\n",
+            i, min_position, current.scaled, current.total );
 #endif
   }
 
@@ -289,21 +521,22 @@ void sift_node_for_total_stretch(Nodeptr node) {
   for ( int i = 0; i < original_position; i++ ) {
     swap_nodes(layer, i, i+1);
   }
+  init_layer_stretch(&current, layer);
 
   // sweep to the right of original position, tracking stretch and distance
   for ( int i = original_position + 1; i < layer_size; i++ ) {
-    swap_nodes(layer, i-1, i);
-    double current_stretch = totalLayerStretch(layer);
-    if ( current_stretch < min_stretch
+    swap_tracking_stretch(&current, i-1);
+    int comparison = compare_to_min(&current, &min);
+    if ( comparison < 0
          ||
-         (current_stretch == min_stretch
+         (comparison == 0
           && i - original_position > abs(original_position - min_position)) ) {
-      min_stretch = current_stretch;
+      min = current;
       min_position = i;
     }
 #ifdef DEBUG
-    printf( " mse right sweep: pos = %2d, min_pos = %2d, stretch = %6.1f\n",
-            i, min_position, current_stretch );
+    printf( " mse right sweep: pos = %2d, min_pos = %2d, stretch = %lld, %f\n",
+            i, min_position, current.scaled, current.total );
 #endif
   }
 
@@ -314,4 +547,4 @@ void sift_node_for_total_stretch(Nodeptr node) {
 
 } // end, sift node for total stretch
 
-/*  [Last modified: 2016 05 20 at 20:53:54 GMT] */
+/*  [Last modified: 2026 10 16 at 19:00:19 GMT] */
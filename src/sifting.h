@@ -21,6 +21,14 @@
  */
 void sift( Nodeptr node );
 
+/**
+ * Sifts each node of the batch as sift() does; when compiled with OpenMP the
+ * nodes are sifted concurrently. Sifting a node changes only the channels
+ * incident on its layer, so the nodes must be on layers that are at least
+ * two apart.
+ */
+void siftConcurrently( Nodeptr * batch, int batch_size );
+
 /**
  * @param edge An edge that has the current maximum number of crossings; for
  * convience so that this does not need to be recalculated, it is assumed
@@ -39,4 +47,4 @@ void sift_node_for_total_stretch(Nodeptr node);
 
 #endif
 
-/*  [Last modified: 2016 05 19 at 20:15:25 GMT] */
+/*  [Last modified: 2026 10 16 at 15:25:20 GMT] */
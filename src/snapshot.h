@@ -0,0 +1,78 @@
+/**
+ * @file snapshot.h
+ * @brief Layout of graph snapshot files: a binary image of a layered graph,
+ * and optionally of some saved orderings of it, that can be memory-mapped
+ * and turned into the graph structures of graph.h without parsing or name
+ * lookup - see readSnapshot() and writeSnapshot() in graph_io.h.
+ *
+ * A snapshot file consists of a header followed by sections, each of which
+ * starts at an offset (from the beginning of the file) that is a multiple
+ * of SNAPSHOT_ALIGNMENT. With L layers, N nodes, E edges and K orderings,
+ * the sections are
+ *
+ *   layer_size      int32[L]    number of nodes on each layer
+ *   node_name       uint32[N]   offset of the name of each node in the
+ *                               string pool
+ *   string_pool     char[]      '\0'-terminated strings: the graph name,
+ *                               the node names and the ordering names
+ *   edge            int32[2E]   upper and lower endpoint of each edge
+ *   up_start        int32[N+1]  CSR adjacency: the up edges of node v are
+ *   up_edge         int32[E]      up_edge[up_start[v]], ...,
+ *                                 up_edge[up_start[v+1] - 1], in order
+ *                                 of id
+ *   down_start      int32[N+1]  same for down edges
+ *   down_edge       int32[E]
+ *   order_name      uint32[K]   offset of the name of each ordering in the
+ *                               string pool
+ *   order           int32[K*N]  for each ordering, the nodes of each layer
+ *                               in order of position, layer after layer
+ *
+ * Nodes and edges are identified by their id's. The nodes of each layer
+ * have consecutive id's, layer after layer, and the order of the id's is
+ * the order of the nodes on the layer when the graph was read, i.e., the
+ * order given by the ord or sgf file. All numbers are in the byte order of
+ * the machine that wrote the file; byte_order tells whether that is the
+ * byte order of the reader.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/16
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include<stdint.h>
+
+#define SNAPSHOT_MAGIC "LGSNAP\r\n"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_BYTE_ORDER 0x01020304
+#define SNAPSHOT_ALIGNMENT 8
+
+typedef struct snapshot_header {
+  char magic[8];                /* SNAPSHOT_MAGIC, without the '\0' */
+  uint32_t version;             /* SNAPSHOT_VERSION */
+  uint32_t byte_order;          /* SNAPSHOT_BYTE_ORDER */
+  uint32_t header_size;         /* sizeof(struct snapshot_header) */
+  int32_t layer_count;
+  int32_t node_count;
+  int32_t edge_count;
+  int32_t order_count;
+  uint32_t graph_name_offset;   /* in the string pool */
+  uint64_t string_pool_size;
+  // offsets of the sections from the beginning of the file
+  uint64_t layer_size;
+  uint64_t node_name;
+  uint64_t string_pool;
+  uint64_t edge;
+  uint64_t up_start;
+  uint64_t up_edge;
+  uint64_t down_start;
+  uint64_t down_edge;
+  uint64_t order_name;
+  uint64_t order;
+  uint64_t file_size;
+} SnapshotHeader;
+
+#endif
+
+/*  [Last modified: 2026 10 16 at 18:53:46 GMT] */
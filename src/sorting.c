@@ -10,10 +10,11 @@
 #include<stdio.h>
 #include<stdlib.h>
 #include<stdbool.h>
-#include<string.h>              /* memcpy() */
+#include<string.h>              /* memcpy(), memset() */
 
 #include"sorting.h"
 #include"graph.h"
+#include"order.h"
 
 /**
  * Performs an insertion sort using the same argument types as qsort
@@ -46,42 +47,8 @@ static bool insertion_sort(void *base, size_t nmemb, size_t size,
 }
 
 /**
- * Performs an "unstable" insertion sort using the same argument types as
- * qsort; unstable means that elements with equal keys will be put in reverse
- * of their original order
- * @return true if the original order has changed
- */
-static bool unstable_insertion_sort(void *base, size_t nmemb, size_t size,
-                                    int (*compar)(const void *, const void *)) {
-  bool changed = false;
-  // used to store the item to be inserted
-  void * tmp = malloc(size);
-  int i = 1;
-  for( ; i < nmemb; i++ ) {
-    // 1. insert the A[i] among A[0],...,A[i-1]
-    //    (a) copy A[i] into tmp
-    memcpy( tmp, base + i * size, size );
-    //    (b) find largest i for which A[i] <= tmp (or -1 if none exists),
-    //    shifting elements to the right as you go
-    int j = i - 1;
-    while( j >= 0 && compar( tmp, base + j * size) <= 0 ) {
-      changed = true;
-      memcpy( base + (j + 1) * size, base + j * size, size );
-      j--;
-    }
-
-    //    (c) copy tmp into A[i+1]
-    memcpy( base + (j + 1) * size, tmp, size ); 
-  }
-  free( tmp );
-  return changed;
-}
-
-/**
- * Comparison function to be used by qsort or insertion_sort to compare the
- * weights of two nodes. Assumes that each array element is a pointer to a
- * node. Insertion sort is preferred in most cases because it is stable (and
- * usually does not increase the asymptotic time).
+ * Comparison function to be used by qsort to compare the weights of two
+ * nodes. Assumes that each array element is a pointer to a node.
  */
 static int compare_weights( const void * ptr_i, const void * ptr_j ) {
   Nodeptr * entry_ptr_i = (Nodeptr *) ptr_i;
@@ -140,7 +107,7 @@ static int compare_up_edges( const void * ptr_i, const void * ptr_j ) {
 
 void updateAllPositions( void )
 {
-  for( int i = 0; i < number_of_layers; i++ )
+  for( int i = 0; i < CTX(number_of_layers); i++ )
     {
       updateNodePositions( i );
     }
@@ -148,48 +115,296 @@ void updateAllPositions( void )
 
 void updateNodePositions( int layer )
 {
-  Layerptr layerptr = layers[layer];
+  Layerptr layerptr = CTX(layers)[layer];
+  bool changed = false;
   int i = 0;
-  for( ; i < layerptr->number_of_nodes; i++ )
+  for( ; i < layerptr->node_count; i++ )
     {
+      if ( layerptr->nodes[i]->position == i ) continue;
       layerptr->nodes[i]->position = i;
+      changed = true;
+    }
+  if ( changed ) layerOrderChanged( layer );
+}
+
+/**
+ * A node to be sorted by layerSort(), represented by its weight and its
+ * index in the original node array; sorting packed records avoids both
+ * indirect comparisons and a dereference of each node for every
+ * comparison.
+ */
+typedef struct sort_record_struct {
+  double weight;
+  int index;
+} SortRecord;
+
+/**
+ * Runs shorter than this are extended with an insertion sort before merging
+ */
+#define MIN_RUN 16
+
+/**
+ * The counting sort is used only if the number of distinct possible keys is
+ * at most this multiple of the number of records
+ */
+#define COUNTING_RANGE_FACTOR 4
+
+/**
+ * Sorts records[low],...,records[high-1] given that records[low],...,
+ * records[sorted-1] are already sorted; stable
+ */
+static void insertion_sort_records( SortRecord * records,
+                                    int low, int sorted, int high )
+{
+  for ( int i = sorted; i < high; i++ ) {
+    SortRecord tmp = records[i];
+    int j = i - 1;
+    while ( j >= low && records[j].weight > tmp.weight ) {
+      records[j + 1] = records[j];
+      j--;
+    }
+    records[j + 1] = tmp;
+  }
+}
+
+/**
+ * Merges the sorted runs source[low],...,source[middle-1] and
+ * source[middle],...,source[high-1] into target[low],...,target[high-1];
+ * stable
+ */
+static void merge_records( const SortRecord * source, SortRecord * target,
+                           int low, int middle, int high )
+{
+  int left = low;
+  int right = middle;
+  int out = low;
+  // the runs are often already in order relative to each other
+  if ( source[middle - 1].weight <= source[middle].weight ) {
+    memcpy( target + low, source + low, (high - low) * sizeof(SortRecord) );
+    return;
+  }
+  while ( left < middle && right < high ) {
+    if ( source[right].weight < source[left].weight )
+      target[out++] = source[right++];
+    else
+      target[out++] = source[left++];
+  }
+  while ( left < middle ) target[out++] = source[left++];
+  while ( right < high ) target[out++] = source[right++];
+}
+
+/**
+ * Natural merge sort: the records are split into maximal nondecreasing runs,
+ * each extended to at least MIN_RUN records, and adjacent runs are merged
+ * until one is left. Stable, O(n log n) in the worst case and O(n) if the
+ * records are already sorted.
+ * @param scratch space for number_of_records records
+ * @param run_start space for number_of_records / MIN_RUN + 2 entries;
+ * run_start[k] becomes the index of the first record of run k, the last
+ * entry being number_of_records
+ */
+static void merge_sort_records( SortRecord * records, SortRecord * scratch,
+                                int * run_start, int number_of_records )
+{
+  int number_of_runs = 0;
+  int low = 0;
+  while ( low < number_of_records ) {
+    int high = low + 1;
+    while ( high < number_of_records
+            && records[high - 1].weight <= records[high].weight )
+      high++;
+    int sorted = high;
+    if ( high - low < MIN_RUN ) {
+      high = low + MIN_RUN < number_of_records
+        ? low + MIN_RUN : number_of_records;
+      insertion_sort_records( records, low, sorted, high );
     }
+    run_start[ number_of_runs++ ] = low;
+    low = high;
+  }
+  run_start[ number_of_runs ] = number_of_records;
+
+  SortRecord * source = records;
+  SortRecord * target = scratch;
+  while ( number_of_runs > 1 ) {
+    int merged_runs = 0;
+    int k = 0;
+    for ( ; k + 1 < number_of_runs; k += 2 ) {
+      merge_records( source, target,
+                     run_start[k], run_start[k + 1], run_start[k + 2] );
+      run_start[ merged_runs++ ] = run_start[k];
+    }
+    if ( k < number_of_runs ) {
+      // odd run out
+      memcpy( target + run_start[k], source + run_start[k],
+              (run_start[k + 1] - run_start[k]) * sizeof(SortRecord) );
+      run_start[ merged_runs++ ] = run_start[k];
+    }
+    run_start[ merged_runs ] = number_of_records;
+    number_of_runs = merged_runs;
+    SortRecord * tmp = source;
+    source = target;
+    target = tmp;
+  }
+  if ( source != records )
+    memcpy( records, source, number_of_records * sizeof(SortRecord) );
 }
 
-void layerSort( int layer )
+/**
+ * Sorts the records with a counting sort if every weight is a multiple of
+ * 1/2 -- median weights and the integer weights of the dfs preprocessor
+ * are -- and the weights span a small enough range. Stable.
+ * @param scratch space for number_of_records records
+ * @param start space for COUNTING_RANGE_FACTOR * number_of_records + 1
+ * counts
+ * @return true if the records were sorted, false if the counting sort does
+ * not apply
+ */
+static bool counting_sort_records( SortRecord * records, SortRecord * scratch,
+                                   int * start, int number_of_records )
+{
+  double min_key = 2 * records[0].weight;
+  double max_key = min_key;
+  for ( int i = 0; i < number_of_records; i++ ) {
+    double key = 2 * records[i].weight;
+    if ( key != (double) (long) key ) return false;
+    if ( key < min_key ) min_key = key;
+    if ( key > max_key ) max_key = key;
+  }
+  if ( max_key - min_key
+       >= (double) COUNTING_RANGE_FACTOR * number_of_records )
+    return false;
+  int range = (int) ( max_key - min_key ) + 1;
+  memset( start, 0, ( range + 1 ) * sizeof(int) );
+  for ( int i = 0; i < number_of_records; i++ )
+    start[ (int) ( 2 * records[i].weight - min_key ) + 1 ]++;
+  for ( int key = 1; key <= range; key++ )
+    start[key] += start[key - 1];
+  for ( int i = 0; i < number_of_records; i++ )
+    scratch[ start[ (int) ( 2 * records[i].weight - min_key ) ]++ ]
+      = records[i];
+  memcpy( records, scratch, number_of_records * sizeof(SortRecord) );
+  return true;
+}
+
+/**
+ * Scratch space for sort_layer(): records for twice the capacity and counts
+ * for the counting sort, which also hold the run starts of the merge sort.
+ * Layers may be sorted in parallel, so each thread has its own scratch
+ * space; it is allocated on first use with room for the largest layer, and
+ * so is reallocated only if a later graph has a larger one.
+ */
+static __thread SortRecord * sort_records = NULL;
+static __thread int * sort_counts = NULL;
+static __thread int sort_capacity = 0;
+#ifdef _OPENMP
+#pragma omp threadprivate(sort_records, sort_counts, sort_capacity)
+#endif
+
+void free_sort_scratch( void )
+{
+  free( sort_records );
+  free( sort_counts );
+  sort_records = NULL;
+  sort_counts = NULL;
+  sort_capacity = 0;
+}
+
+/**
+ * Makes sure that the calling thread's scratch space has room for a layer
+ * of the given size
+ */
+static void ensure_sort_scratch( int layer_size )
+{
+  if ( sort_capacity >= layer_size ) return;
+  int capacity = layer_size;
+  for ( int layer = 0; layer < CTX(number_of_layers); layer++ )
+    if ( CTX(layers)[layer]->node_count > capacity )
+      capacity = CTX(layers)[layer]->node_count;
+  free_sort_scratch();
+  sort_capacity = capacity;
+  sort_records
+    = (SortRecord *) malloc( 2 * (size_t) capacity * sizeof(SortRecord) );
+  sort_counts = (int *) malloc( ( COUNTING_RANGE_FACTOR * (size_t) capacity
+                                  + 2 ) * sizeof(int) );
+  if ( sort_records == NULL || sort_counts == NULL ) {
+    fprintf( stderr, "FATAL: unable to allocate sort scratch for %d nodes\n",
+             capacity );
+    abort();
+  }
+}
+
+/**
+ * Sorts the nodes of a layer by weight, stably if reverse_ties is false and
+ * with nodes of equal weight in reverse of their original order otherwise;
+ * positions are updated.
+ * @return true if the order of the nodes has changed
+ */
+static bool sort_layer( int layer, bool reverse_ties )
+{
+  Layerptr layer_ptr = CTX(layers)[ layer ];
+  int layer_size = layer_ptr->node_count;
+  Nodeptr * nodes = layer_ptr->nodes;
+  bool changed = false;
+  if ( layer_size > 1 ) {
+    ensure_sort_scratch( layer_size );
+    SortRecord * records = sort_records;
+    SortRecord * scratch = records + layer_size;
+    // a stable sort of the records in reverse order puts ties in reverse
+    for ( int i = 0; i < layer_size; i++ ) {
+      int index = reverse_ties ? layer_size - 1 - i : i;
+      records[i].weight = nodes[index]->weight;
+      records[i].index = index;
+    }
+    if ( ! counting_sort_records( records, scratch, sort_counts, layer_size ) )
+      merge_sort_records( records, scratch, sort_counts, layer_size );
+    for ( int i = 0; i < layer_size; i++ ) {
+      if ( records[i].index != i ) {
+        changed = true;
+        break;
+      }
+    }
+    if ( changed ) {
+      Nodeptr * original_nodes = (Nodeptr *) scratch;
+      memcpy( original_nodes, nodes, layer_size * sizeof(Nodeptr) );
+      for ( int i = 0; i < layer_size; i++ )
+        nodes[i] = original_nodes[ records[i].index ];
+    }
+  }
+  if ( changed ) updateNodePositions( layer );
+  return changed;
+}
+
+bool layerSort( int layer )
 {
-  Layerptr layer_ptr = layers[ layer ];
 #ifdef DEBUG
+  Layerptr layer_ptr = CTX(layers)[ layer ];
   printf( "before layerSort: ");
-  for ( int i = 0; i < layer_ptr->number_of_nodes; i++ ) {
+  for ( int i = 0; i < layer_ptr->node_count; i++ ) {
     printf( "%3d/%3.1f" , layer_ptr->nodes[i]->id, layer_ptr->nodes[i]->weight );
   }
   printf( "\n" );
 #endif
-  insertion_sort( layer_ptr->nodes, layer_ptr->number_of_nodes,
-                  sizeof( Nodeptr ), compare_weights );
+  bool changed = sort_layer( layer, false );
 #ifdef DEBUG
   printf( "after layerSort:  ");
-  for ( int i = 0; i < layer_ptr->number_of_nodes; i++ ) {
+  for ( int i = 0; i < layer_ptr->node_count; i++ ) {
     printf( "%3d/%3.1f" , layer_ptr->nodes[i]->id, layer_ptr->nodes[i]->weight );
   }
   printf( "\n" );
 #endif
-  updateNodePositions( layer );
+  return changed;
 }
 
-void layerUnstableSort( int layer )
+bool layerUnstableSort( int layer )
 {
-  Layerptr layer_ptr = layers[ layer ];
-  unstable_insertion_sort( layer_ptr->nodes, layer_ptr->number_of_nodes,
-                           sizeof( Nodeptr ), compare_weights );
-  updateNodePositions( layer );
+  return sort_layer( layer, true );
 }
 
 void layerQuicksort( int layer )
 {
-  Layerptr layer_ptr = layers[ layer ];
-  qsort( layer_ptr->nodes, layer_ptr->number_of_nodes,
+  Layerptr layer_ptr = CTX(layers)[ layer ];
+  qsort( layer_ptr->nodes, layer_ptr->node_count,
          sizeof( Nodeptr ), compare_weights );
   updateNodePositions( layer );
 }
@@ -217,4 +432,4 @@ void sortByDegree( Nodeptr * node_array, int num_nodes )
   qsort( node_array, num_nodes, sizeof(Nodeptr), compare_degrees );
 }
 
-/*  [Last modified: 2014 07 21 at 18:21:49 GMT] */
+/*  [Last modified: 2026 10 16 at 19:03:04 GMT] */
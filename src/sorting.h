@@ -10,13 +10,18 @@
 #ifndef SORTING_H
 #define SORTING_H
 
+#include<stdbool.h>
 #include"graph.h"
 
 /**
  * Sorts the nodes of the given layer by increasing weight and updates the
- * position fields of the nodes accordingly. Uses insertion sort.
+ * position fields of the nodes accordingly. Uses a counting sort if all
+ * weights are multiples of 1/2 in a small range, as with median and dfs
+ * weights, and a natural merge sort otherwise, so it takes linear time if
+ * the layer is already (nearly) sorted and O(n log n) in the worst case.
+ * @return true if the order of the nodes has changed
  */
-void layerSort( int layer );
+bool layerSort( int layer );
 
 /**
  * Sorts the nodes of the given layer by increasing weight and updates the
@@ -25,11 +30,11 @@ void layerSort( int layer );
 void layerQuicksort( int layer );
 
 /**
- * Sorts the nodes of the given layer by increasing weight and updates the
- * position fields of the nodes accordingly. Uses insertion sort with equal
- * elements in reverse order.
+ * Same as layerSort(), except that nodes with equal weights end up in
+ * reverse of their original order.
+ * @return true if the order of the nodes has changed
  */
-void layerUnstableSort( int layer );
+bool layerUnstableSort( int layer );
 
 /**
  * Sorts the nodes of the given layer by increasing weight and updates the
@@ -54,7 +59,10 @@ void sortByDegree( Nodeptr * node_array, int num_nodes );
 
 /**
  * Updates the position field of each node on the layer to reflect the current
- * position in the nodes array.
+ * position in the nodes array. The layer counts as changed (see
+ * layerOrderChanged() in order.h) only if some position was out of date, so
+ * that a recount after a sort that left the layer as it was does not force
+ * the next save of an order to copy the layer.
  */
 void updateNodePositions( int layer );
 
@@ -63,6 +71,12 @@ void updateNodePositions( int layer );
  */
 void updateAllPositions( void );
 
+/**
+ * Deallocates the scratch space that layerSort() and layerUnstableSort()
+ * keep for the calling thread, e.g., before the thread exits
+ */
+void free_sort_scratch( void );
+
 #endif
 
-/*  [Last modified: 2011 07 18 at 19:20:59 GMT] */
+/*  [Last modified: 2026 10 16 at 19:03:04 GMT] */
@@ -25,27 +25,35 @@
 #include"priority_edges.h"
 #include"Statistics.h"
 #include"timing.h"
+#include"hash.h"
 
 typedef struct pareto_item {
   double objective_one;
   double objective_two;
-  int iteration;
+  int iteration_number;
   struct pareto_item * rest;
 } * PARETO_LIST;
 
-static PARETO_LIST pareto_list = NULL;
+static void init_pareto_list( void ) { CTX(pareto_list) = NULL; }
 
-static void init_pareto_list( void ) { pareto_list = NULL; }
+void cleanup_crossing_stats( void )
+{
+  while ( CTX(pareto_list) != NULL ) {
+    PARETO_LIST rest = CTX(pareto_list)->rest;
+    free( CTX(pareto_list) );
+    CTX(pareto_list) = rest;
+  }
+}
 
 static void print_pareto_list( PARETO_LIST list, FILE * output_stream ) {
   PARETO_LIST local_list = list;
   while ( local_list != NULL ) {
-    if ( pareto_objective == BOTTLENECK_TOTAL ) {
+    if ( OPTION(pareto_objective) == BOTTLENECK_TOTAL ) {
       fprintf(output_stream, "%d^%d",
               (int) local_list->objective_one,
               (int) local_list->objective_two);
     }
-    else if ( pareto_objective == STRETCH_TOTAL ) {
+    else if ( OPTION(pareto_objective) == STRETCH_TOTAL ) {
       fprintf(output_stream, "%f^%d",
               local_list->objective_one,
               (int) local_list->objective_two);
@@ -61,7 +69,7 @@ static void print_pareto_list( PARETO_LIST list, FILE * output_stream ) {
   local_list = list;
   printf(", ");
   while ( local_list != NULL ) {
-    fprintf(output_stream, "%d", local_list->iteration);
+    fprintf(output_stream, "%d", local_list->iteration_number);
     local_list = local_list->rest;
     if ( local_list != NULL ) fprintf(output_stream, ";");
   }
@@ -74,11 +82,11 @@ static void print_pareto_list( PARETO_LIST list, FILE * output_stream ) {
  */
 static PARETO_LIST pareto_insert(double objective_one,
                                  double objective_two,
-                                 int iteration,
+                                 int iteration_number,
                                  PARETO_LIST list) {
 #ifdef DEBUG
   printf("-> pareto_insert: %f, %f, %d, ",
-         objective_one, objective_two, iteration);
+         objective_one, objective_two, iteration_number);
   print_pareto_list(list, stdout);
   printf("\n");
 #endif
@@ -87,7 +95,7 @@ static PARETO_LIST pareto_insert(double objective_one,
     new_list = (PARETO_LIST) calloc(1, sizeof(struct pareto_item));
     new_list->objective_one = objective_one;
     new_list->objective_two = objective_two;
-    new_list->iteration = iteration;
+    new_list->iteration_number = iteration_number;
     new_list->rest = NULL;
   }
   else {
@@ -99,14 +107,14 @@ static PARETO_LIST pareto_insert(double objective_one,
       new_list = (PARETO_LIST) calloc(1, sizeof(struct pareto_item));
       new_list->objective_one = objective_one;
       new_list->objective_two = objective_two;
-      new_list->iteration = iteration;
+      new_list->iteration_number = iteration_number;
       new_list->rest = list;
     }
     else if ( objective_one < first_objective_one
               && objective_two == first_objective_two ) {
       // replace first point, found one with smaller objective_one value
       list->objective_one = objective_one;
-      list->iteration = iteration;
+      list->iteration_number = iteration_number;
       new_list = list;
     }
     else if ( objective_one <= first_objective_one
@@ -116,7 +124,7 @@ static PARETO_LIST pareto_insert(double objective_one,
       // case, we need to actually delete the existing first point
       new_list = pareto_insert(objective_one,
                                objective_two,
-                               iteration,
+                               iteration_number,
                                list->rest);
       free(list);
     }
@@ -126,7 +134,7 @@ static PARETO_LIST pareto_insert(double objective_one,
       // found
       list->rest = pareto_insert(objective_one,
                                  objective_two,
-                                 iteration,                                 
+                                 iteration_number,                                 
                                  list->rest);
       new_list = list;
     }
@@ -144,13 +152,6 @@ static PARETO_LIST pareto_insert(double objective_one,
   return new_list;
 }
 
-CROSSING_STATS_INT total_crossings;
-CROSSING_STATS_INT max_edge_crossings;
-CROSSING_STATS_INT favored_edge_crossings;
-CROSSING_STATS_DOUBLE total_stretch;
-CROSSING_STATS_DOUBLE bottleneck_stretch;
-Statistics overall_degree;
-
 static void init_specific_crossing_stats_int( CROSSING_STATS_INT * stats,
                                               const char * name )
 {
@@ -162,7 +163,7 @@ static void init_specific_crossing_stats_int( CROSSING_STATS_INT * stats,
   stats->best = INT_MAX;
   stats->previous_best = INT_MAX;
   stats->best_heuristic_iteration = -1;
-  stats->post_processing_iteration = -1;
+  stats->best_post_processing_iteration = -1;
 }
 
 static void init_specific_crossing_stats_double( CROSSING_STATS_DOUBLE * stats,
@@ -176,52 +177,55 @@ static void init_specific_crossing_stats_double( CROSSING_STATS_DOUBLE * stats,
   stats->best = DBL_MAX;
   stats->previous_best = DBL_MAX;
   stats->best_heuristic_iteration = -1;
-  stats->post_processing_iteration = -1;
+  stats->best_post_processing_iteration = -1;
 }
 
 void init_crossing_stats( void )
 {
-  init_specific_crossing_stats_int( & total_crossings, "Crossings" );
-  init_specific_crossing_stats_int( & max_edge_crossings, "EdgeCrossings" );
-  init_specific_crossing_stats_double( & total_stretch, "Stretch" );
-  init_specific_crossing_stats_double( & bottleneck_stretch, "BottleneckStretch" );
+  init_specific_crossing_stats_int( & CTX(total_crossings), "Crossings" );
+  init_specific_crossing_stats_int( & CTX(max_edge_crossings),
+                                    "EdgeCrossings" );
+  init_specific_crossing_stats_double( & CTX(total_stretch), "Stretch" );
+  init_specific_crossing_stats_double( & CTX(bottleneck_stretch),
+                                       "BottleneckStretch" );
 #ifdef FAVORED
-  init_specific_crossing_stats( & favored_edge_crossings, "FavoredCrossings" );
+  init_specific_crossing_stats( & CTX(favored_edge_crossings),
+                                "FavoredCrossings" );
 #endif
-  if ( pareto_objective != NO_PARETO )
+  if ( OPTION(pareto_objective) != NO_PARETO )
     init_pareto_list();
 }
 
 void capture_beginning_stats( void )
 {
-  total_crossings.at_beginning = numberOfCrossings();
-  max_edge_crossings.at_beginning = maxEdgeCrossings();
-  total_stretch.at_beginning = totalStretch();
-  bottleneck_stretch.at_beginning = maxEdgeStretch();
+  CTX(total_crossings).at_beginning = numberOfCrossings();
+  CTX(max_edge_crossings).at_beginning = maxEdgeCrossings();
+  CTX(total_stretch).at_beginning = totalStretch();
+  CTX(bottleneck_stretch).at_beginning = maxEdgeStretch();
 #ifdef FAVORED
-  favored_edge_crossings.at_beginning = priorityEdgeCrossings();
+  CTX(favored_edge_crossings).at_beginning = priorityEdgeCrossings();
 #endif
 }
 
 void capture_preprocessing_stats( void )
 {
-  total_crossings.after_preprocessing = numberOfCrossings();
-  max_edge_crossings.after_preprocessing = maxEdgeCrossings();
-  total_stretch.after_preprocessing = totalStretch();
-  bottleneck_stretch.after_preprocessing = maxEdgeStretch();
+  CTX(total_crossings).after_preprocessing = numberOfCrossings();
+  CTX(max_edge_crossings).after_preprocessing = maxEdgeCrossings();
+  CTX(total_stretch).after_preprocessing = totalStretch();
+  CTX(bottleneck_stretch).after_preprocessing = maxEdgeStretch();
 #ifdef FAVORED
-  favored_edge_crossings.after_preprocessing = priorityEdgeCrossings();
+  CTX(favored_edge_crossings).after_preprocessing = priorityEdgeCrossings();
 #endif
 }
 
 void capture_heuristic_stats( void )
 {
-  total_crossings.after_heuristic = total_crossings.best;
-  max_edge_crossings.after_heuristic = max_edge_crossings.best;
-  total_stretch.after_heuristic = total_stretch.best;
-  bottleneck_stretch.after_heuristic = bottleneck_stretch.best;
+  CTX(total_crossings).after_heuristic = CTX(total_crossings).best;
+  CTX(max_edge_crossings).after_heuristic = CTX(max_edge_crossings).best;
+  CTX(total_stretch).after_heuristic = CTX(total_stretch).best;
+  CTX(bottleneck_stretch).after_heuristic = CTX(bottleneck_stretch).best;
 #ifdef FAVORED
-  favored_edge_crossings.after_heuristic = priority_edge_crossings.best;
+  CTX(favored_edge_crossings).after_heuristic = priority_edge_crossings.best;
 #endif
 }
 
@@ -230,15 +234,16 @@ void capture_post_processing_stats( void )
   // the post processing iterations are merely counted since the total number
   // of crossings improves after each one by definition; not so with
   // bottleneck crossings or stretch
-  total_crossings.after_post_processing = total_crossings.best;
-  total_crossings.post_processing_iteration = post_processing_iteration;
-  max_edge_crossings.after_post_processing = max_edge_crossings.best;
-  total_stretch.after_post_processing = total_stretch.best;
-  bottleneck_stretch.after_post_processing = bottleneck_stretch.best;
+  CTX(total_crossings).after_post_processing = CTX(total_crossings).best;
+  CTX(total_crossings).best_post_processing_iteration
+    = CTX(post_processing_iteration);
+  CTX(max_edge_crossings).after_post_processing = CTX(max_edge_crossings).best;
+  CTX(total_stretch).after_post_processing = CTX(total_stretch).best;
+  CTX(bottleneck_stretch).after_post_processing = CTX(bottleneck_stretch).best;
 #ifdef FAVORED
   // ditto for favored edge crossings
-  favored_edge_crossings.after_post_processing =
-    favored_edge_crossings.after_heuristic;
+  CTX(favored_edge_crossings).after_post_processing =
+    CTX(favored_edge_crossings).after_heuristic;
 #endif
 }
 
@@ -252,7 +257,7 @@ void update_best_int( CROSSING_STATS_INT * stats, Orderptr order,
   if( current_value < stats->best )
     {
       stats->best = current_value;
-      stats->best_heuristic_iteration = iteration;
+      stats->best_heuristic_iteration = CTX(iteration);
       save_order( order );
     }
 #ifdef DEBUG
@@ -270,7 +275,7 @@ void update_best_double( CROSSING_STATS_DOUBLE * stats, Orderptr order,
   if( current_value < stats->best )
     {
       stats->best = current_value;
-      stats->best_heuristic_iteration = iteration;
+      stats->best_heuristic_iteration = CTX(iteration);
       save_order( order );
     }
 #ifdef DEBUG
@@ -280,30 +285,33 @@ void update_best_double( CROSSING_STATS_DOUBLE * stats, Orderptr order,
 
 void update_best_all( void )
 {
-  update_best_int( & total_crossings, best_crossings_order, numberOfCrossings );
-  update_best_int( & max_edge_crossings,
-                   best_edge_crossings_order, maxEdgeCrossings );
-  update_best_double( & total_stretch, best_total_stretch_order, totalStretch );
-  update_best_double( & bottleneck_stretch,
-                      best_bottleneck_stretch_order, maxEdgeStretch );
+  update_best_int( & CTX(total_crossings), CTX(best_crossings_order),
+                   numberOfCrossings );
+  update_best_int( & CTX(max_edge_crossings),
+                   CTX(best_edge_crossings_order), maxEdgeCrossings );
+  update_best_double( & CTX(total_stretch), CTX(best_total_stretch_order),
+                      totalStretch );
+  update_best_double( & CTX(bottleneck_stretch),
+                      CTX(best_bottleneck_stretch_order), maxEdgeStretch );
 #ifdef FAVORED
-  update_best( & favored_edge_crossings, best_favored_crossings_order, priorityEdgeCrossings );
+  update_best( & CTX(favored_edge_crossings),
+               CTX(best_favored_crossings_order), priorityEdgeCrossings );
 #endif
-  if ( pareto_objective == BOTTLENECK_TOTAL )
-    pareto_list = pareto_insert( maxEdgeCrossings(),
+  if ( OPTION(pareto_objective) == BOTTLENECK_TOTAL )
+    CTX(pareto_list) = pareto_insert( maxEdgeCrossings(),
                                  numberOfCrossings(),
-                                 iteration,
-                                 pareto_list );
-  else if ( pareto_objective == STRETCH_TOTAL )
-    pareto_list = pareto_insert( totalStretch(),
+                                 CTX(iteration),
+                                 CTX(pareto_list) );
+  else if ( OPTION(pareto_objective) == STRETCH_TOTAL )
+    CTX(pareto_list) = pareto_insert( totalStretch(),
                                  numberOfCrossings(),
-                                 iteration,
-                                 pareto_list );
-  else if ( pareto_objective == BOTTLENECK_STRETCH )
-    pareto_list = pareto_insert( maxEdgeCrossings(),
+                                 CTX(iteration),
+                                 CTX(pareto_list) );
+  else if ( OPTION(pareto_objective) == BOTTLENECK_STRETCH )
+    CTX(pareto_list) = pareto_insert( maxEdgeCrossings(),
                                  totalStretch(),
-                                 iteration,
-                                 pareto_list );
+                                 CTX(iteration),
+                                 CTX(pareto_list) );
 }
 
 bool has_improved_int( CROSSING_STATS_INT * stats )
@@ -319,7 +327,7 @@ bool has_improved_int( CROSSING_STATS_INT * stats )
   }
 #ifdef DEBUG
   printf( "<- has_improved, return %d, best = %d, previous = %d, iteration = %d\n",
-          improved, stats->best, stats->previous_best, iteration );
+          improved, stats->best, stats->previous_best, CTX(iteration) );
 #endif
   return improved;
 }
@@ -337,7 +345,7 @@ bool has_improved_double( CROSSING_STATS_DOUBLE * stats )
   }
 #ifdef DEBUG
   printf( "<- has_improved_double, return %d, best = %f, previous = %f, iteration = %d\n",
-          improved, stats->best, stats->previous_best, iteration );
+          improved, stats->best, stats->previous_best, CTX(iteration) );
 #endif
   return improved;
 }
@@ -346,9 +354,9 @@ static int total_layer_degree( int layer )
 {
   int total_degree = 0;
   int position = 0;
-  for( ; position < layers[ layer ]->number_of_nodes; position++ )
+  for( ; position < CTX(layers)[ layer ]->node_count; position++ )
     {
-      Nodeptr node = layers[ layer ]->nodes[ position ];
+      Nodeptr node = CTX(layers)[ layer ]->nodes[ position ];
       total_degree += DEGREE( node );
     }
   return total_degree;
@@ -357,9 +365,9 @@ static int total_layer_degree( int layer )
 static void add_layer_degrees( int layer, Statistics s )
 {
   int position = 0;
-  for( ; position < layers[ layer ]->number_of_nodes; position++ )
+  for( ; position < CTX(layers)[ layer ]->node_count; position++ )
     {
-      Nodeptr node = layers[ layer ]->nodes[ position ];
+      Nodeptr node = CTX(layers)[ layer ]->nodes[ position ];
       if ( DEGREE( node ) > 0 )
         add_data( s, DEGREE( node ) );
     }
@@ -367,8 +375,8 @@ static void add_layer_degrees( int layer, Statistics s )
 
 static void print_layer_degree_statistics( int layer, FILE * output_stream )
 {
-  int layer_size = layers[layer]->number_of_nodes;
-  Nodeptr * nodes = layers[ layer ]->nodes;
+  int layer_size = CTX(layers)[layer]->node_count;
+  Nodeptr * nodes = CTX(layers)[ layer ]->nodes;
   Statistics layer_degree = init_statistics( layer_size );
   int position = 0;
   for( ; position < layer_size; position++ )
@@ -386,13 +394,13 @@ static void print_layer_degree_statistics( int layer, FILE * output_stream )
 static void print_channel_degree_statistics( FILE * output_stream )
 {
   Statistics channel_degree_discrepancy
-    = init_statistics( number_of_layers - 1 );
-  for ( int layer = 1; layer < number_of_layers; layer++ )
+    = init_statistics( CTX(number_of_layers) - 1 );
+  for ( int layer = 1; layer < CTX(number_of_layers); layer++ )
     {
-      Layerptr upper_layer = layers[layer];
-      Layerptr lower_layer = layers[layer - 1];
-      int upper_layer_size = upper_layer->number_of_nodes;
-      int lower_layer_size = lower_layer->number_of_nodes;
+      Layerptr upper_layer = CTX(layers)[layer];
+      Layerptr lower_layer = CTX(layers)[layer - 1];
+      int upper_layer_size = upper_layer->node_count;
+      int lower_layer_size = lower_layer->node_count;
       Statistics channel_degree
         = init_statistics( upper_layer_size + lower_layer_size );
       for ( int i = 0; i < upper_layer_size; i++ )
@@ -421,9 +429,9 @@ static void print_channel_degree_statistics( FILE * output_stream )
 }
 
 static void print_channel_edge_counts( FILE * output_stream ) {
-  for ( int layer = 1; layer < number_of_layers; layer++ ) {
-    Layerptr upper_layer = layers[layer];
-    int upper_layer_size = upper_layer->number_of_nodes;
+  for ( int layer = 1; layer < CTX(number_of_layers); layer++ ) {
+    Layerptr upper_layer = CTX(layers)[layer];
+    int upper_layer_size = upper_layer->node_count;
     // count the number of edges into the channel from the upper layer (these
     // are the same as the edges from the lower layer into the channel)
     int edges_from_upper_layer = 0;
@@ -439,24 +447,25 @@ static void print_channel_edge_counts( FILE * output_stream ) {
 
 static void compute_degree_statistics( void )
 {
-  for( int layer = 0; layer < number_of_layers; layer++ )
+  for( int layer = 0; layer < CTX(number_of_layers); layer++ )
     {
-      for( int position = 0; position < layers[ layer ]->number_of_nodes; position++ )
+      for( int position = 0;
+           position < CTX(layers)[ layer ]->node_count; position++ )
         {
-          Nodeptr node = layers[ layer ]->nodes[ position ];
-          add_data( overall_degree, DEGREE( node ) );
+          Nodeptr node = CTX(layers)[ layer ]->nodes[ position ];
+          add_data( CTX(overall_degree), DEGREE( node ) );
         }
     }
 }
 
 static void print_degree_statistics( FILE * output_stream )
 {
-  Statistics nodes_per_layer = init_statistics( number_of_layers );
-  Statistics layer_degrees = init_statistics( number_of_layers );
-  for ( int i = 0; i < number_of_layers; i++ )
+  Statistics nodes_per_layer = init_statistics( CTX(number_of_layers) );
+  Statistics layer_degrees = init_statistics( CTX(number_of_layers) );
+  for ( int i = 0; i < CTX(number_of_layers); i++ )
     {
-      add_layer_degrees( i, overall_degree );
-      add_data( nodes_per_layer, layers[i]->number_of_nodes );
+      add_layer_degrees( i, CTX(overall_degree) );
+      add_data( nodes_per_layer, CTX(layers)[i]->node_count );
       add_data( layer_degrees, total_layer_degree( i ) );
       print_layer_degree_statistics( i, output_stream );
     }
@@ -464,7 +473,7 @@ static void print_degree_statistics( FILE * output_stream )
   print_statistics( layer_degrees, output_stream, "%7.2lf" );
   fprintf( output_stream, "\n" );
   fprintf( output_stream, "TDegree,%3d,", -1 );
-  print_statistics( overall_degree, output_stream, "%7.2lf" );
+  print_statistics( CTX(overall_degree), output_stream, "%7.2lf" );
   fprintf( output_stream, "\n" );
   fprintf( output_stream, "PerLayerNodes,%3d,", -1 );
   print_statistics( nodes_per_layer, output_stream, "%7.2lf" );
@@ -484,29 +493,38 @@ static void print_degree_statistics( FILE * output_stream )
 
 void print_graph_statistics( FILE * output_stream )
 {
-  int effective_number_of_nodes = number_of_nodes - number_of_isolated_nodes;
-  fprintf( output_stream, "GraphName,%s\n", graph_name );
-  fprintf( output_stream, "NumberOfLayers,%d\n", number_of_layers );
-  fprintf( output_stream, "NumberOfNodes,%d\n", number_of_nodes );
-  fprintf( output_stream, "IsolatedNodes,%d\n", number_of_isolated_nodes );
+  int effective_number_of_nodes
+    = CTX(number_of_nodes) - CTX(number_of_isolated_nodes);
+  fprintf( output_stream, "GraphName,%s\n", CTX(graph_name) );
+  fprintf( output_stream, "NumberOfLayers,%d\n", CTX(number_of_layers) );
+  fprintf( output_stream, "NumberOfNodes,%d\n", CTX(number_of_nodes) );
+  fprintf( output_stream, "IsolatedNodes,%d\n", CTX(number_of_isolated_nodes) );
   fprintf( output_stream, "EffectiveNodes,%d\n", effective_number_of_nodes );
-  fprintf( output_stream, "NumberOfEdges,%d\n", number_of_edges );
+  fprintf( output_stream, "NumberOfEdges,%d\n", CTX(number_of_edges) );
   fprintf( output_stream, "EdgeDensity,%2.2f\n",
-          (double) number_of_edges / effective_number_of_nodes );
-  overall_degree = init_statistics( number_of_nodes );
-  if ( verbose )
+          (double) CTX(number_of_edges) / effective_number_of_nodes );
+  CTX(overall_degree) = init_statistics( CTX(number_of_nodes) );
+  if ( OPTION(verbose) )
     {
       print_degree_statistics( output_stream );
       print_channel_degree_statistics( output_stream );
       print_channel_edge_counts( output_stream );
+      fprintf( output_stream, "NameLookups,%ld\n", getNumberOfHashAccesses() );
+      fprintf( output_stream, "AverageProbes,%2.2f\n",
+               getAverageNumberOfProbes() );
+      fprintf( output_stream, "FalseMatches,%ld\n", getNumberOfFalseMatches() );
     }
   else
     compute_degree_statistics();
-  fprintf( output_stream, "MinDegree,%d\n", (int) get_min( overall_degree ) );
-  fprintf( output_stream, "MaxDegree,%d\n", (int) get_max( overall_degree ) );
-  fprintf( output_stream, "MeanDegree,%2.2f\n", get_mean( overall_degree ) );
-  fprintf( output_stream, "MedianDegree,%2.1f\n", get_median( overall_degree ) );
-  free_statistics( overall_degree );
+  fprintf( output_stream, "MinDegree,%d\n",
+           (int) get_min( CTX(overall_degree) ) );
+  fprintf( output_stream, "MaxDegree,%d\n",
+           (int) get_max( CTX(overall_degree) ) );
+  fprintf( output_stream, "MeanDegree,%2.2f\n",
+           get_mean( CTX(overall_degree) ) );
+  fprintf( output_stream, "MedianDegree,%2.1f\n",
+           get_median( CTX(overall_degree) ) );
+  free_statistics( CTX(overall_degree) );
 }
 
 static void print_crossing_stats_int(FILE * output_stream,
@@ -516,7 +534,7 @@ static void print_crossing_stats_int(FILE * output_stream,
   fprintf( output_stream, "Heuristic%s,%d,iteration,%d\n",
            stats.name, stats.after_heuristic, stats.best_heuristic_iteration );
   fprintf( output_stream, "Final%s,%d,iteration,%d\n",
-           stats.name, stats.after_post_processing, stats.post_processing_iteration );
+           stats.name, stats.after_post_processing, stats.best_post_processing_iteration );
 }
 
 static void print_crossing_stats_double(FILE * output_stream,
@@ -526,28 +544,28 @@ static void print_crossing_stats_double(FILE * output_stream,
   fprintf( output_stream, "Heuristic%s,%f,iteration,%d\n",
            stats.name, stats.after_heuristic, stats.best_heuristic_iteration );
   fprintf( output_stream, "Final%s,%f,iteration,%d\n",
-           stats.name, stats.after_post_processing, stats.post_processing_iteration );
+           stats.name, stats.after_post_processing, stats.best_post_processing_iteration );
 }
 
 void print_run_statistics( FILE * output_stream )
 {
-  fprintf( output_stream, "Preprocessor,%s\n", preprocessor );
-  fprintf( output_stream, "Heuristic,%s\n", heuristic );
-  fprintf( output_stream, "Iterations,%d\n", iteration );
+  fprintf( output_stream, "Preprocessor,%s\n", OPTION(preprocessor) );
+  fprintf( output_stream, "Heuristic,%s\n", OPTION(heuristic) );
+  fprintf( output_stream, "Iterations,%d\n", CTX(iteration) );
   fprintf( output_stream, "Runtime,%2.3f\n", RUNTIME );
 
-  print_crossing_stats_int( output_stream, total_crossings );
-  print_crossing_stats_int( output_stream, max_edge_crossings );
-  print_crossing_stats_double( output_stream, total_stretch );
-  print_crossing_stats_double( output_stream, bottleneck_stretch );
+  print_crossing_stats_int( output_stream, CTX(total_crossings) );
+  print_crossing_stats_int( output_stream, CTX(max_edge_crossings) );
+  print_crossing_stats_double( output_stream, CTX(total_stretch) );
+  print_crossing_stats_double( output_stream, CTX(bottleneck_stretch) );
 #ifdef FAVORED
-  print_crossing_stats_int( output_stream, favored_edge_crossings );
+  print_crossing_stats_int( output_stream, CTX(favored_edge_crossings) );
 #endif
-  if ( pareto_objective != NO_PARETO ) {
+  if ( OPTION(pareto_objective) != NO_PARETO ) {
     fprintf( output_stream, "Pareto,");
-    print_pareto_list( pareto_list, output_stream );
+    print_pareto_list( CTX(pareto_list), output_stream );
     fprintf( output_stream, "\n" );
   }
 }
 
-/*  [Last modified: 2016 05 20 at 21:28:41 GMT] */
+/*  [Last modified: 2026 10 16 at 16:51:03 GMT] */
@@ -15,41 +15,27 @@
 
 #include"order.h"
 
-typedef struct crossing_stats_int {
-  int at_beginning;
-  int after_preprocessing;
-  int after_heuristic;
-  int after_post_processing;
-  int best;
-  int previous_best;
-  int best_heuristic_iteration;
-  int post_processing_iteration;
-  const char * name; 
-} CROSSING_STATS_INT;
-
-typedef struct crossing_stats_double {
-  double at_beginning;
-  double after_preprocessing;
-  double after_heuristic;
-  double after_post_processing;
-  double best;
-  double previous_best;
-  int best_heuristic_iteration;
-  int post_processing_iteration;
-  const char * name; 
-} CROSSING_STATS_DOUBLE;
-
-extern CROSSING_STATS_INT total_crossings;
-extern CROSSING_STATS_INT max_edge_crossings;
-extern CROSSING_STATS_INT favored_edge_crossings;
-extern CROSSING_STATS_DOUBLE total_stretch;
-extern CROSSING_STATS_DOUBLE bottleneck_stretch;
+/**
+ * CROSSING_STATS_INT and CROSSING_STATS_DOUBLE are defined in context.h;
+ * the following are part of the run context
+ *
+ *   CROSSING_STATS_INT total_crossings;
+ *   CROSSING_STATS_INT max_edge_crossings;
+ *   CROSSING_STATS_INT favored_edge_crossings;
+ *   CROSSING_STATS_DOUBLE total_stretch;
+ *   CROSSING_STATS_DOUBLE bottleneck_stretch;
+ */
 
 /**
  * Initializes crossing stats structures
  */
 void init_crossing_stats( void );
 
+/**
+ * Deallocates the list of Pareto optima, if any
+ */
+void cleanup_crossing_stats( void );
+
 /**
  * Saves statistics about crossings before run for later printing
  */
@@ -128,4 +114,4 @@ void print_run_statistics( FILE * output_stream );
 
 #endif
 
-/*  [Last modified: 2016 05 18 at 19:59:14 GMT] */
+/*  [Last modified: 2026 10 16 at 16:51:03 GMT] */
@@ -16,14 +16,12 @@ double stretch(Edgeptr e) {
   Nodeptr v = e->down_node;
   Nodeptr w = e->up_node;
 #ifdef DEBUG
-  printf("-> stretch, %s, %s\n", v->name, w->name);
+  printf("-> stretch, %s, %s\n", NODE_NAME( v ), NODE_NAME( w ));
 #endif
   int v_layer = v->layer; 
   int w_layer = w->layer;
-  int v_layer_size = layers[v_layer]->number_of_nodes;
-  int w_layer_size = layers[w_layer]->number_of_nodes;
-  double v_scale = v_layer_size > 1 ? v_layer_size - 1.0 : 2.0;
-  double w_scale = w_layer_size > 1 ? w_layer_size - 1.0 : 2.0;
+  double v_scale = layerScale(v_layer);
+  double w_scale = layerScale(w_layer);
   double stretch = fabs( v->position / v_scale - w->position / w_scale );
 #ifdef DEBUG
   printf("<- stretch, v: scale, position = %f, %d; w: scale, position = %f, %d;"
@@ -33,4 +31,9 @@ double stretch(Edgeptr e) {
   return stretch;
 }
 
-/*  [Last modified: 2016 05 20 at 21:20:44 GMT] */
+long layerScale(int layer) {
+  int layer_size = CTX(layers)[layer]->node_count;
+  return layer_size > 1 ? layer_size - 1 : 2;
+}
+
+/*  [Last modified: 2026 10 16 at 16:03:56 GMT] */
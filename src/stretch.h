@@ -11,4 +11,10 @@
  */
 double stretch(Edgeptr e);
 
+/**
+ * @return the denominator used for positions on the given layer when
+ * computing stretch, as an integer: |L|-1, or 2 if there is only one node
+ */
+long layerScale(int layer);
+
 /*  [Last modified: 2016 02 15 at 17:00:24 GMT] */
@@ -18,7 +18,11 @@
 
 /**
  * @return the number of crossings among the edges of node_a and node_b if
- * node_a is to the left of node_b
+ * node_a is to the left of node_b; if cache_pair_crossings is set, the
+ * number comes from pairCrossings() in channel.c, otherwise it is computed
+ * by pair_crossings() in crossing_utilities.c; either way there is no side
+ * effect on the crossings of edges or nodes, so the two give the same
+ * results.
  */
 int node_crossings( Nodeptr node_a, Nodeptr node_b );
 
@@ -46,4 +50,4 @@ int edge_crossings_after_swap( Nodeptr left_node, Nodeptr right_node );
 
 #endif
 
-/*  [Last modified: 2011 05 22 at 17:45:36 GMT] */
+/*  [Last modified: 2026 10 16 at 17:34:33 GMT] */
@@ -9,6 +9,9 @@
 
 /* Propagate changes back to the C-Utilities repository. */
 
+// RUSAGE_THREAD is Linux-specific
+#define _GNU_SOURCE
+
 #include "timing.h"
 #include <sys/time.h>
 #include <sys/resource.h>
@@ -31,4 +34,15 @@ double getUserSeconds() {
            (double) ru.ru_utime.tv_usec / 1000000.0 );
 }
 
-/*  [Last modified: 2011 06 26 at 22:15:46 GMT] */
+double getThreadUserSeconds() {
+  struct rusage ru;
+#ifdef RUSAGE_THREAD
+  getrusage( RUSAGE_THREAD, &ru );
+#else
+  getrusage( RUSAGE_SELF, &ru );
+#endif
+  return ( ru.ru_utime.tv_sec + 
+           (double) ru.ru_utime.tv_usec / 1000000.0 );
+}
+
+/*  [Last modified: 2026 10 16 at 16:51:03 GMT] */
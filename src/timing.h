@@ -28,6 +28,12 @@ double currentCPUTime();
  */
 double getUserSeconds();
 
+/**
+ *   Return user time used by the calling thread in # of seconds; same as
+ *   getUserSeconds() on systems that do not keep track of time per thread
+ */
+double getThreadUserSeconds();
+
 #endif /* ! defined(TIMING_H) */
 
-/*  [Last modified: 2009 12 01 at 19:17:38 GMT] */
+/*  [Last modified: 2026 10 16 at 16:51:03 GMT] */